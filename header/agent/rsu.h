@@ -20,6 +20,7 @@ public:
 private:
     std::vector<Ethernet::MAC_KEY> _mac_key_vector;
     PeriodicThread* _running_thread;
+    __u64 _beacon_interval;
     EthernetCommunicator* _communicator;
     unsigned short _quadrant;
 };
@@ -0,0 +1,45 @@
+#ifndef SIMULATED_VEHICLE_H
+#define SIMULATED_VEHICLE_H
+
+#include "../traits.h"
+#include "../autonomous_agent.h"
+#include "../period_thread.h"
+
+// Vehicle traffic for the discrete-event simulation: broadcasts a status
+// message every STATUS_PERIOD_US and moves to a random quadrant every
+// QUADRANT_DWELL_US. Messages from other vehicles are consumed as they are
+// delivered, on the simulation thread, instead of by a receive thread.
+class SimulatedVehicle: public AutonomousAgent
+{
+public:
+    SimulatedVehicle(int id, EthernetNIC* nic, EthernetProtocol* protocol);
+    ~SimulatedVehicle();
+
+    void start() override;
+    void stop() override;
+
+    unsigned long sent() const { return _sent; }
+    unsigned long received() const { return _listener.received; }
+
+private:
+    class Listener: public EthernetProtocol::Observer {
+    public:
+        Listener(EthernetProtocol* protocol) : received(0), _protocol(protocol) {}
+        void update(EthernetProtocol::Port port, unsigned int id, EthernetProtocol::NICBuffer* buf) override;
+
+        unsigned long received;
+    private:
+        EthernetProtocol* _protocol;
+    };
+
+    void send_status();
+    void move();
+
+    Listener _listener;
+    PeriodicThread* _status_thread;
+    PeriodicThread* _move_thread;
+    unsigned int _dwells;
+    unsigned long _sent;
+};
+
+#endif // SIMULATED_VEHICLE_H
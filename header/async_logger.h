@@ -0,0 +1,273 @@
+#ifndef ASYNC_LOGGER_H
+#define ASYNC_LOGGER_H
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+#include <unistd.h>
+
+#include "traits.h"
+#include "u64_type.h"
+
+// Binary logger for hot paths.
+// Call sites only copy a format id and the raw arguments into a per-thread
+// SPSC ring; a background thread drains the rings into logs/process_<pid>.blog.
+// Formatting happens offline (bin/log_decoder). Placeholders are "{}".
+class AsyncLogger
+{
+public:
+    enum Level {
+        TRACE,
+        DEBUG,
+        INFO,
+        WARNING,
+        ERROR
+    };
+
+    enum ArgType {
+        INT,
+        UINT,
+        DOUBLE,
+        STRING
+    };
+
+    static const size_t RECORD_SIZE = 128;
+    static const size_t RECORD_HEADER_SIZE = 16;
+    static const size_t MAX_ARGS_SIZE = RECORD_SIZE - RECORD_HEADER_SIZE;
+
+    struct Record {
+        uint16_t format;
+        uint8_t argc;
+        uint8_t size;
+        uint32_t thread;
+        U64 timestamp;
+        unsigned char args[MAX_ARGS_SIZE];
+    } __attribute__((packed));
+
+    struct Format {
+        Level level;
+        const char* file;
+        int line;
+        const char* text;
+    };
+
+    // File layout: MAGIC, pid (u32), then tagged entries
+    static const char MAGIC[8];
+    static const unsigned char FORMAT_ENTRY = 'F';
+    static const unsigned char RECORD_ENTRY = 'R';
+    static const unsigned char DROPPED_ENTRY = 'D';
+
+    static constexpr bool enabled(Level level) {
+        return level >= Traits<AsyncLogger>::LEVEL;
+    }
+
+    static void init();
+    static void close();
+
+    static unsigned short format(Level level, const char* file, int line, const char* text);
+
+    template<typename... Args>
+    static void write(unsigned short format, const Args&... args) {
+        Ring* ring = thread_ring();
+        if (!ring) return;
+
+        Record* record = ring->reserve();
+        if (!record) {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        record->format = format;
+        record->argc = 0;
+        record->size = 0;
+        record->thread = _handle.thread;
+        record->timestamp = timestamp();
+        encode_all(record, args...);
+
+        ring->commit();
+    }
+
+    static unsigned long dropped() {
+        return _dropped.load(std::memory_order_relaxed);
+    }
+
+    static const char* level_name(Level level);
+    static std::string render(const char* text, const unsigned char* args, unsigned int argc, unsigned int size);
+
+private:
+    // Single producer (owning thread), single consumer (drain thread)
+    class Ring
+    {
+    public:
+        static const unsigned int SLOTS = Traits<AsyncLogger>::RING_SLOTS;
+        static_assert((SLOTS & (SLOTS - 1)) == 0, "RING_SLOTS must be a power of two");
+
+        Ring() : _head(0), _tail(0), _retired(false) {}
+
+        Record* reserve() {
+            unsigned int head = _head.load(std::memory_order_relaxed);
+            if (head - _tail.load(std::memory_order_acquire) == SLOTS) {
+                return nullptr;
+            }
+            return &_records[head & (SLOTS - 1)];
+        }
+
+        void commit() {
+            _head.store(_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        const Record* front() {
+            unsigned int tail = _tail.load(std::memory_order_relaxed);
+            if (tail == _head.load(std::memory_order_acquire)) {
+                return nullptr;
+            }
+            return &_records[tail & (SLOTS - 1)];
+        }
+
+        void pop() {
+            _tail.store(_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        void retire() { _retired.store(true, std::memory_order_release); }
+        bool retired() { return _retired.load(std::memory_order_acquire); }
+
+    private:
+        // Producer and consumer indexes kept a cache line apart
+        std::atomic<unsigned int> _head;
+        char _head_padding[64 - sizeof(std::atomic<unsigned int>)];
+        std::atomic<unsigned int> _tail;
+        char _tail_padding[64 - sizeof(std::atomic<unsigned int>)];
+        std::atomic<bool> _retired;
+        Record _records[SLOTS];
+    };
+
+    // Per-thread binding to its ring, invalidated by fork through the generation
+    struct Handle {
+        Ring* ring;
+        uint32_t thread;
+        unsigned int generation;
+
+        Handle() : ring(nullptr), thread(0), generation(0) {}
+        ~Handle() { if (ring && generation == _generation) ring->retire(); }
+    };
+
+    static Ring* thread_ring() {
+        if (_handle.ring && _handle.generation == _generation) {
+            return _handle.ring;
+        }
+        return attach();
+    }
+
+    static Ring* attach();
+    static void start();
+    static void drain();
+    static size_t drain_once();
+    static void flush(std::vector<unsigned char>& out);
+    static U64 timestamp();
+
+    static void prepare_fork();
+    static void parent_after_fork();
+    static void child_after_fork();
+
+    // Argument encoding: one type tag byte followed by the raw value
+    static bool put(Record* record, const void* data, size_t size) {
+        if (record->size + size > MAX_ARGS_SIZE) return false;
+        memcpy(record->args + record->size, data, size);
+        record->size += size;
+        return true;
+    }
+
+    static void encode_tagged(Record* record, ArgType type, const void* data, size_t size) {
+        unsigned char tag = type;
+        if (record->size + 1 + size > MAX_ARGS_SIZE) return;
+        put(record, &tag, 1);
+        put(record, data, size);
+        record->argc++;
+    }
+
+    template<typename T>
+    static typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type
+    encode(Record* record, const T& value) {
+        int64_t v = value;
+        encode_tagged(record, INT, &v, sizeof(v));
+    }
+
+    template<typename T>
+    static typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value>::type
+    encode(Record* record, const T& value) {
+        uint64_t v = value;
+        encode_tagged(record, UINT, &v, sizeof(v));
+    }
+
+    template<typename T>
+    static typename std::enable_if<std::is_enum<T>::value>::type
+    encode(Record* record, const T& value) {
+        int64_t v = static_cast<int64_t>(value);
+        encode_tagged(record, INT, &v, sizeof(v));
+    }
+
+    template<typename T>
+    static typename std::enable_if<std::is_floating_point<T>::value>::type
+    encode(Record* record, const T& value) {
+        double v = value;
+        encode_tagged(record, DOUBLE, &v, sizeof(v));
+    }
+
+    static void encode(Record* record, const char* value) {
+        if (!value) value = "(null)";
+        encode_string(record, value, strlen(value));
+    }
+
+    static void encode(Record* record, const std::string& value) {
+        encode_string(record, value.data(), value.size());
+    }
+
+    static void encode_string(Record* record, const char* value, size_t length) {
+        if (record->size + 2u > MAX_ARGS_SIZE) return;
+        size_t room = MAX_ARGS_SIZE - record->size - 2;
+        unsigned char len = static_cast<unsigned char>(length < room ? length : room);
+        unsigned char tag = STRING;
+        put(record, &tag, 1);
+        put(record, &len, 1);
+        put(record, value, len);
+        record->argc++;
+    }
+
+    static void encode_all(Record*) {}
+
+    template<typename T, typename... Args>
+    static void encode_all(Record* record, const T& first, const Args&... rest) {
+        encode(record, first);
+        encode_all(record, rest...);
+    }
+
+private:
+    static std::mutex _mutex;
+    static std::vector<Ring*> _rings;
+    static std::vector<Format> _formats;
+    static size_t _written_formats;
+    static std::atomic<unsigned long> _dropped;
+    static unsigned long _written_dropped;
+    static std::atomic<bool> _running;
+    static bool _closed;
+    static unsigned int _generation;
+    static int _fd;
+    static std::thread _thread;
+    static thread_local Handle _handle;
+};
+
+// Disabled levels compile to nothing: the arguments are never evaluated
+#define ASYNC_LOG(level, fmt, ...)                                                                  \
+    do {                                                                                            \
+        if (AsyncLogger::enabled(level)) {                                                          \
+            static const unsigned short _async_log_format = AsyncLogger::format(level, __FILE__, __LINE__, fmt); \
+            AsyncLogger::write(_async_log_format, ##__VA_ARGS__);                                   \
+        }                                                                                           \
+    } while (0)
+
+#endif // ASYNC_LOGGER_H
@@ -20,6 +20,7 @@ public:
     virtual void stop() = 0;
 
     EthernetNIC* nic() const;
+    EthernetProtocol* protocol() const;
 
 protected:
     int _id;
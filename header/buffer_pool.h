@@ -2,6 +2,7 @@
 #define BUFFER_POOL_H
 
 #include <cstddef>
+#include <mutex>
 
 #include "semaphore.h"
 #include "buffer.h"
@@ -30,20 +31,15 @@ public:
     BufferType* alloc() {
         //ConsoleLogger::log("Buffer Pool: Requesting Buffer - Semaphore P -> " + std::to_string(_free_buffers.count()));
         _free_buffers.p();
-        
-        {
-            std::lock_guard<std::mutex> lock(_mutex);
-        
-            for (size_t i = 0; i < SIZE; i++) {
-                if (!_in_use[i]) {
-                    _in_use[i] = true;
-                    _buffers[i]->set_reference_counter(1);
-                    return _buffers[i];
-                }
-            }
+        return take();
+    }
+
+    // Non-blocking alloc(): nullptr if every buffer is in use
+    BufferType* try_alloc() {
+        if (!_free_buffers.try_p()) {
+            return nullptr;
         }
-        
-        return nullptr; // Should never reach here
+        return take();
     }
     
     void free(BufferType* buf) {
@@ -78,6 +74,21 @@ public:
     }
 
 private:
+    // Claims a free buffer; the caller already holds one count of _free_buffers
+    BufferType* take() {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        for (size_t i = 0; i < SIZE; i++) {
+            if (!_in_use[i]) {
+                _in_use[i] = true;
+                _buffers[i]->set_reference_counter(1);
+                return _buffers[i];
+            }
+        }
+
+        return nullptr; // Should never reach here
+    }
+
     BufferType* _buffers[SIZE];
     bool _in_use[SIZE];
     
@@ -0,0 +1,55 @@
+#ifndef CHANNEL_MODEL_H
+#define CHANNEL_MODEL_H
+
+#include "traits.h"
+#include "u64_type.h"
+
+// Radio channel of each quadrant for the simulated MemoryBus. A quadrant is
+// one shared medium: a frame occupies it for size / bandwidth, queued behind
+// the frames already on air, and then reaches each receiver after the
+// propagation latency plus a uniform jitter, unless it is lost (independently
+// per receiver). Random draws come from the Simulator, so runs are reproducible.
+class ChannelModel
+{
+public:
+    static const unsigned int QUADRANTS = Traits<ChannelModel>::NUM_RSU;
+
+    struct Link {
+        unsigned int latency_us;
+        unsigned int jitter_us;
+        unsigned int loss_ppm;
+        unsigned long long bandwidth_bps;   // 0: no serialization delay
+    };
+
+    struct Statistics {
+        unsigned long frames;
+        unsigned long deliveries;
+        unsigned long lost;
+        U64 queued_us;                      // Total wait for the medium
+    };
+
+    // Every quadrant starts with the Traits<ChannelModel> link
+    ChannelModel();
+
+    // Quadrant 0 is the link for frames with no quadrant set
+    void set_link(unsigned int quadrant, const Link& link);
+    const Link& link(unsigned int quadrant) const;
+
+    // The frame goes on air in `quadrant` at `now`; returns when it is off air
+    U64 transmit(unsigned int quadrant, unsigned int bytes, U64 now);
+    // Arrival at one receiver of a frame off air at `sent`; false if lost
+    bool arrival(unsigned int quadrant, U64 sent, U64& at);
+
+    Statistics statistics(unsigned int quadrant) const;
+    // Idle media and zero statistics; the links are kept
+    void reset();
+
+private:
+    unsigned int index(unsigned int quadrant) const;
+
+    Link _links[QUADRANTS + 1];
+    U64 _busy_until[QUADRANTS + 1];
+    Statistics _statistics[QUADRANTS + 1];
+};
+
+#endif // CHANNEL_MODEL_H
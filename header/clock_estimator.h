@@ -0,0 +1,72 @@
+#ifndef CLOCK_ESTIMATOR_H
+#define CLOCK_ESTIMATOR_H
+
+#include "traits.h"
+#include "u64_type.h"
+
+// Offset and skew of the RSU clock relative to the local clock.
+// Keeps the last WINDOW (local time, system - local) samples and fits
+// offset(t) = offset + skew * (t - reference) by least squares. A sample
+// further from the fit than OUTLIER_SIGMAS robust deviations (1.4826 * MAD
+// of the residuals, never below OUTLIER_FLOOR_US) is rejected; a run of
+// WINDOW / 2 rejections means the clock stepped, so the window restarts.
+// The slope is clamped to MAX_SKEW_PPM, so jitter in a short window cannot
+// fake a steep drift. Samples are one-way, so the fitted offset includes
+// the mean path delay.
+// Not thread-safe: TimeKeeper serializes access.
+class ClockEstimator
+{
+public:
+    static const unsigned int WINDOW = Traits<TimeKeeper>::SYNC_WINDOW;
+    static const unsigned int MIN_SAMPLES = Traits<TimeKeeper>::SYNC_MIN_SAMPLES;
+
+    struct Quality {
+        unsigned int samples;       // In the window
+        unsigned long accepted;
+        unsigned long rejected;     // Outliers since start
+        double offset_us;           // Predicted system - local at the query time
+        double skew_ppm;
+        double jitter_us;           // Robust deviation of the residuals
+        double error_us;            // Bound on the offset error at the query time (3 sigma)
+        U64 age_us;                 // Since the last accepted sample
+    };
+
+    ClockEstimator();
+
+    // False if the sample was rejected as an outlier
+    bool add(U64 system_timestamp, U64 local_timestamp);
+    void reset();
+
+    bool fitted() const { return _count > 0; }
+    double offset_at(U64 local_timestamp) const;
+    Quality quality(U64 local_timestamp) const;
+
+private:
+    struct Sample {
+        U64 local;
+        double offset;
+    };
+
+    void fit();
+    double error_at(U64 local_timestamp) const;
+
+    Sample _samples[WINDOW];
+    unsigned int _head;
+    unsigned int _count;
+
+    // Fitted line, times relative to _reference
+    U64 _reference;
+    double _offset;
+    double _skew;
+    double _mean_time;
+    double _sxx;
+    double _sigma;
+    double _jitter;
+
+    U64 _last_update;
+    unsigned long _accepted;
+    unsigned long _rejected;
+    unsigned int _consecutive_rejects;
+};
+
+#endif // CLOCK_ESTIMATOR_H
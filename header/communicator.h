@@ -24,7 +24,7 @@ public:
 
     ~Communicator() { 
         stop();
-        Channel::detach(this, _address.port()); 
+        _channel->detach(this, _address.port()); 
     }
     
     bool send(const Message * message, Address from, Address to) {
@@ -9,6 +9,7 @@
 #include <chrono>
 
 #include "console_logger.h"
+#include "async_logger.h"
 #include "queue.h"
 #include "semaphore.h"
 #include "type_definitions.h"
@@ -52,7 +53,8 @@ protected:
     PeriodicThread* _running_thread;
     Semaphore _semaphore;
 
-    Queue<Message, 16> _receive_queue;
+    // Filled by the receive thread only, drained by one consumer
+    SPSCQueue<Message, 16> _receive_queue;
     ComponentDataType _data_type;
     std::vector<InterestData> _interests;
 
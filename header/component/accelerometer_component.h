@@ -4,11 +4,10 @@
 #include <random>
 
 #include "../component.h"
-#include "../csv.hpp"
+#include "../dataset.h"
+#include "../dataset_cursor.h"
 #include "../u64_type.h"
 
-using namespace csv;
-
 class AccelerometerComponent : public Component {
 public:
     AccelerometerComponent(AutonomousAgent* autonomous_agent, const unsigned short& id, int dataset_id);
@@ -25,8 +24,11 @@ private:
     U64 _initial_time;
     U64 _local_initial_time;
 
-    CSVReader* _reader;
-    CSVRow _row;
+    // Shared by DatasetService, or _own when the parent loaded none
+    const Dataset* _dataset;
+    Dataset _own;
+    DatasetCursor _cursor;
+    int _acceleration;
 };
 
 #endif // ACCELEROMETER_COMPONENT_H
\ No newline at end of file
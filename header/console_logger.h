@@ -13,7 +13,10 @@
 #include <sys/file.h>
 #include <sys/stat.h>
 #include <sys/resource.h>
+#include <cstring>
 
+#include "traits.h"
+#include "async_logger.h"
 
 class ConsoleLogger {
 public:
@@ -27,8 +30,56 @@ public:
     static void close();
     static std::string get_current_timestamp();
     static void log(const std::string& message);
+    static void log(AsyncLogger::Level level, const std::string& message);
     static void print(const std::string& message);
     static void error(const std::string& message);
+
+    static constexpr bool enabled(AsyncLogger::Level level) {
+        return level >= Traits<ConsoleLogger>::LEVEL;
+    }
+
+    // Replaces each "{}" in text with the next argument
+    template<typename... Args>
+    static std::string format(const char* text, const Args&... args) {
+        std::stringstream ss;
+        format_args(ss, text, args...);
+        return ss.str();
+    }
+
+private:
+    static void format_args(std::stringstream& ss, const char* text) {
+        ss << text;
+    }
+
+    template<typename T, typename... Args>
+    static void format_args(std::stringstream& ss, const char* text, const T& value, const Args&... rest) {
+        const char* placeholder = strstr(text, "{}");
+        if (!placeholder) {
+            ss << text;
+            return;
+        }
+        ss.write(text, placeholder - text);
+        ss << value;
+        format_args(ss, placeholder + 2, rest...);
+    }
 };
 
+// Leveled logging: levels below Traits<ConsoleLogger>::LEVEL compile to nothing and
+// enabled ones are either recorded in binary (ASYNC) or formatted only at this point.
+#define CONSOLE_LOG(level, fmt, ...)                                                \
+    do {                                                                            \
+        if (ConsoleLogger::enabled(level)) {                                        \
+            if (Traits<ConsoleLogger>::ASYNC)                                       \
+                ASYNC_LOG(level, fmt, ##__VA_ARGS__);                               \
+            else                                                                    \
+                ConsoleLogger::log(level, ConsoleLogger::format(fmt, ##__VA_ARGS__)); \
+        }                                                                           \
+    } while (0)
+
+#define LOG_TRACE(fmt, ...) CONSOLE_LOG(AsyncLogger::TRACE, fmt, ##__VA_ARGS__)
+#define LOG_DEBUG(fmt, ...) CONSOLE_LOG(AsyncLogger::DEBUG, fmt, ##__VA_ARGS__)
+#define LOG_INFO(fmt, ...) CONSOLE_LOG(AsyncLogger::INFO, fmt, ##__VA_ARGS__)
+#define LOG_WARNING(fmt, ...) CONSOLE_LOG(AsyncLogger::WARNING, fmt, ##__VA_ARGS__)
+#define LOG_ERROR(fmt, ...) CONSOLE_LOG(AsyncLogger::ERROR, fmt, ##__VA_ARGS__)
+
 #endif // CONSOLE_LOGGER_H
\ No newline at end of file
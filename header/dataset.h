@@ -0,0 +1,91 @@
+#ifndef DATASET_H
+#define DATASET_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "u64_type.h"
+
+// Columnar binary form of the vehicle CSV datasets (bin/dataset_converter).
+// The file is a Header, one Descriptor per column, then each column as a
+// fixed-width array of `rows` 8-byte values starting on a cache line.
+// "timestamp" is always column 0. open() maps the file read-only, so loading
+// costs one mmap and components read a column by pointer and row index.
+class Dataset
+{
+public:
+    enum Type {
+        INTEGER,    // U64: timestamp, id
+        REAL        // double; NaN where the CSV field was empty
+    };
+
+    static const char MAGIC[8];
+    static const uint32_t VERSION = 1;
+    static const unsigned int NAME_SIZE = 24;
+    static const unsigned int ALIGNMENT = 64;
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t columns;
+        uint64_t rows;
+        U64 first_timestamp;
+        U64 last_timestamp;
+    };
+
+    struct Descriptor {
+        char name[NAME_SIZE];
+        uint32_t type;
+        uint32_t reserved;
+        uint64_t offset;    // From the start of the file
+    };
+
+    Dataset();
+    ~Dataset();
+
+    Dataset(const Dataset&) = delete;
+    Dataset& operator=(const Dataset&) = delete;
+
+    // Maps a converted file; false (and logged) if missing or malformed
+    bool open(const std::string& path);
+    // Reads a dataset already in memory (e.g. DatasetService); not copied,
+    // so it must outlive this object
+    bool view(const void* data, size_t size);
+    void close();
+    bool is_open() const { return _header != nullptr; }
+
+    uint64_t rows() const { return _header ? _header->rows : 0; }
+    unsigned int columns() const { return _header ? _header->columns : 0; }
+    U64 first_timestamp() const { return _header ? _header->first_timestamp : 0; }
+    U64 last_timestamp() const { return _header ? _header->last_timestamp : 0; }
+
+    // Column index by name, -1 if absent
+    int column(const std::string& name) const;
+    std::string name(unsigned int column) const;
+    Type type(unsigned int column) const;
+
+    // nullptr if the column does not exist or has the other type
+    const U64* integers(unsigned int column) const;
+    const double* reals(unsigned int column) const;
+    const U64* timestamps() const { return integers(0); }
+
+    // The binary form of a dataset CSV, in memory
+    static bool encode(const std::string& csv_path, std::vector<char>& binary);
+    // Writes `binary_path` from a dataset CSV (written aside, then renamed)
+    static bool convert(const std::string& csv_path, const std::string& binary_path);
+    // <directory>/perception-vehicle_<id><extension>
+    static std::string path(int dataset_id, const std::string& directory = "dataset", const std::string& extension = ".bin");
+
+private:
+    bool validate(const void* data, size_t size, const std::string& source);
+    const void* column_data(unsigned int column, Type type) const;
+
+    bool _mapped;
+    void* _map;
+    size_t _size;
+    const Header* _header;
+    const Descriptor* _descriptors;
+};
+
+#endif // DATASET_H
@@ -0,0 +1,70 @@
+#ifndef DATASET_CURSOR_H
+#define DATASET_CURSOR_H
+
+#include <cstdint>
+
+#include "traits.h"
+#include "dataset.h"
+#include "u64_type.h"
+
+// Samples a Dataset at arbitrary timestamps. seek() gallops from the last
+// row found (1, 2, 4, ... rows) and then binary searches the bracket, so a
+// sensor sampling forward in time costs O(1) amortized, whatever its period.
+// Values are held or linearly interpolated between the two rows around the
+// timestamp; across a recording gap longer than MAX_GAP_US the earlier row is
+// held. Before the first row and after the last, the end rows are held.
+class DatasetCursor
+{
+public:
+    enum Interpolation {
+        HOLD,       // Latest row at or before the timestamp
+        LINEAR
+    };
+
+    static const U64 MAX_GAP_US = Traits<DatasetCursor>::MAX_GAP_US;
+
+    // Vehicle state fields, in the order kinematics() fills them
+    struct Kinematics {
+        double x;
+        double y;
+        double speed;
+        double heading;     // rad; interpolated along the shorter arc
+        double yawrate;
+        double acceleration;
+    };
+
+    explicit DatasetCursor(const Dataset* dataset = nullptr, Interpolation interpolation = LINEAR);
+
+    // Rebinds to another dataset and rewinds
+    void reset(const Dataset* dataset);
+    bool valid() const { return _timestamps != nullptr; }
+
+    Interpolation interpolation() const { return _interpolation; }
+    void interpolation(Interpolation interpolation) { _interpolation = interpolation; }
+
+    // Last row with timestamp <= `timestamp` (row 0 before the first)
+    uint64_t seek(U64 timestamp);
+    uint64_t row() const { return _row; }
+
+    // REAL column at `timestamp`; NaN if the column is not REAL
+    double sample(unsigned int column, U64 timestamp);
+    // Several columns at one timestamp, with a single seek
+    void sample(const unsigned int* columns, unsigned int count, U64 timestamp, double* values);
+    // False if the dataset lacks one of the Kinematics columns
+    bool kinematics(U64 timestamp, Kinematics& kinematics);
+
+private:
+    static const unsigned int KINEMATICS = sizeof(Kinematics) / sizeof(double);
+
+    double value(unsigned int column, double weight) const;
+
+    const Dataset* _dataset;
+    const U64* _timestamps;
+    uint64_t _rows;
+    uint64_t _row;
+    Interpolation _interpolation;
+    int _heading;
+    int _kinematics[KINEMATICS];
+};
+
+#endif // DATASET_CURSOR_H
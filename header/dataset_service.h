@@ -0,0 +1,35 @@
+#ifndef DATASET_SERVICE_H
+#define DATASET_SERVICE_H
+
+#include <string>
+
+#include "dataset.h"
+
+// Vehicle datasets loaded once by the parent, before it forks.
+// load() puts every perception-vehicle_<id> dataset (the .bin, or the CSV
+// converted in memory when there is none) into one sealed memfd mapped
+// read-only and shared. Forked children inherit the mapping, so a new
+// vehicle neither reads nor parses anything: get() hands out views straight
+// into the shared pages.
+class DatasetService
+{
+public:
+    // Loads ids 0, 1, ... until one is missing; false if none was found
+    static bool load(const std::string& directory = "dataset");
+    static void unload();
+
+    static bool loaded();
+    static unsigned int count();
+    // Size of the shared mapping
+    static size_t bytes();
+
+    // Dataset `id` (wrapping around, as vehicles outnumber datasets);
+    // nullptr if nothing is loaded
+    static const Dataset* get(int id);
+
+private:
+    struct State;
+    static State& state();
+};
+
+#endif // DATASET_SERVICE_H
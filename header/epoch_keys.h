@@ -0,0 +1,144 @@
+#ifndef EPOCH_KEYS_H
+#define EPOCH_KEYS_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+#include "ethernet.h"
+
+// MAC keys of one quadrant for consecutive key epochs (previous, current, next).
+// Read-mostly, RCU style: the single writer (the NIC worker) builds a new copy
+// in a spare version slot and publishes it with one release store; readers
+// (verify path and senders) copy the published set without locking and only
+// retry if the writer lapped them, i.e. came back to the slot they are copying.
+// Each slot is a seqlock (odd sequence while written) over atomic words, so a
+// lapped copy is detected and never a data race.
+class EpochKeys
+{
+public:
+    static const unsigned int SLOTS = 3;
+
+    struct Set {
+        unsigned int count;
+        uint32_t epoch[SLOTS];
+        Ethernet::MAC_KEY key[SLOTS];
+    };
+
+    EpochKeys() : _version(0) {
+        Set empty;
+        memset(&empty, 0, sizeof(empty));
+        for (unsigned int i = 0; i < VERSIONS; i++) {
+            _slots[i].sequence.store(0, std::memory_order_relaxed);
+            store(_slots[i], empty);
+        }
+    }
+
+    // Writer only. Installs the keys of `epoch` and `epoch + 1`, keeping
+    // `epoch - 1` so frames signed just before the switch still verify.
+    void publish(uint32_t epoch, const Ethernet::MAC_KEY& current, const Ethernet::MAC_KEY& next) {
+        unsigned int version = _version.load(std::memory_order_relaxed);
+        Set old = load(_slots[version % VERSIONS]);
+        Set set;
+        memset(&set, 0, sizeof(set));
+
+        for (unsigned int i = 0; i < old.count; i++) {
+            if (old.epoch[i] == epoch - 1) {
+                set.epoch[set.count] = old.epoch[i];
+                set.key[set.count++] = old.key[i];
+            }
+        }
+        set.epoch[set.count] = epoch;
+        set.key[set.count++] = current;
+        set.epoch[set.count] = epoch + 1;
+        set.key[set.count++] = next;
+
+        Slot& slot = _slots[(version + 1) % VERSIONS];
+        unsigned int sequence = slot.sequence.load(std::memory_order_relaxed);
+        slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+        // The odd sequence is visible before any word of the new set
+        std::atomic_thread_fence(std::memory_order_release);
+        store(slot, set);
+        slot.sequence.store(sequence + 2, std::memory_order_release);
+
+        _version.store(version + 1, std::memory_order_release);
+    }
+
+    Set snapshot() const {
+        while (true) {
+            const Slot& slot = _slots[_version.load(std::memory_order_acquire) % VERSIONS];
+            unsigned int sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence & 1) {
+                continue;
+            }
+            Set set = load(slot);
+            // No word of the copy is read after the sequence check
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) == sequence) {
+                return set;
+            }
+        }
+    }
+
+    // Key of exactly `epoch`
+    bool find(uint32_t epoch, Ethernet::MAC_KEY& key) const {
+        Set set = snapshot();
+        for (unsigned int i = 0; i < set.count; i++) {
+            if (set.epoch[i] == epoch) {
+                key = set.key[i];
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Newest key whose epoch is not after `epoch` (what a sender signs with)
+    bool latest(uint32_t epoch, uint32_t& found, Ethernet::MAC_KEY& key) const {
+        Set set = snapshot();
+        bool any = false;
+        for (unsigned int i = 0; i < set.count; i++) {
+            if (static_cast<int32_t>(set.epoch[i] - epoch) <= 0 && (!any || static_cast<int32_t>(set.epoch[i] - found) > 0)) {
+                found = set.epoch[i];
+                key = set.key[i];
+                any = true;
+            }
+        }
+        return any;
+    }
+
+    bool empty() const {
+        return snapshot().count == 0;
+    }
+
+private:
+    static const unsigned int VERSIONS = 4;
+    static const unsigned int WORDS = (sizeof(Set) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    struct Slot {
+        std::atomic<unsigned int> sequence;
+        std::atomic<uint64_t> words[WORDS];
+    };
+
+    static void store(Slot& slot, const Set& set) {
+        uint64_t words[WORDS] = {};
+        memcpy(words, &set, sizeof(set));
+        for (unsigned int i = 0; i < WORDS; i++) {
+            slot.words[i].store(words[i], std::memory_order_relaxed);
+        }
+    }
+
+    static Set load(const Slot& slot) {
+        uint64_t words[WORDS];
+        for (unsigned int i = 0; i < WORDS; i++) {
+            words[i] = slot.words[i].load(std::memory_order_relaxed);
+        }
+        Set set;
+        memcpy(&set, words, sizeof(set));
+        return set;
+    }
+
+    Slot _slots[VERSIONS];
+    std::atomic<unsigned int> _version;
+};
+
+#endif // EPOCH_KEYS_H
@@ -43,8 +43,8 @@ public:
             OTHERS
         };
         
-        Attributes() : _timestamp(0), _sync_state(SyncState::NOT_SYNCHRONIZED), _packet_origin(PacketOrigin::OTHERS), _has_mac_keys(false) {}
-        Attributes(U64 timestamp, SyncState sync_state, PacketOrigin packet_origin) : _timestamp(timestamp), _sync_state(sync_state), _packet_origin(packet_origin), _has_mac_keys(false) {}
+        Attributes() : _timestamp(0), _sync_state(SyncState::NOT_SYNCHRONIZED), _packet_origin(PacketOrigin::OTHERS), _has_mac_keys(false), _sequence(0), _key_epoch(0), _beacon_interval(0) {}
+        Attributes(U64 timestamp, SyncState sync_state, PacketOrigin packet_origin) : _timestamp(timestamp), _sync_state(sync_state), _packet_origin(packet_origin), _has_mac_keys(false), _sequence(0), _key_epoch(0), _beacon_interval(0) {}
 
         MAC get_mac() {return _mac; }
         U64 get_timestamp() { return _timestamp; }
@@ -52,6 +52,9 @@ public:
         PacketOrigin get_packet_origin() {return _packet_origin; }
         unsigned short get_quadrant() { return _quadrant; }
         bool get_has_mac_keys() { return _has_mac_keys; }
+        uint32_t get_sequence() { return _sequence; }
+        uint32_t get_key_epoch() { return _key_epoch; }
+        uint32_t get_beacon_interval() { return _beacon_interval; }
 
         void set_mac(MAC mac) {_mac = mac; }
         void set_timestamp(U64 timestamp) {_timestamp = timestamp; }
@@ -59,6 +62,9 @@ public:
         void set_packet_origin(PacketOrigin packet_origin) { _packet_origin = packet_origin; }
         void set_quadrant(unsigned short quadrant) {_quadrant = quadrant; }
         void set_has_mac_keys(bool has_mac_keys) { _has_mac_keys = has_mac_keys; }
+        void set_sequence(uint32_t sequence) { _sequence = sequence; }
+        void set_key_epoch(uint32_t key_epoch) { _key_epoch = key_epoch; }
+        void set_beacon_interval(uint32_t beacon_interval) { _beacon_interval = beacon_interval; }
 
     private:
         U64 _timestamp;
@@ -67,6 +73,12 @@ public:
         PacketOrigin _packet_origin;
         unsigned short _quadrant;
         bool _has_mac_keys;
+        // Per-NIC counter of frames sent, for replay detection
+        uint32_t _sequence;
+        // Key epoch the MAC was computed with
+        uint32_t _key_epoch;
+        // Sync beacon interval (us) the sender's clock estimate asks its RSU for, 0 = no request
+        uint32_t _beacon_interval;
     }__attribute__((packed));
     
     class Frame 
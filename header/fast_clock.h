@@ -0,0 +1,43 @@
+#ifndef FAST_CLOCK_H
+#define FAST_CLOCK_H
+
+#include <atomic>
+#include <cstdint>
+
+#include "traits.h"
+#include "u64_type.h"
+
+// Cheap timestamps for hot paths (NIC worker, SmartData, logger).
+// monotonic_ns() reads the invariant TSC scaled by a rate calibrated at
+// start-up, or a vDSO clock where there is no TSC. system_us() maps that
+// onto CLOCK_REALTIME (the clock kernel socket timestamps use) with an
+// offset re-measured every RESYNC_INTERVAL_US, so NTP slewing shows up as
+// sub-microsecond adjustments instead of a clock_gettime per call.
+class FastClock
+{
+public:
+    enum Source {
+        TSC,                // rdtsc, needs an invariant TSC
+        MONOTONIC,          // clock_gettime(CLOCK_MONOTONIC) through the vDSO
+        MONOTONIC_COARSE    // Last tick only: cheapest, but jiffy resolution
+    };
+
+    static U64 monotonic_ns();
+    static U64 system_us();
+
+    static Source source();
+    // False if the source is not usable on this machine
+    static bool use(Source source);
+    static bool supports(Source source);
+    static const char* source_name(Source source);
+    // Smallest step the current source can show
+    static U64 resolution_ns();
+
+private:
+    struct State;
+    static State& state();
+    static U64 read_ns(const State& state);
+    static void resync(State& state, U64 now_ns);
+};
+
+#endif // FAST_CLOCK_H
@@ -0,0 +1,181 @@
+#ifndef KEY_DISTRIBUTION_H
+#define KEY_DISTRIBUTION_H
+
+#include <cstring>
+#include <cstdint>
+
+#include "ethernet.h"
+#include "u64_type.h"
+
+// RSU queue of vehicles still waiting for the quadrant MAC keys.
+// Pending vehicles sit in a dense array indexed by MAC through an
+// open-addressing table, so enqueue() and confirm() (called per received
+// frame) are O(1); removal swaps the last entry in. collect() hands out up
+// to `max` due vehicles per key frame, and each one is rescheduled with
+// exponential backoff (RETRY_BASE_US << attempts, capped at RETRY_MAX_US)
+// until it confirms or MAX_ATTEMPTS frames went unanswered. A vehicle given
+// up on still gets the keys with the next epoch broadcast.
+// Not thread-safe: the NIC guards it with a mutex.
+template <unsigned int CAPACITY>
+class KeyDistribution
+{
+public:
+    static const U64 RETRY_BASE_US = 4000;
+    static const U64 RETRY_MAX_US = 256000;
+    static const unsigned int MAX_ATTEMPTS = 10;
+
+    KeyDistribution() : _count(0), _overflows(0), _given_up(0) {
+        static_assert((CAPACITY & (CAPACITY - 1)) == 0, "KeyDistribution capacity must be a power of two");
+        memset(_slots, 0, sizeof(_slots));
+    }
+
+    // False if the queue is full (the vehicle waits for the next broadcast)
+    bool enqueue(const Ethernet::Address vehicle, U64 now) {
+        uint64_t key = key_of(vehicle);
+        if (find(key) != SLOTS) {
+            return true;
+        }
+        if (_count == CAPACITY) {
+            _overflows++;
+            return false;
+        }
+        Pending& pending = _pending[_count];
+        memcpy(pending.address, vehicle, ETH_ALEN);
+        pending.key = key;
+        pending.attempts = 0;
+        pending.due = now;
+        insert(key, _count++);
+        return true;
+    }
+
+    bool confirm(const Ethernet::Address vehicle) {
+        unsigned int slot = find(key_of(vehicle));
+        if (slot == SLOTS) {
+            return false;
+        }
+        remove(_slots[slot].index);
+        return true;
+    }
+
+    // Copies up to `max` vehicles due at `now` into `out` and schedules their retries
+    unsigned int collect(U64 now, Ethernet::Address* out, unsigned int max) {
+        unsigned int taken = 0;
+        unsigned int i = 0;
+        while (i < _count && taken < max) {
+            Pending& pending = _pending[i];
+            if (pending.due > now) {
+                i++;
+                continue;
+            }
+            memcpy(out[taken++], pending.address, ETH_ALEN);
+
+            if (++pending.attempts >= MAX_ATTEMPTS) {
+                _given_up++;
+                remove(i);
+                continue;
+            }
+            U64 backoff = RETRY_BASE_US << (pending.attempts - 1);
+            pending.due = now + (backoff < RETRY_MAX_US ? backoff : RETRY_MAX_US);
+            i++;
+        }
+        return taken;
+    }
+
+    unsigned int pending() const { return _count; }
+    unsigned long overflows() const { return _overflows; }
+    unsigned long given_up() const { return _given_up; }
+
+private:
+    // At most half full, so probes stay short
+    static const unsigned int SLOTS = 2 * CAPACITY;
+    static const uint64_t USED = 1ULL << 48;
+
+    struct Pending {
+        unsigned char address[ETH_ALEN];
+        unsigned int attempts;
+        uint64_t key;
+        U64 due;
+    };
+
+    struct Slot {
+        uint64_t key;           // MAC48 | USED, 0 when empty
+        unsigned int index;     // Into _pending
+    };
+
+    static uint64_t key_of(const Ethernet::Address vehicle) {
+        uint64_t key = 0;
+        for (unsigned int i = 0; i < ETH_ALEN; i++) {
+            key = (key << 8) | vehicle[i];
+        }
+        return key | USED;
+    }
+
+    static unsigned int home_of(uint64_t key) {
+        // Fibonacci hashing, as in VehicleTable: vendor prefixes are shared
+        return static_cast<unsigned int>((key * 0x9E3779B97F4A7C15ULL) >> 40) & (SLOTS - 1);
+    }
+
+    // Slot holding `key`, SLOTS if absent
+    unsigned int find(uint64_t key) const {
+        for (unsigned int slot = home_of(key); _slots[slot].key != 0; slot = (slot + 1) & (SLOTS - 1)) {
+            if (_slots[slot].key == key) {
+                return slot;
+            }
+        }
+        return SLOTS;
+    }
+
+    void insert(uint64_t key, unsigned int index) {
+        unsigned int slot = home_of(key);
+        while (_slots[slot].key != 0) {
+            slot = (slot + 1) & (SLOTS - 1);
+        }
+        _slots[slot].key = key;
+        _slots[slot].index = index;
+    }
+
+    // Backward-shift deletion: later entries of the probe run move into the
+    // hole unless that would put them before their home slot
+    void erase(unsigned int slot) {
+        unsigned int hole = slot;
+        for (unsigned int next = (hole + 1) & (SLOTS - 1); _slots[next].key != 0; next = (next + 1) & (SLOTS - 1)) {
+            unsigned int home = home_of(_slots[next].key);
+            bool movable = hole <= next ? (home <= hole || home > next) : (home <= hole && home > next);
+            if (movable) {
+                _slots[hole] = _slots[next];
+                hole = next;
+            }
+        }
+        _slots[hole].key = 0;
+    }
+
+    // The last entry takes the removed one's place
+    void remove(unsigned int index) {
+        erase(find(_pending[index].key));
+        unsigned int last = --_count;
+        if (index != last) {
+            _pending[index] = _pending[last];
+            _slots[find(_pending[index].key)].index = index;
+        }
+    }
+
+private:
+    Pending _pending[CAPACITY];
+    Slot _slots[SLOTS];
+    unsigned int _count;
+    unsigned long _overflows;
+    unsigned long _given_up;
+};
+
+template <unsigned int CAPACITY>
+const U64 KeyDistribution<CAPACITY>::RETRY_BASE_US;
+template <unsigned int CAPACITY>
+const U64 KeyDistribution<CAPACITY>::RETRY_MAX_US;
+template <unsigned int CAPACITY>
+const unsigned int KeyDistribution<CAPACITY>::MAX_ATTEMPTS;
+template <unsigned int CAPACITY>
+const unsigned int KeyDistribution<CAPACITY>::SLOTS;
+template <unsigned int CAPACITY>
+const uint64_t KeyDistribution<CAPACITY>::USED;
+
+#endif // KEY_DISTRIBUTION_H
@@ -0,0 +1,85 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <atomic>
+#include <cstdint>
+
+// Lock-free log2 histogram of durations. Any thread may record while another
+// reads a snapshot; the snapshot is not atomic as a whole, which is fine for
+// statistics. Bucket 0 counts durations below 1 us, bucket i (i > 0) those in
+// [2^(i-1), 2^i) us, and the last bucket everything longer.
+class LatencyHistogram
+{
+public:
+    static const unsigned int BUCKETS = 20;
+
+    struct Snapshot {
+        unsigned long count;
+        double mean_us;
+        double max_us;
+        unsigned long buckets[BUCKETS];
+
+        // Upper bound of the bucket holding the p-th percentile (p in [0, 1])
+        double percentile_us(double p) const {
+            if (count == 0) {
+                return 0;
+            }
+            unsigned long rank = static_cast<unsigned long>(p * count);
+            unsigned long seen = 0;
+            for (unsigned int i = 0; i < BUCKETS - 1; i++) {
+                seen += buckets[i];
+                if (seen > rank) {
+                    return static_cast<double>(1ULL << i) < max_us ? static_cast<double>(1ULL << i) : max_us;
+                }
+            }
+            return max_us;
+        }
+    };
+
+    LatencyHistogram() {
+        reset();
+    }
+
+    void record(uint64_t ns) {
+        _count.fetch_add(1, std::memory_order_relaxed);
+        _sum_ns.fetch_add(ns, std::memory_order_relaxed);
+        uint64_t max = _max_ns.load(std::memory_order_relaxed);
+        while (ns > max && !_max_ns.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {}
+
+        uint64_t us = ns / 1000;
+        unsigned int bucket = 0;
+        while (us > 0 && bucket < BUCKETS - 1) {
+            us >>= 1;
+            bucket++;
+        }
+        _buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Snapshot snapshot() const {
+        Snapshot snapshot;
+        snapshot.count = _count.load(std::memory_order_relaxed);
+        snapshot.mean_us = snapshot.count ? _sum_ns.load(std::memory_order_relaxed) / 1000.0 / snapshot.count : 0;
+        snapshot.max_us = _max_ns.load(std::memory_order_relaxed) / 1000.0;
+        for (unsigned int i = 0; i < BUCKETS; i++) {
+            snapshot.buckets[i] = _buckets[i].load(std::memory_order_relaxed);
+        }
+        return snapshot;
+    }
+
+    void reset() {
+        _count.store(0);
+        _sum_ns.store(0);
+        _max_ns.store(0);
+        for (unsigned int i = 0; i < BUCKETS; i++) {
+            _buckets[i].store(0);
+        }
+    }
+
+private:
+    std::atomic<unsigned long> _count;
+    std::atomic<uint64_t> _sum_ns;
+    std::atomic<uint64_t> _max_ns;
+    std::atomic<unsigned long> _buckets[BUCKETS];
+};
+
+#endif // LATENCY_HISTOGRAM_H
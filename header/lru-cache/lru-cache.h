@@ -3,7 +3,11 @@
 
 #include "node.h"
 #include <unordered_map>
+#include <vector>
 
+// Bounded LRU map for key sets without a small dense index (quadrant keys use
+// MACKeyTable instead). List nodes come from a pool allocated up front:
+// put() recycles the evicted node instead of calling new/delete.
 template <typename T, typename V>
 class LRU_Cache
 {
@@ -16,6 +20,9 @@ private:
     NodeT* head; // Sentinel head node
     NodeT* tail; // Sentinel tail node
 
+    std::vector<NodeT> pool;
+    NodeT* free_nodes;
+
     void remove(NodeT* node) {
         node->prev->next = node->next;
         node->next->prev = node->prev;
@@ -28,30 +35,43 @@ private:
         head->next = node;
     }
 
+    NodeT* take_node() {
+        NodeT* node = free_nodes;
+        free_nodes = node->next;
+        return node;
+    }
+
+    void release_node(NodeT* node) {
+        node->prev = nullptr;
+        node->next = free_nodes;
+        free_nodes = node;
+    }
+
 public:
-    LRU_Cache(int capacity) {
-        this->capacity = capacity;
-        head = new NodeT();
-        tail = new NodeT();
+    LRU_Cache(int capacity) : pool(capacity > 0 ? capacity + 2 : 3) {
+        this->capacity = capacity > 0 ? capacity : 1;
+        cache.reserve(this->capacity);
 
+        head = &pool[0];
+        tail = &pool[1];
         head->next = tail;
         tail->prev = head;
-    }
 
-    ~LRU_Cache() {
-        NodeT* current = head;
-        while (current != nullptr) {
-            NodeT* next = current->next;
-            delete current;
-            current = next;
+        free_nodes = nullptr;
+        for (size_t i = pool.size() - 1; i >= 2; i--) {
+            release_node(&pool[i]);
         }
     }
 
+    LRU_Cache(const LRU_Cache&) = delete;
+    LRU_Cache& operator=(const LRU_Cache&) = delete;
+
     V* get(const T& key) {
-        if (cache.find(key) == cache.end()) {
+        auto it = cache.find(key);
+        if (it == cache.end()) {
             return nullptr;
         }
-        NodeT* node = cache[key];
+        NodeT* node = it->second;
 
         remove(node);
         add(node);
@@ -60,34 +80,46 @@ public:
     }
 
     void put(const T key, const V value) {
-        if (cache.find(key) != cache.end()) {
-            NodeT* existing = cache[key];
+        auto it = cache.find(key);
+        if (it != cache.end()) {
+            NodeT* existing = it->second;
+            existing->value = value;
             remove(existing);
-            delete existing;
+            add(existing);
+            return;
+        }
+
+        NodeT* node;
+        if (cache.size() >= capacity) {
+            // Recycle the least recently used node
+            node = tail->prev;
+            remove(node);
+            cache.erase(node->key);
+        } else {
+            node = take_node();
         }
 
-        NodeT* node = new NodeT(key, value);
+        node->key = key;
+        node->value = value;
         cache[key] = node;
         add(node);
-
-        if (cache.size() > capacity) {
-            NodeT* last = tail->prev;
-            cache.erase(last->key);
-            remove(last);
-            delete last;
-        }
     }
 
     void erase(const T& key) {
-        if (cache.find(key) != cache.end()) {
-            NodeT* node = cache[key];
+        auto it = cache.find(key);
+        if (it != cache.end()) {
+            NodeT* node = it->second;
 
             remove(node);
-            cache.erase(node->key);
+            cache.erase(it);
 
-            delete node;
+            release_node(node);
         }
     }
+
+    size_t size() const {
+        return cache.size();
+    }
 };
 
 #endif // LRU_CACHE_H
\ No newline at end of file
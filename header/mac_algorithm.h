@@ -0,0 +1,133 @@
+#ifndef MAC_ALGORITHM_H
+#define MAC_ALGORITHM_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "ethernet.h"
+
+// Message authentication algorithm used by MACHandler.
+// Every algorithm is keyed by the 8-byte per-quadrant Ethernet::MAC_KEY and
+// produces the 32-bit tag carried in Ethernet::Attributes.
+class MACAlgorithm
+{
+public:
+    enum Type {
+        XOR_FOLD,       // Original fold, cheap but forgeable
+        SIPHASH_2_4,    // Keyed PRF, 64-bit output truncated
+        NH_UNIVERSAL    // NH universal hash finalized by SipHash-2-4
+    };
+
+    // Kernels for the bulk loops, chosen from what the CPU supports
+    enum Implementation {
+        SCALAR,     // 8 bytes per step
+        SSE2,       // 16 bytes per step
+        AVX2        // 32 bytes per step
+    };
+
+    virtual ~MACAlgorithm() {}
+
+    virtual Type type() const = 0;
+    virtual void set_key(const Ethernet::MAC_KEY& key) = 0;
+    virtual uint32_t compute(const unsigned char* data, size_t length) const = 0;
+
+    // Tags for n independent messages under the same key; algorithms that
+    // cannot vectorize a single message interleave several in SIMD lanes
+    virtual void compute_batch(const unsigned char* const* data, const size_t* lengths, uint32_t* tags, size_t n) const {
+        for (size_t i = 0; i < n; i++) tags[i] = compute(data[i], lengths[i]);
+    }
+
+    // Algorithms without vector kernels only accept SCALAR
+    virtual bool use(Implementation implementation) { return implementation == SCALAR; }
+    virtual Implementation implementation() const { return SCALAR; }
+
+    static MACAlgorithm* create(Type type, size_t mac_byte_size = Ethernet::MAC_BYTE_SIZE);
+    static const char* type_name(Type type);
+
+    static bool supports(Implementation implementation);
+    static Implementation best_implementation();
+    static const char* implementation_name(Implementation implementation);
+
+    // Expands the 8-byte key into `words` independent 64-bit words for the given purpose.
+    // The extended key is only as strong as the 64 bits it comes from.
+    static void extend_key(const Ethernet::MAC_KEY& key, uint64_t domain, uint64_t* words, size_t count);
+};
+
+// Original byte-wise XOR fold into mac_byte_size bytes, last 4 bytes returned
+class XorFoldMAC : public MACAlgorithm
+{
+public:
+    // Whole blocks are folded into 32 lanes, so the MAC size must fit in them
+    static const size_t MAX_MAC_BYTE_SIZE = 32;
+
+    XorFoldMAC(size_t mac_byte_size = Ethernet::MAC_BYTE_SIZE);
+
+    Type type() const { return XOR_FOLD; }
+    void set_key(const Ethernet::MAC_KEY& key);
+    uint32_t compute(const unsigned char* data, size_t length) const;
+
+    bool use(Implementation implementation);
+    Implementation implementation() const { return _implementation; }
+
+private:
+    typedef void (*FoldFunction)(const unsigned char* data, size_t blocks, unsigned char* lanes);
+
+    size_t _mac_byte_size;
+    Ethernet::MAC_KEY _key;
+    Implementation _implementation;
+    FoldFunction _fold;
+};
+
+// SipHash-2-4 (Aumasson & Bernstein) with a 128-bit key extended from the MAC key
+class SipHashMAC : public MACAlgorithm
+{
+public:
+    // Messages hashed side by side by the AVX2 batch kernel
+    static const size_t LANES = 4;
+
+    SipHashMAC();
+
+    Type type() const { return SIPHASH_2_4; }
+    void set_key(const Ethernet::MAC_KEY& key);
+    uint32_t compute(const unsigned char* data, size_t length) const;
+    void compute_batch(const unsigned char* const* data, const size_t* lengths, uint32_t* tags, size_t n) const;
+
+    bool use(Implementation implementation);
+    Implementation implementation() const { return _implementation; }
+
+    static uint64_t siphash(const uint64_t key[2], const unsigned char* data, size_t length);
+
+private:
+    uint64_t _key[2];
+    Implementation _implementation;
+};
+
+// UMAC-style construction: NH over 1 KiB chunks (pairwise (m + k) products summed mod 2^64),
+// the chunk hashes and the length are then authenticated with SipHash-2-4 under a separate key
+class NHUniversalMAC : public MACAlgorithm
+{
+public:
+    static const size_t BLOCK_SIZE = 32;
+    static const size_t CHUNK_SIZE = 1024;
+    static const size_t KEY_WORDS = CHUNK_SIZE / sizeof(uint32_t);
+
+    NHUniversalMAC();
+
+    Type type() const { return NH_UNIVERSAL; }
+    void set_key(const Ethernet::MAC_KEY& key);
+    uint32_t compute(const unsigned char* data, size_t length) const;
+
+    bool use(Implementation implementation);
+    Implementation implementation() const { return _implementation; }
+
+private:
+    // Returns the NH sum of `blocks` 32-byte blocks against the key words
+    typedef uint64_t (*NHFunction)(const unsigned char* data, size_t blocks, const uint32_t* key);
+
+    uint32_t _nh_key[KEY_WORDS];
+    uint64_t _finalize_key[2];
+    Implementation _implementation;
+    NHFunction _nh;
+};
+
+#endif // MAC_ALGORITHM_H
@@ -8,9 +8,12 @@
 #include <random>
 #include <algorithm>
 #include <iostream>
+#include <memory>
 
 
 #include "ethernet.h"
+#include "mac_algorithm.h"
+#include "traits.h"
 
 
 // Define o tamanho do MAC em bytes. Um MAC de 4 bytes pode ser representado como uint32_t.
@@ -20,21 +23,77 @@ class MACHandler
 {
 
 public:
-    MACHandler(size_t mac_size_bytes = Ethernet::MAC_BYTE_SIZE);
+    // One received frame for verify_batch; `valid` is the output
+    struct Frame {
+        const unsigned char* data;
+        size_t length;
+        uint32_t sequence;          // Bound into the tag with the epoch
+        uint32_t epoch;
+        uint32_t mac;
+        Ethernet::MAC_KEY key;      // Sender quadrant key
+        bool valid;
+    };
+
+    // Keyed contexts kept for keys other than our own (neighbouring quadrants x live epochs)
+    static const size_t KEY_CONTEXTS = 8;
+    // Frames handed to the algorithm at once
+    static const size_t BATCH_GROUP = 16;
+    // Sequence and key epoch ahead of the payload in the tagged input
+    static const size_t BOUND_SIZE = 2 * sizeof(uint32_t);
+
+    MACHandler(size_t mac_size_bytes = Ethernet::MAC_BYTE_SIZE,
+               MACAlgorithm::Type algorithm = static_cast<MACAlgorithm::Type>(Traits<MACHandler>::ALGORITHM));
 
     void create_mac_key();
     void set_mac_key(Ethernet::MAC_KEY *key);
     Ethernet::MAC_KEY* get_mac_key();
+    bool has_mac_key(const Ethernet::MAC_KEY& key) const { return _key_is_set && key == _mac_key; }
+
+    // Key of `epoch` derived from a quadrant's base key (RSU side of key rotation)
+    static Ethernet::MAC_KEY derive_epoch_key(const Ethernet::MAC_KEY& base, uint32_t epoch);
 
     void print_mac_key();
 
+    // Switches algorithm, keeping the current key
+    void set_algorithm(MACAlgorithm::Type algorithm);
+    MACAlgorithm::Type algorithm() const { return _algorithm->type(); }
+
+    // Returns false (keeping the current kernel) if the CPU or algorithm lacks it
+    bool use(MACAlgorithm::Implementation implementation) { return _algorithm->use(implementation); }
+    MACAlgorithm::Implementation implementation() const { return _algorithm->implementation(); }
+
     uint32_t generate_mac(const unsigned char* data, size_t data_length) const;
     bool verify_mac(const unsigned char* data, size_t data_length, uint32_t received_mac) const;
+    // Tag over sequence || epoch || payload, so the replay sequence and key
+    // epoch, which travel outside the payload, cannot be changed either
+    uint32_t generate_mac(uint32_t sequence, uint32_t epoch, const unsigned char* data, size_t data_length) const;
+
+    // Verifies n frames (tags over sequence || epoch || payload), grouping
+    // those under the same key so each group is computed in one
+    // compute_batch call. Returns how many are valid.
+    // Keeps a per-handler context cache: call from a single thread.
+    size_t verify_batch(Frame* frames, size_t n);
+
+private:
+    // Writes sequence || epoch || payload to `out`; returns its length
+    static size_t bind(unsigned char* out, uint32_t sequence, uint32_t epoch, const unsigned char* data, size_t data_length);
+    const MACAlgorithm* context(const Ethernet::MAC_KEY& key);
+    void verify_group(const MACAlgorithm* algorithm, Frame** group, size_t count);
 
 private:
     bool _key_is_set;
     size_t _mac_byte_size;
     Ethernet::MAC_KEY _mac_key;
+    std::unique_ptr<MACAlgorithm> _algorithm;
+
+    struct KeyContext {
+        Ethernet::MAC_KEY key;
+        std::unique_ptr<MACAlgorithm> algorithm;
+    };
+    KeyContext _contexts[KEY_CONTEXTS];
+    size_t _next_context;
+    // Bound inputs of one verify group
+    std::vector<unsigned char> _bound;
 };
 
 #endif // MAC_HANDLER_H
\ No newline at end of file
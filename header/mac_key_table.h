@@ -0,0 +1,66 @@
+#ifndef MAC_KEY_TABLE_H
+#define MAC_KEY_TABLE_H
+
+#include <cstdint>
+
+#include "epoch_keys.h"
+#include "ethernet.h"
+
+template <unsigned int SIZE>
+struct MACKeyTablePadding {
+    char pad[SIZE];
+};
+
+template <>
+struct MACKeyTablePadding<0> {};
+
+// Fixed-capacity MAC key table indexed directly by quadrant number (1..QUADRANTS).
+// Replaces the LRU cache on the verify path: lookups are an array index plus an
+// EpochKeys snapshot, so they never allocate, chase list pointers or write shared
+// state. Each quadrant has its own cache lines so a publish for one quadrant
+// does not disturb readers of another.
+template <unsigned int QUADRANTS>
+class MACKeyTable
+{
+public:
+    static const unsigned int CACHE_LINE = 64;
+
+    static bool valid(unsigned int quadrant) {
+        return quadrant >= 1 && quadrant <= QUADRANTS;
+    }
+
+    // Writer only (NIC worker)
+    void publish(unsigned int quadrant, uint32_t epoch, const Ethernet::MAC_KEY& current, const Ethernet::MAC_KEY& next) {
+        if (valid(quadrant)) {
+            _entries[quadrant - 1].keys.publish(epoch, current, next);
+        }
+    }
+
+    bool find(unsigned int quadrant, uint32_t epoch, Ethernet::MAC_KEY& key) const {
+        return valid(quadrant) && _entries[quadrant - 1].keys.find(epoch, key);
+    }
+
+    bool latest(unsigned int quadrant, uint32_t epoch, uint32_t& found, Ethernet::MAC_KEY& key) const {
+        return valid(quadrant) && _entries[quadrant - 1].keys.latest(epoch, found, key);
+    }
+
+    bool empty(unsigned int quadrant) const {
+        return !valid(quadrant) || _entries[quadrant - 1].keys.empty();
+    }
+
+private:
+    // Padded rather than aligned: C++11 operator new ignores over-alignment
+    // and NIC objects are heap allocated. No padding when EpochKeys already
+    // ends on a line boundary
+    struct Entry : MACKeyTablePadding<(CACHE_LINE - sizeof(EpochKeys) % CACHE_LINE) % CACHE_LINE> {
+        EpochKeys keys;
+    };
+    static_assert(sizeof(Entry) % CACHE_LINE == 0, "MACKeyTable entries must fill whole cache lines");
+
+    Entry _entries[QUADRANTS];
+};
+
+template <unsigned int QUADRANTS>
+const unsigned int MACKeyTable<QUADRANTS>::CACHE_LINE;
+
+#endif // MAC_KEY_TABLE_H
@@ -0,0 +1,111 @@
+#ifndef MEMORY_ENGINE_H
+#define MEMORY_ENGINE_H
+
+#include <semaphore.h>
+#include <errno.h>
+#include <cstring>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "ethernet.h"
+#include "traits.h"
+#include "u64_type.h"
+#include "channel_model.h"
+
+class MemoryEngine;
+
+// In-process broadcast medium standing in for one Ethernet segment: a frame
+// sent by one engine is queued at every other attached engine, like the raw
+// socket sees every frame on the wire. The frame is built once and shared
+// (read only) by all receivers.
+// While the Simulator is active the bus delivers through a ChannelModel:
+// each receiver gets the frame in a later event, or not at all, so a fleet
+// of n engines costs n - 1 events per frame.
+class MemoryBus
+{
+public:
+    MemoryBus() : _channel(nullptr) {}
+
+    // Medium of the engines a NIC creates
+    static MemoryBus& shared();
+
+    // Channel used while the Simulator is active; nullptr goes back to an
+    // idle channel with the default links
+    void channel(ChannelModel* model) {
+        _channel = model;
+        _default_channel.reset();
+    }
+
+    void attach(MemoryEngine* engine);
+    void detach(MemoryEngine* engine);
+    // Returns the number of engines the frame was queued at
+    unsigned int broadcast(const MemoryEngine* sender, const std::shared_ptr<Ethernet::Frame>& frame, unsigned int size, U64 timestamp);
+
+    unsigned int engines();
+
+private:
+    // Simulated delivery; the engine may have left the bus in the meantime.
+    // `index` is its place in _engines at broadcast, checked before searching.
+    // Engines are delivered to under _mutex, so detach() waits for deliveries
+    void arrive(MemoryEngine* engine, unsigned int index, const std::shared_ptr<Ethernet::Frame>& frame, unsigned int size);
+
+    ChannelModel* _channel;
+    ChannelModel _default_channel;
+    std::mutex _mutex;
+    std::vector<MemoryEngine*> _engines;
+};
+
+// NIC engine over a MemoryBus, with the RawSocketEngine interface. Frames
+// are stamped with the send time, which plays the kernel timestamp on both
+// sides; under the Simulator they are not stamped, and the NIC stamps them
+// with its virtual clock as they arrive. Each engine keeps at most QUEUE_FRAMES frames; further frames are
+// dropped, like a full socket receive buffer.
+class MemoryEngine
+{
+public:
+    static const unsigned int QUEUE_FRAMES = Traits<MemoryEngine>::QUEUE_FRAMES;
+
+    explicit MemoryEngine(MemoryBus& bus = MemoryBus::shared());
+    ~MemoryEngine();
+
+    int raw_send(Ethernet::Address dst, Ethernet::Protocol prot, Ethernet::Attributes* attributes, const void* data, unsigned int size, U64* tx_timestamp = nullptr);
+    // -1 with errno EAGAIN when nothing is queued
+    int raw_receive(Ethernet::Address* src, Ethernet::Protocol* prot, Ethernet::Attributes* attributes, void* data, unsigned int size, U64* timestamp = nullptr);
+
+    // Posted whenever a frame is queued (nullptr stops it and the handler).
+    // Once notify(nullptr) returns the old semaphore is never posted again
+    void notify(sem_t* semaphore);
+    // Called on the delivering thread whenever a frame is queued (simulation)
+    void notify(const std::function<void()>& handler);
+    bool enable_tx_timestamps();
+
+    const Ethernet::Address& address() const { return _addr; }
+    unsigned long dropped() const { return _dropped.load(std::memory_order_relaxed); }
+
+    // Called by the bus: queues the frame and posts the semaphore
+    bool deliver(const std::shared_ptr<Ethernet::Frame>& frame, unsigned int size, U64 timestamp);
+    // Called by the bus, outside its lock, after a simulated delivery
+    std::function<void()> handler();
+
+private:
+    struct Delivery {
+        std::shared_ptr<Ethernet::Frame> frame;
+        unsigned int size;
+        U64 timestamp;
+    };
+
+    MemoryBus& _bus;
+    Ethernet::Address _addr;
+    std::mutex _mutex;
+    std::deque<Delivery> _queue;
+    // Guarded by _mutex, which deliver() holds while posting it
+    sem_t* _notify;
+    std::function<void()> _handler;
+    std::atomic<unsigned long> _dropped;
+};
+
+#endif // MEMORY_ENGINE_H
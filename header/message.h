@@ -83,6 +83,15 @@ public:
         int value;
     };
 
+    // RSU sync beacon (two-step): the frame timestamp is the one-step send time,
+    // follow_up the kernel send time of beacon follow_up_sequence (0 without TX timestamps)
+    struct PTPMessage {
+        uint32_t sequence;
+        uint32_t interval_us;
+        U64 follow_up;
+        uint32_t follow_up_sequence;
+    };
+
     // Constructor with a specified maximum size
     Message(size_t max_size = 1500);
 
@@ -0,0 +1,100 @@
+#ifndef NETWORK_ENGINE_H
+#define NETWORK_ENGINE_H
+
+#include <semaphore.h>
+#include <functional>
+
+#include "ethernet.h"
+#include "u64_type.h"
+#include "raw_socket_engine.h"
+#include "memory_engine.h"
+
+// NIC engine chosen at run time: the raw socket for real networks, or a
+// MemoryEngine on the shared MemoryBus so many agents run in one process.
+// use() must be called before the first NIC is created.
+class NetworkEngine
+{
+public:
+    enum Backend {
+        RAW_SOCKET,
+        MEMORY
+    };
+
+    static void use(Backend backend) { selected() = backend; }
+    static Backend backend() { return selected(); }
+
+protected:
+    NetworkEngine() : _raw_socket(nullptr), _memory(nullptr) {
+        if (selected() == MEMORY) {
+            _memory = new MemoryEngine();
+            memcpy(_addr, _memory->address(), ETH_ALEN);
+        } else {
+            _raw_socket = new RawSocket();
+            memcpy(_addr, _raw_socket->address(), ETH_ALEN);
+        }
+    }
+
+    ~NetworkEngine() {
+        delete _raw_socket;
+        delete _memory;
+    }
+
+    int raw_send(Ethernet::Address dst, Ethernet::Protocol prot, Ethernet::Attributes* attributes, const void* data, unsigned int size, U64* tx_timestamp = nullptr) {
+        if (_memory) {
+            return _memory->raw_send(dst, prot, attributes, data, size, tx_timestamp);
+        }
+        return _raw_socket->raw_send(dst, prot, attributes, data, size, tx_timestamp);
+    }
+
+    int raw_receive(Ethernet::Address* src, Ethernet::Protocol* prot, Ethernet::Attributes* attributes, void* data, unsigned int size, U64* timestamp = nullptr) {
+        if (_memory) {
+            return _memory->raw_receive(src, prot, attributes, data, size, timestamp);
+        }
+        return _raw_socket->raw_receive(src, prot, attributes, data, size, timestamp);
+    }
+
+    bool enable_tx_timestamps() {
+        return _memory ? _memory->enable_tx_timestamps() : _raw_socket->enable_tx_timestamps();
+    }
+
+    void notify(sem_t* semaphore) {
+        if (_memory) {
+            _memory->notify(semaphore);
+        } else {
+            _raw_socket->notify(semaphore);
+        }
+    }
+
+    // Simulation: frames are handed over on the delivering thread
+    void notify(const std::function<void()>& handler) {
+        if (_memory) {
+            _memory->notify(handler);
+        } else {
+            ConsoleLogger::error("NetworkEngine: the raw socket cannot deliver inline");
+        }
+    }
+
+private:
+    static Backend& selected() {
+        static Backend backend = RAW_SOCKET;
+        return backend;
+    }
+
+    struct RawSocket: public RawSocketEngine {
+        using RawSocketEngine::raw_send;
+        using RawSocketEngine::raw_receive;
+        using RawSocketEngine::enable_tx_timestamps;
+        using RawSocketEngine::notify;
+
+        const Ethernet::Address& address() const { return _addr; }
+    };
+
+protected:
+    Ethernet::Address _addr;
+
+private:
+    RawSocket* _raw_socket;
+    MemoryEngine* _memory;
+};
+
+#endif // NETWORK_ENGINE_H
@@ -1,8 +1,6 @@
 #ifndef NIC_H
 #define NIC_H
 
-#include <fcntl.h>
-#include <signal.h>
 #include <unistd.h>
 #include <errno.h>
 #include <list>
@@ -16,6 +14,7 @@
 #include "observer.h"
 #include "ethernet.h"
 #include "console_logger.h"
+#include "async_logger.h"
 #include "mac_address_generator.h"
 #include "mac_handler.h"
 #include "protocol.h"
@@ -23,7 +22,12 @@
 #include "semaphore.h"
 #include "time_keeper.h"
 #include "vehicle_table.h"
-#include "lru-cache/lru-cache.h"
+#include "replay_window.h"
+#include "mac_key_table.h"
+#include "key_distribution.h"
+#include "message.h"
+#include "thread_placement.h"
+#include "simulator.h"
 
 template <typename Engine>
 class NIC: public Ethernet, public Conditionally_Data_Observed<Buffer<Ethernet::Frame>,
@@ -39,54 +43,56 @@ public:
     typedef Conditional_Data_Observer<Buffer<Ethernet::Frame>, Ethernet::Protocol> Observer;
     typedef Conditionally_Data_Observed<Buffer<Ethernet::Frame>, Ethernet::Protocol> Observed;
 
-    static NIC<Engine>* _instance;
 public:
-    NIC(const std::string& id, const unsigned short quadrant) : _buffer_pool(Ethernet::MTU), _running(true), _send_mac_key(false), _quadrant(quadrant), 
-                                                                _packet_origin(Ethernet::Attributes::PacketOrigin::OTHERS), _attribute_map_id(0) {
+    NIC(const std::string& id, const unsigned short quadrant) : _buffer_pool(Ethernet::MTU), _running(true), _quadrant(quadrant), 
+                                                                _packet_origin(Ethernet::Attributes::PacketOrigin::OTHERS), _attribute_map_id(0), _has_base_keys(false), _announced_epoch(0),
+                                                                _sequence(0), _replayed_frames(0), _tx_latency(0),
+                                                                _beacon_sequence(0), _beacon_follow_up(0), _beacon_follow_up_sequence(0), _beacon_request_start(0) {
+        _beacon_request[0] = _beacon_request[1] = Traits<TimeKeeper>::BEACON_MAX_US;
         ConsoleLogger::print("NIC " + id + ": Starting...");
         // MAC ADDRESS + PID + COMPONENT ID
         MacAddressGenerator::generate_mac_from_seed(id, _address);
         ConsoleLogger::print("NIC " + id + ": Logical MAC created");
         ConsoleLogger::print("NIC " + id + ": MAC ADDRESS -> "+  mac_to_string(_address));
 
-        _instance = this;
-
-        // Register the signal handler for SIGIO
-        struct sigaction sa;
-        memset(&sa, 0, sizeof(sa));
-        sa.sa_flags = SA_RESTART;
-        sa.sa_handler = &NIC::sigio_handler;
-        if (sigaction(SIGIO, &sa, NULL) < 0) {
-            ConsoleLogger::error("sigaction");
-            exit(EXIT_FAILURE);
-        }
-
         sem_init(&_sem, 0, 0);
+        if (Simulator::active()) {
+            // Simulation: frames are processed in the event that delivers them
+            Engine::notify(std::bind(&NIC::process_incoming_data, this));
+        } else {
+            // The engine posts _sem whenever frames arrive
+            Engine::notify(&_sem);
+        }
 
-        // Configure socket for async I/O
-        int flags = fcntl(Engine::_socket, F_GETFL, 0);
-        fcntl(Engine::_socket, F_SETFL, flags | O_ASYNC | O_NONBLOCK);
-        fcntl(Engine::_socket, F_SETOWN, getpid());
-        
         _time_keeper = new TimeKeeper();
         _mac_handler = new MACHandler();
-        _mac_key_cache = new LRU_Cache<unsigned short, Ethernet::MAC_KEY>(5);
 
-        _worker_thread = std::thread(&NIC::data_processing_thread, this);
+        if (!Simulator::active()) {
+            _worker_thread = std::thread(&NIC::data_processing_thread, this);
+        }
     }
     ~NIC() {
-        _instance->stop();
+        stop();
+        sem_destroy(&_sem);
+        delete _mac_handler;
+        delete _time_keeper;
     }
 
     U64 get_local_timestamp() {
         return _time_keeper->get_local_timestamp();
     }
 
+    U64 get_system_timestamp() {
+        return _time_keeper->get_system_timestamp();
+    }
+
     void stop() {
-        ConsoleLogger::log("NIC: Stopping");
+        LOG_INFO("NIC: Stopping");
         cleanup_nic();
     }
     
+    // RSU: keeps the base keys of the previous, next and own quadrants; the
+    // per-epoch keys handed to vehicles are derived from them
     void create_mac_key_data(std::vector<Ethernet::MAC_KEY> mac_keys) {
         if (mac_keys.empty()) {
             std::cerr << "Error: mac_keys vector is empty. Cannot create MAC key data." << std::endl;
@@ -114,37 +120,14 @@ public:
 
         unsigned short prev_quad = (_quadrant == 1) ? mac_keys.size() : _quadrant - 1;
         unsigned short next_quad = (_quadrant % mac_keys.size()) + 1;
-        
-        unsigned char* ptr = _mac_key_data;
-        const size_t key_size = Ethernet::MAC_BYTE_SIZE;
-        const size_t id_size = sizeof(unsigned short);
-
-        // quadrante anterior
-        memcpy(ptr, &prev_quad, id_size);
-        ptr += id_size;
-        memcpy(ptr, mac_keys[prev_quad - 1].data(), key_size);
-        ptr += key_size;
-
-        // quadrante posterior
-        memcpy(ptr, &next_quad, id_size);
-        ptr += id_size;
-        memcpy(ptr, mac_keys[next_quad - 1].data(), key_size);
-        ptr += key_size;
-
-        // atual
-        memcpy(ptr, &_quadrant, id_size);
-        ptr += id_size;
-        memcpy(ptr, mac_keys[_quadrant - 1].data(), key_size);
-        ptr += key_size;
-
-        if (_quadrant == 4) {
-            std::cout << std::hex;
-            int total_length = 3 * (id_size + key_size);
-            for (int i = 0; i < total_length; i++) {
-                std::cout << static_cast<unsigned int>(_mac_key_data[i]) << " ";
-            }
-            std::cout << std::dec << std::endl;
+
+        // quadrante anterior, posterior e atual
+        const unsigned short quadrants[MAC_KEY_QUADRANTS] = {prev_quad, next_quad, static_cast<unsigned short>(_quadrant)};
+        for (unsigned int i = 0; i < MAC_KEY_QUADRANTS; i++) {
+            _base_keys[i].quadrant = quadrants[i];
+            _base_keys[i].key = mac_keys[quadrants[i] - 1];
         }
+        _has_base_keys = true;
     }
 
     Ethernet::MessageInfo get_message_info(const unsigned int id) {
@@ -167,19 +150,20 @@ public:
 
     NICBuffer* alloc(const Address dst, Protocol_Number prot, unsigned int size) {
         //ConsoleLogger::print("NIC: Allocating buffer. ");
-        
-        NICBuffer* buf = _buffer_pool.alloc();
-        if(!buf) {
+        // Stopping: the pool may be exhausted and stop() wakes only one waiter
+        if (!_running) {
             return nullptr;
         }
+        
+        return prepare(_buffer_pool.alloc(), dst, prot, size);
+    }
 
-        buf->size(size + sizeof(Ethernet::Header) + sizeof(Ethernet::Attributes));
-        Ethernet::Frame* frame = buf->frame();
-        memcpy(frame->header()->h_dest, dst, ETH_ALEN);
-        memcpy(frame->header()->h_source, Engine::_addr, ETH_ALEN);
-        frame->header()->h_proto = htons(prot);
-
-        return buf;
+    // Non-blocking alloc(): nullptr if the pool is exhausted
+    NICBuffer* try_alloc(const Address dst, Protocol_Number prot, unsigned int size) {
+        if (!_running) {
+            return nullptr;
+        }
+        return prepare(_buffer_pool.try_alloc(), dst, prot, size);
     }
 
     int send(NICBuffer* buf) {
@@ -207,61 +191,53 @@ public:
             //ConsoleLogger::print("NIC: Frame sent BROADCAST LOCAL.");
             return 0;
         } else {
-            _time_keeper->update_sync_status();
-
-            auto sync_state = _time_keeper->get_sync_state();
-            frame->attributes()->set_sync_state(sync_state);
-            frame->attributes()->set_packet_origin(_packet_origin);
             frame->attributes()->set_has_mac_keys(false);
+            return transmit(buf, prot, nullptr);
+        }
+    }
 
-            size_t payload_size = buf->size() - sizeof(Ethernet::Header) - sizeof(Ethernet::Attributes);
-
-            if (_packet_origin == Ethernet::Attributes::PacketOrigin::OTHERS) {
-                auto mac = _mac_handler->generate_mac(frame->data(), payload_size);
-                //ConsoleLogger::log("GENERATING MESSAGE MAC: " + std::to_string(mac) + " - PAYLOAD SIZE: " + std::to_string(payload_size) +  " - HASH: " + calcularHashDJB2(frame->data(), payload_size));
-                frame->attributes()->set_mac(mac);
-            }
-
-            frame->attributes()->set_quadrant(_quadrant);
-            
-            auto now = _time_keeper->get_system_timestamp();
-            frame->attributes()->set_timestamp(now);
-
-            if(_send_mac_key) {
-                int length  = sizeof(unsigned short) + Ethernet::MAC_BYTE_SIZE;
-                memcpy(frame->data(), &_unicast_addr, ETH_ALEN);
-                memcpy(frame->data()+ETH_ALEN, &_mac_key_data, 3*length);
-                frame->attributes()->set_has_mac_keys(true);
-                ConsoleLogger::log("SENDING MAC KEY");
-                
-                /*std::stringstream geek;
-                geek << std::hex;
-                for (int i = 0; i < 3*length; i++) {
-                    geek << static_cast<unsigned int>(frame->data()[i]) << " ";
-                }*/
-
-                //ConsoleLogger::log("HEADER + METADATA SIZE: " +  std::to_string(sizeof(Ethernet::Header) + sizeof(Ethernet::Metadata)));
-                buf->size(sizeof(Ethernet::Header) + sizeof(Ethernet::Attributes) + 3*length);
-                //ConsoleLogger::log("MAC KEYS SENT: " + geek.str());
-            }
-            
-            int result = Engine::raw_send(
-                frame->header()->h_dest, 
-                prot,
-                frame->attributes(),
-                frame->data(),
-                buf->size() - sizeof(Ethernet::Header) - sizeof(Ethernet::Attributes)
-            );
-
-            //ConsoleLogger::log("Result: " + std::to_string(result + sizeof(Ethernet::Header) + sizeof(Ethernet::Metadata)));
+    // RSU: one broadcast sync beacon. It carries the kernel send time of the
+    // previous beacon (two-step) and, when any are due, the MAC keys
+    int send_sync_beacon() {
+        unsigned int capacity = Ethernet::MTU - sizeof(Ethernet::Header) - sizeof(Ethernet::Attributes);
+        NICBuffer* buf = alloc(Ethernet::BROADCAST_MAC, Traits<NIC>::ETHERNET_PROTOCOL_NUMBER, capacity);
+        if (!buf) {
+            return -1;
+        }
+        Ethernet::Frame* frame = buf->frame();
 
-            _send_mac_key = false;
-            
-            free(buf);
+        Message::TypedMessage<Message::PTPMessage> beacon;
+        beacon.header.type = Message::PTP;
+        beacon.header.payload_size = sizeof(Message::PTPMessage);
+        beacon.payload.sequence = _beacon_sequence;
+        beacon.payload.interval_us = beacon_interval();
+        beacon.payload.follow_up = _beacon_follow_up;
+        beacon.payload.follow_up_sequence = _beacon_follow_up_sequence;
+        memcpy(frame->data(), &beacon, sizeof(beacon));
+        unsigned int length = sizeof(beacon);
+
+        frame->attributes()->set_has_mac_keys(false);
+        length += write_due_mac_keys(frame, frame->data() + length);
+        buf->size(sizeof(Ethernet::Header) + sizeof(Ethernet::Attributes) + length);
+
+        U64 tx_timestamp = 0;
+        int result = transmit(buf, Traits<NIC>::ETHERNET_PROTOCOL_NUMBER, &tx_timestamp);
+
+        // Follow-up in the RSU's system time; none if the kernel gave no send time
+        _beacon_follow_up = tx_timestamp > 0 ? tx_timestamp + (_time_keeper->get_system_timestamp() - _time_keeper->get_local_timestamp()) : 0;
+        _beacon_follow_up_sequence = _beacon_sequence;
+        _beacon_sequence++;
+        return result;
+    }
 
-            //ConsoleLogger::print("NIC: Frame sent BROADCAST EXTERNAL.");
-            return result;
-        }
+    // RSU: shortest interval any vehicle asked for lately, BEACON_MAX_US if none
+    uint32_t beacon_interval() {
+        U64 now = _time_keeper->get_local_timestamp();
+        std::lock_guard<std::mutex> lock(_beacon_mutex);
+        roll_beacon_requests(now);
+        uint32_t interval = std::min(_beacon_request[0], _beacon_request[1]);
+        if (interval < Traits<TimeKeeper>::BEACON_MIN_US) return Traits<TimeKeeper>::BEACON_MIN_US;
+        return interval;
     }
 
     void free(NICBuffer* buf) {
@@ -276,8 +252,21 @@ public:
         memcpy(src, frame->header()->h_source, ETH_ALEN);
     }
 
+    uint32_t current_key_epoch() {
+        return static_cast<uint32_t>(_time_keeper->get_system_timestamp() / static_cast<U64>(Traits<NIC>::MAC_KEY_EPOCH_US));
+    }
+
     void set_packet_origin(Ethernet::Attributes::PacketOrigin packet_origin) {
         _packet_origin = packet_origin;
+        _time_keeper->set_packet_origin(packet_origin);
+        if (packet_origin == Ethernet::Attributes::PacketOrigin::RSU && !Engine::enable_tx_timestamps()) {
+            LOG_INFO("NIC: Kernel TX timestamps unavailable, sync frames carry the user-space send time");
+        }
+    }
+
+    // Current estimate of the time between stamping a frame and the kernel sending it
+    U64 tx_latency() {
+        return _tx_latency.load(std::memory_order_relaxed);
     }
 
     unsigned short get_quadrant() {
@@ -286,22 +275,39 @@ public:
 
     void set_quadrant(unsigned int new_quadrant) {
         _quadrant = new_quadrant;
-        ConsoleLogger::log("NIC quadrant set to: " + std::to_string(_quadrant));
+        LOG_INFO("NIC quadrant set to: {}", _quadrant);
     }
 
     Address& address() {
         return _address;
     }
 
+    // Verified frames dropped as duplicates or behind the replay window
+    unsigned long replayed_frames() {
+        return _replayed_frames.load(std::memory_order_relaxed);
+    }
+
     using Observed::attach;
     using Observed::detach;
 
 private:
-    static void sigio_handler(int signum) {
-        sem_post(&_instance->_sem);
+    // Fills in the Ethernet header of a freshly allocated buffer
+    NICBuffer* prepare(NICBuffer* buf, const Address dst, Protocol_Number prot, unsigned int size) {
+        if (!buf) {
+            return nullptr;
+        }
+
+        buf->size(size + sizeof(Ethernet::Header) + sizeof(Ethernet::Attributes));
+        Ethernet::Frame* frame = buf->frame();
+        memcpy(frame->header()->h_dest, dst, ETH_ALEN);
+        memcpy(frame->header()->h_source, Engine::_addr, ETH_ALEN);
+        frame->header()->h_proto = htons(prot);
+
+        return buf;
     }
 
     void data_processing_thread() {
+        ThreadPlacement::Guard placement(ThreadPlacement::NIC_WORKER, "nic-worker");
         while (_running) {
             sem_wait(&_sem);
 
@@ -313,139 +319,405 @@ private:
         }
     }
 
+    // One frame drained from the socket, waiting for the rest of its burst
+    struct Received {
+        NICBuffer* buf;
+        int size;
+        Protocol_Number prot;
+        Attributes attributes;
+        U64 local_timestamp;
+    };
+
     void process_incoming_data() {
-        while (true) {
-            //ConsoleLogger::log("PROCESS INCOMING DATA");
-            Address src;
-            Protocol_Number prot;
-            Attributes attributes;
-            
+        Received burst[Traits<NIC>::RECEIVE_BURST];
 
-            // Get a free buffer
-            NICBuffer* buf = alloc(address(), 0, Ethernet::MTU - sizeof(Ethernet::Header) - sizeof(Ethernet::Attributes));
-            if (!buf) {
-                //ConsoleLogger::error("No buffers available for incoming data");
-                return;
-            }
-            
-            Ethernet::Frame* frame = buf->frame();
-            int size = Engine::raw_receive(&src, &prot, &attributes, frame->data(), 
-                                        Ethernet::MTU - sizeof(Ethernet::Header) - sizeof(Ethernet::Attributes));
-                
-            if (size > 0) {
-                // Successful read
-                auto t = _time_keeper->get_local_timestamp();
-                buf->size(size);
-
-                auto sender_quadrant = attributes.get_quadrant();
-                Address sender_address;
-                memcpy(&sender_address, frame->data(), 6);
-
-                // VERIFY IF THE RSU RECEIVED THE MESSAGE 
-                if(_packet_origin == Ethernet::Attributes::PacketOrigin::RSU) {
-                    if(_quadrant == sender_quadrant) {
-                        ConsoleLogger::log("RSU: Message with quadrant " + std::to_string(sender_quadrant) + " is in my quadrant " + std::to_string(_quadrant));
-                        if(!_vehicle_table.check_vehicle(&sender_address)) {
-                            ConsoleLogger::log("RSU: New vehicle found with address: " + mac_to_string(sender_address));
-                            std::array<unsigned char, ETH_ALEN> sender_address_array;
-                            memcpy(sender_address_array.data(), &sender_address, ETH_ALEN);
-                            _vehicle_table.set_vehicle(sender_address_array);
-                            _send_mac_key = true;
-                            memcpy(&_unicast_addr, &sender_address, ETH_ALEN);
-                        }
-                    }
+        while (true) {
+            unsigned int count = 0;
+            bool drained = false;
+
+            // Drain everything pending first; verification runs over the whole burst
+            while (count < Traits<NIC>::RECEIVE_BURST) {
+                // Never wait for a buffer while holding a burst: processing it frees buffers
+                unsigned int capacity = Ethernet::MTU - sizeof(Ethernet::Header) - sizeof(Ethernet::Attributes);
+                NICBuffer* buf = count > 0 ? try_alloc(address(), 0, capacity) : alloc(address(), 0, capacity);
+                if (!buf) {
+                    //ConsoleLogger::error("No buffers available for incoming data");
+                    break;
+                }
 
+                Received& received = burst[count];
+                Address src;
+                U64 kernel_timestamp = 0;
+                int size = Engine::raw_receive(&src, &received.prot, &received.attributes, buf->frame()->data(),
+                                               Ethernet::MTU - sizeof(Ethernet::Header) - sizeof(Ethernet::Attributes), &kernel_timestamp);
+
+                if (size > 0) {
+                    // The kernel stamp excludes the signal, semaphore and burst delays
+                    received.local_timestamp = kernel_timestamp > 0 ? kernel_timestamp : _time_keeper->get_local_timestamp();
+                    received.buf = buf;
+                    received.size = size;
+                    buf->size(size);
+                    count++;
+                } else if (size == 0 || (size < 0 && errno == EAGAIN)) {
+                    // No more data available
                     free(buf);
-                // VERIFY IF THE VEHICLE RECEIVED THE MESSAGE
+                    drained = true;
+                    break;
                 } else {
-                    if (attributes.get_packet_origin() == Ethernet::Attributes::PacketOrigin::RSU && sender_quadrant == _quadrant) {
-                        ConsoleLogger::log("Received RSU message");
-                        auto system_timestamp = attributes.get_timestamp();
-                        _time_keeper->update_time_keeper(system_timestamp, t);    
-                        
-                        if (attributes.get_has_mac_keys()) {
-                            Address dest;
-                            memcpy(&dest, frame->data(), ETH_ALEN);
-                            if (memcmp(dest, _address, ETH_ALEN)){                                 
-                                ConsoleLogger::log("Received RSU message has MAC keys");
-                                // FRAME -> FRAME HEADER + METADATA + (DATA) -> [(id1+CHAVE1) + (id2+CHAVE2) + (id3+CHAVE3)]
-                                int length = sizeof(unsigned short) + Ethernet::MAC_BYTE_SIZE;      
-                                
-                                for(int i = 0; i < 3; i++) {
-                                    unsigned short quadrant;
-                                    Ethernet::MAC_KEY key;
-                                    memcpy(&quadrant, frame->data()+(i*length)+ETH_ALEN, sizeof(unsigned short));
-                                    memcpy(key.data(), frame->data()+(i*length)+sizeof(unsigned short)+ETH_ALEN, Ethernet::MAC_BYTE_SIZE);
-                                    
-                                    _mac_key_cache->put(quadrant, key);
-                                }
-                                _mac_handler->set_mac_key(_mac_key_cache->get(_quadrant));
-                                for(int i = 0; i < 4; i++) {
-                                    auto key_2 = _mac_key_cache->get(i+1);
-                                    if(key_2) {
-                                        std::stringstream geek;
-                                        geek << std::hex;
-                                        for (size_t i = 0; i < Ethernet::MAC_BYTE_SIZE; i++) {
-                                            geek << static_cast<unsigned int>(key_2->data()[i]) << " ";
-                                        }
-                                        
-                                        ConsoleLogger::log("MAC KEY ACCESSED [" + std::to_string(i+1) + "]: " + geek.str());
-                                    }
-                                }
+                    // Error
+                    free(buf);
+                    perror("Error reading from socket");
+                    drained = true;
+                    break;
+                }
+            }
+
+            if (count > 0) {
+                process_burst(burst, count);
+            }
+            if (drained || count == 0) {
+                break;
+            }
+        }
+    }
+
+    void process_burst(Received* burst, unsigned int count) {
+        MACHandler::Frame frames[Traits<NIC>::RECEIVE_BURST];
+        unsigned int pending[Traits<NIC>::RECEIVE_BURST];
+        unsigned int verified = 0;
+
+        for (unsigned int i = 0; i < count; i++) {
+            Received& received = burst[i];
+            Ethernet::Frame* frame = received.buf->frame();
+            Attributes& attributes = received.attributes;
+
+            auto sender_quadrant = attributes.get_quadrant();
+            Address sender_address;
+            memcpy(&sender_address, frame->data(), 6);
+
+            // VERIFY IF THE RSU RECEIVED THE MESSAGE 
+            if(_packet_origin == Ethernet::Attributes::PacketOrigin::RSU) {
+                if(_quadrant == sender_quadrant) {
+                    LOG_TRACE("RSU: Message with quadrant {} is in my quadrant {}", sender_quadrant, _quadrant);
+                    note_beacon_request(attributes.get_beacon_interval(), received.local_timestamp);
+                    if(!_vehicle_table.check_vehicle(&sender_address, received.local_timestamp)) {
+                        LOG_INFO("RSU: New vehicle found with address: {}", mac_to_string(sender_address));
+                        _vehicle_table.set_vehicle(&sender_address, received.local_timestamp);
+                        if (!attributes.get_has_mac_keys()) {
+                            std::lock_guard<std::mutex> lock(_key_distribution_mutex);
+                            if (!_key_distribution.enqueue(sender_address, received.local_timestamp)) {
+                                LOG_WARNING("RSU: Key distribution queue full, {} waits for the next epoch", mac_to_string(sender_address));
                             }
                         }
-                        free(buf);
-                    } else if (attributes.get_packet_origin() == Ethernet::Attributes::PacketOrigin::OTHERS) {
-                        Ethernet::MAC_KEY* mac_key = _mac_key_cache->get(sender_quadrant);
-                        ConsoleLogger::log("Vehicle received message from other vehicle");
-                        if(mac_key) {
-                            ConsoleLogger::log("Received Vehicle message with known MAC -> from = " + std::to_string(sender_quadrant) + "; to = " + std::to_string(_quadrant));
-                            size_t payload_size = size;
-                            ConsoleLogger::log("RECEIVING MESSAGE MAC:" + std::to_string(attributes.get_mac()) + " | Payload size: " + std::to_string(payload_size) + " | HASH: " + calcularHashDJB2(frame->data(), size));
-                            if(_mac_handler->verify_mac(frame->data(), payload_size, attributes.get_mac())) {
-                                ConsoleLogger::log("MAC verification successful");
-                                
-                                _attribute_map_id++;
-                                Ethernet::MessageInfo message_info;
-                                memcpy(&message_info.origin_mac, sender_address, ETH_ALEN);
-                                memcpy(&message_info.origin_id, frame->data() + 6, 2);
-                                message_info.quadrant = attributes.get_quadrant();
-                                message_info.timestamp = attributes.get_timestamp();
-                                message_info.mac = attributes.get_mac();
-                                {
-                                    std::lock_guard<std::mutex> lock(_attribute_map_mutex);
-                                    _attribute_map[_attribute_map_id] = message_info;
-                                }
-
-                                if (!notify(prot, _attribute_map_id.load(),buf)) {
-                                    _attribute_map.erase(_attribute_map_id);
-                                    free(buf);
-                                }
-                            } else {
-                                free(buf);
-                            }
-                        } else {
-                            ConsoleLogger::log("Received Vehicle message but with unknown MAC -> from = " + std::to_string(sender_quadrant) + "; to = " + std::to_string(_quadrant));
-                            free(buf);
+                    } else if (attributes.get_has_mac_keys()) {
+                        std::lock_guard<std::mutex> lock(_key_distribution_mutex);
+                        if (_key_distribution.pending() > 0 && _key_distribution.confirm(sender_address)) {
+                            LOG_DEBUG("RSU: Vehicle {} confirmed its MAC keys", mac_to_string(sender_address));
                         }
-                    } else {
-                        free(buf);
                     }
                 }
-            } else if (size == 0 || (size < 0 && errno == EAGAIN)) {
-                // No more data available
-                free(buf);
-                break;
+
+                free(received.buf);
+            // VERIFY IF THE VEHICLE RECEIVED THE MESSAGE
+            } else if (attributes.get_packet_origin() == Ethernet::Attributes::PacketOrigin::RSU && sender_quadrant == _quadrant) {
+                // Sync beacons go straight to the TimeKeeper, never to the observers
+                Message::TypedMessage<Message::PTPMessage> beacon;
+                if (received.size >= static_cast<int>(sizeof(beacon))) {
+                    memcpy(&beacon, frame->data(), sizeof(beacon));
+                }
+                if (received.size >= static_cast<int>(sizeof(beacon)) && beacon.header.type == Message::PTP) {
+                    LOG_TRACE("Received RSU beacon {}", beacon.payload.sequence);
+                    _time_keeper->update_sync_beacon(beacon.payload.sequence, attributes.get_timestamp(), beacon.payload.follow_up,
+                                                     beacon.payload.follow_up_sequence, received.local_timestamp);
+
+                    if (attributes.get_has_mac_keys()) {
+                        store_mac_keys(frame->data() + sizeof(beacon), received.size - sizeof(beacon));
+                    }
+                }
+                free(received.buf);
+            } else if (attributes.get_packet_origin() == Ethernet::Attributes::PacketOrigin::OTHERS) {
+                // Vehicle frames are authenticated with the sender quadrant's key of the epoch they name
+                MACHandler::Frame& entry = frames[verified];
+                if(_mac_keys.find(sender_quadrant, attributes.get_key_epoch(), entry.key)) {
+                    LOG_TRACE("RECEIVING MESSAGE MAC: {} | from = {}; to = {} | epoch {} | Payload size: {}", attributes.get_mac(), sender_quadrant, _quadrant, attributes.get_key_epoch(), received.size);
+                    entry.data = frame->data();
+                    entry.length = received.size;
+                    entry.sequence = attributes.get_sequence();
+                    entry.epoch = attributes.get_key_epoch();
+                    entry.mac = attributes.get_mac();
+                    entry.valid = false;
+                    pending[verified++] = i;
+                } else {
+                    LOG_DEBUG("Received Vehicle message but with unknown MAC -> from = {}; to = {}; epoch {}", sender_quadrant, _quadrant, attributes.get_key_epoch());
+                    free(received.buf);
+                }
             } else {
-                // Error
-                free(buf);
-                perror("Error reading from socket");
-                break;
+                free(received.buf);
             }
         }
+
+        if (verified == 0) {
+            return;
+        }
+
+        size_t valid = _mac_handler->verify_batch(frames, verified);
+        LOG_TRACE("MAC verification: {} of {} frames valid", valid, verified);
+
+        // Replays are only judged after authentication; the tag covers the
+        // sequence, so a forged sequence cannot move a sender's window. That
+        // holds for the keyed algorithms (SIPHASH_2_4, NH_UNIVERSAL): XOR_FOLD
+        // is a checksum under a key and is forgeable, window included
+        for (unsigned int k = 0; k < verified; k++) {
+            if (!frames[k].valid) continue;
+
+            Received& received = burst[pending[k]];
+            if (!_replay_window.accept(received.buf->frame()->data(), received.attributes.get_sequence())) {
+                frames[k].valid = false;
+                _replayed_frames.fetch_add(1, std::memory_order_relaxed);
+                LOG_DEBUG("NIC: Dropping replayed frame {} ({} dropped so far)", received.attributes.get_sequence(), _replayed_frames.load());
+            }
+        }
+
+        // Failures are released in one pass, the rest registered under a single lock
+        unsigned int ids[Traits<NIC>::RECEIVE_BURST];
+        {
+            std::lock_guard<std::mutex> lock(_attribute_map_mutex);
+            for (unsigned int k = 0; k < verified; k++) {
+                Received& received = burst[pending[k]];
+                if (!frames[k].valid) {
+                    free(received.buf);
+                    continue;
+                }
+
+                Ethernet::MessageInfo message_info;
+                memcpy(&message_info.origin_mac, received.buf->frame()->data(), ETH_ALEN);
+                memcpy(&message_info.origin_id, received.buf->frame()->data() + 6, 2);
+                message_info.quadrant = received.attributes.get_quadrant();
+                message_info.timestamp = received.attributes.get_timestamp();
+                message_info.mac = received.attributes.get_mac();
+
+                ids[k] = ++_attribute_map_id;
+                _attribute_map[ids[k]] = message_info;
+            }
+        }
+
+        for (unsigned int k = 0; k < verified; k++) {
+            if (!frames[k].valid) continue;
+
+            Received& received = burst[pending[k]];
+            if (!notify(received.prot, ids[k], received.buf)) {
+                {
+                    std::lock_guard<std::mutex> lock(_attribute_map_mutex);
+                    _attribute_map.erase(ids[k]);
+                }
+                free(received.buf);
+            }
+        }
+    }
+
+    // FRAME -> FRAME HEADER + METADATA + (DATA) -> [COUNT + COUNT x DEST + EPOCH + 3 x (QUADRANT + KEY(EPOCH) + KEY(EPOCH+1))]
+    unsigned int write_mac_key_data(unsigned char* data, const Address* dests, unsigned int count, uint32_t epoch) {
+        unsigned char* ptr = data;
+        *ptr++ = static_cast<unsigned char>(count);
+        for (unsigned int i = 0; i < count; i++) {
+            memcpy(ptr, dests[i], ETH_ALEN);
+            ptr += ETH_ALEN;
+        }
+        memcpy(ptr, &epoch, sizeof(epoch));
+        ptr += sizeof(epoch);
+
+        for (unsigned int i = 0; i < MAC_KEY_QUADRANTS; i++) {
+            Ethernet::MAC_KEY current = MACHandler::derive_epoch_key(_base_keys[i].key, epoch);
+            Ethernet::MAC_KEY next = MACHandler::derive_epoch_key(_base_keys[i].key, epoch + 1);
+            memcpy(ptr, &_base_keys[i].quadrant, sizeof(unsigned short));
+            ptr += sizeof(unsigned short);
+            memcpy(ptr, current.data(), Ethernet::MAC_BYTE_SIZE);
+            ptr += Ethernet::MAC_BYTE_SIZE;
+            memcpy(ptr, next.data(), Ethernet::MAC_BYTE_SIZE);
+            ptr += Ethernet::MAC_BYTE_SIZE;
+        }
+        return ptr - data;
+    }
+
+    // `data` comes from an unauthenticated frame: nothing is read past `available`
+    void store_mac_keys(const unsigned char* data, size_t available) {
+        const unsigned char* ptr = data;
+        if (available < 1) {
+            return;
+        }
+        unsigned int count = *ptr++;
+        if (count == 0 || count > Traits<NIC>::KEY_DISTRIBUTION_BATCH ||
+            1 + count * ETH_ALEN + sizeof(uint32_t) + MAC_KEY_QUADRANTS * (sizeof(unsigned short) + 2 * Ethernet::MAC_BYTE_SIZE) > available) {
+            LOG_WARNING("NIC: Malformed MAC key data ({} destinations in {} bytes)", count, available);
+            return;
+        }
+        bool addressed = false;
+        for (unsigned int i = 0; i < count && !addressed; i++) {
+            const unsigned char* dest = ptr + i * ETH_ALEN;
+            addressed = memcmp(dest, _address, ETH_ALEN) == 0 || Ethernet::is_broadcast(const_cast<unsigned char*>(dest));
+        }
+        if (!addressed) {
+            return;
+        }
+        ptr += count * ETH_ALEN;
+
+        uint32_t epoch;
+        memcpy(&epoch, ptr, sizeof(epoch));
+        ptr += sizeof(epoch);
+        LOG_DEBUG("Received RSU message has MAC keys for epoch {}", epoch);
+
+        for (unsigned int i = 0; i < MAC_KEY_QUADRANTS; i++) {
+            unsigned short quadrant;
+            Ethernet::MAC_KEY current;
+            Ethernet::MAC_KEY next;
+            memcpy(&quadrant, ptr, sizeof(unsigned short));
+            ptr += sizeof(unsigned short);
+            memcpy(current.data(), ptr, Ethernet::MAC_BYTE_SIZE);
+            ptr += Ethernet::MAC_BYTE_SIZE;
+            memcpy(next.data(), ptr, Ethernet::MAC_BYTE_SIZE);
+            ptr += Ethernet::MAC_BYTE_SIZE;
+
+            _mac_keys.publish(quadrant, epoch, current, next);
+        }
+    }
+
+    // Stamps, signs and sends an external frame, then frees it. `tx_timestamp`
+    // receives the kernel send time when the engine reports one
+    int transmit(NICBuffer* buf, Protocol_Number prot, U64* tx_timestamp) {
+        Ethernet::Frame* frame = buf->frame();
+        _time_keeper->update_sync_status();
+
+        auto sync_state = _time_keeper->get_sync_state();
+        frame->attributes()->set_sync_state(sync_state);
+        frame->attributes()->set_packet_origin(_packet_origin);
+        frame->attributes()->set_sequence(_sequence++);
+        frame->attributes()->set_beacon_interval(0);
+
+        size_t payload_size = buf->size() - sizeof(Ethernet::Header) - sizeof(Ethernet::Attributes);
+
+        if (_packet_origin == Ethernet::Attributes::PacketOrigin::OTHERS) {
+            // Signed with the newest key of our quadrant that is not ahead of the clock
+            uint32_t key_epoch = 0;
+            Ethernet::MAC_KEY key;
+            Ethernet::MAC mac = 0;
+            if (_mac_keys.latest(_quadrant, current_key_epoch(), key_epoch, key)) {
+                mac = sign(key, frame->attributes()->get_sequence(), key_epoch, frame->data(), payload_size);
+                // Tells the RSU our keys arrived
+                frame->attributes()->set_has_mac_keys(true);
+            }
+            //ConsoleLogger::log("GENERATING MESSAGE MAC: " + std::to_string(mac) + " - PAYLOAD SIZE: " + std::to_string(payload_size) +  " - HASH: " + calcularHashDJB2(frame->data(), payload_size));
+            frame->attributes()->set_mac(mac);
+            frame->attributes()->set_key_epoch(key_epoch);
+            frame->attributes()->set_beacon_interval(_time_keeper->wanted_beacon_interval());
+        }
+
+        frame->attributes()->set_quadrant(_quadrant);
+
+        // Stamped as late as possible; the RSU adds the measured stamp-to-wire latency
+        U64 stamped_local = _time_keeper->get_local_timestamp();
+        auto now = _time_keeper->get_system_timestamp();
+        bool rsu = _packet_origin == Ethernet::Attributes::PacketOrigin::RSU;
+        if (rsu) {
+            now += _tx_latency.load(std::memory_order_relaxed);
+        }
+        frame->attributes()->set_timestamp(now);
+
+        U64 sent_at = 0;
+        int result = Engine::raw_send(
+            frame->header()->h_dest, 
+            prot,
+            frame->attributes(),
+            frame->data(),
+            buf->size() - sizeof(Ethernet::Header) - sizeof(Ethernet::Attributes),
+            rsu ? &sent_at : nullptr
+        );
+        if (sent_at > 0) {
+            update_tx_latency(sent_at - stamped_local);
+        }
+        if (tx_timestamp) {
+            *tx_timestamp = sent_at;
+        }
+
+        //ConsoleLogger::log("Result: " + std::to_string(result + sizeof(Ethernet::Header) + sizeof(Ethernet::Metadata)));
+        
+        free(buf);
+
+        //ConsoleLogger::print("NIC: Frame sent BROADCAST EXTERNAL.");
+        return result;
+    }
+
+    // A new epoch is announced to the whole quadrant; otherwise the beacon carries
+    // the keys to a batch of vehicles that are due in the distribution queue
+    unsigned int write_due_mac_keys(Ethernet::Frame* frame, unsigned char* data) {
+        if (!_has_base_keys) {
+            return 0;
+        }
+        uint32_t epoch = current_key_epoch();
+        unsigned int destinations = 0;
+        Address dests[Traits<NIC>::KEY_DISTRIBUTION_BATCH];
+        if (epoch != _announced_epoch) {
+            memcpy(dests[0], Ethernet::BROADCAST_MAC, ETH_ALEN);
+            destinations = 1;
+        } else {
+            std::lock_guard<std::mutex> lock(_key_distribution_mutex);
+            if (_key_distribution.pending() > 0) {
+                destinations = _key_distribution.collect(_time_keeper->get_local_timestamp(), dests, Traits<NIC>::KEY_DISTRIBUTION_BATCH);
+            }
+        }
+        if (destinations == 0) {
+            return 0;
+        }
+
+        frame->attributes()->set_has_mac_keys(true);
+        LOG_DEBUG("NIC: Sending MAC keys of epoch {} to {} vehicle(s)", epoch, destinations);
+        _announced_epoch = epoch;
+        return write_mac_key_data(data, dests, destinations, epoch);
+    }
+
+    // Keeps the minimum over the current and the previous request period
+    void note_beacon_request(uint32_t interval, U64 now) {
+        if (interval == 0) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(_beacon_mutex);
+        roll_beacon_requests(now);
+        _beacon_request[1] = std::min(_beacon_request[1], interval);
+    }
+
+    // Caller holds _beacon_mutex
+    void roll_beacon_requests(U64 now) {
+        if (now - _beacon_request_start < static_cast<U64>(Traits<TimeKeeper>::BEACON_REQUEST_TTL_US)) {
+            return;
+        }
+        bool skipped = now - _beacon_request_start >= 2 * static_cast<U64>(Traits<TimeKeeper>::BEACON_REQUEST_TTL_US);
+        _beacon_request[0] = skipped ? Traits<TimeKeeper>::BEACON_MAX_US : _beacon_request[1];
+        _beacon_request[1] = Traits<TimeKeeper>::BEACON_MAX_US;
+        _beacon_request_start = now;
+    }
+
+    // Smoothed like TCP's SRTT (gain 1/8); samples from a delayed stamp are ignored
+    void update_tx_latency(U64 sample) {
+        if (sample < 0 || sample > static_cast<U64>(Traits<NIC>::TX_LATENCY_MAX_US)) {
+            return;
+        }
+        U64 latency = _tx_latency.load(std::memory_order_relaxed);
+        _tx_latency.store(latency == 0 ? sample : latency + (sample - latency) / 8, std::memory_order_relaxed);
+    }
+
+    // Each sending thread keeps its own keyed context, rebuilt when the epoch key changes
+    static Ethernet::MAC sign(const Ethernet::MAC_KEY& key, uint32_t sequence, uint32_t epoch, const unsigned char* data, size_t size) {
+        static thread_local MACHandler signer;
+        if (!signer.has_mac_key(key)) {
+            Ethernet::MAC_KEY copy = key;
+            signer.set_mac_key(&copy);
+        }
+        return signer.generate_mac(sequence, epoch, data, size);
     }
 
     void cleanup_nic() {
+        if (!_running) {
+            return;
+        }
         _running = false;
         sem_post(&_sem);
         //_data_semaphore.v();  
@@ -454,6 +726,7 @@ private:
         if (_worker_thread.joinable()) {
             _worker_thread.join();
         }
+        Engine::notify(nullptr);
     }
 
     std::string mac_to_string(Address& addr) {
@@ -489,7 +762,6 @@ private:
     std::thread _worker_thread;
     TimeKeeper* _time_keeper;
     MACHandler* _mac_handler;
-    bool _send_mac_key;
     unsigned int _quadrant;
     Ethernet::Attributes::PacketOrigin _packet_origin;
     
@@ -497,12 +769,32 @@ private:
     std::unordered_map<unsigned int, Ethernet::MessageInfo> _attribute_map;
     std::mutex _attribute_map_mutex;
     VehicleTable _vehicle_table;
-    Address _unicast_addr;
-    LRU_Cache<unsigned short, Ethernet::MAC_KEY>* _mac_key_cache;
-    unsigned char _mac_key_data[3 * (Ethernet::MAC_BYTE_SIZE + sizeof(unsigned short))];
+    // Vehicle: current keys of each quadrant, indexed by quadrant number
+    MACKeyTable<Traits<NIC>::NUM_RSU> _mac_keys;
+    // RSU: base keys the epoch keys are derived from
+    struct QuadrantKey {
+        unsigned short quadrant;
+        Ethernet::MAC_KEY key;
+    };
+    static const unsigned int MAC_KEY_QUADRANTS = 3;
+    QuadrantKey _base_keys[MAC_KEY_QUADRANTS];
+    bool _has_base_keys;
+    uint32_t _announced_epoch;
+    std::atomic<uint32_t> _sequence;
+    ReplayWindow<Traits<NIC>::REPLAY_SENDERS> _replay_window;
+    std::atomic<unsigned long> _replayed_frames;
+    // RSU: vehicles still waiting for the keys
+    KeyDistribution<Traits<NIC>::KEY_DISTRIBUTION_VEHICLES> _key_distribution;
+    std::mutex _key_distribution_mutex;
+    // RSU: stamp-to-wire latency from kernel TX timestamps
+    std::atomic<U64> _tx_latency;
+    // RSU: sync beacons
+    uint32_t _beacon_sequence;
+    U64 _beacon_follow_up;
+    uint32_t _beacon_follow_up_sequence;
+    std::mutex _beacon_mutex;
+    uint32_t _beacon_request[2];
+    U64 _beacon_request_start;
 };
 
-template <typename Engine>
-NIC<Engine>* NIC<Engine>::_instance = nullptr;
-
 #endif // NIC_H
\ No newline at end of file
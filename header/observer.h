@@ -137,9 +137,10 @@ public:
     Concurrent_Observer(): _semaphore(0) {
         //ConsoleLogger::print("Concurrent_Observer: Initializing instance.");
     }
-    ~Concurrent_Observer() {}
+    virtual ~Concurrent_Observer() {}
     
-    void update(C c, unsigned int id, D * d) {
+    // Queues the data for updated(); observers that consume on the notifying thread override it
+    virtual void update(C c, unsigned int id, D * d) {
         std::pair<unsigned int, D*>* pair = new std::pair<unsigned int, D*>(id, d);
         _data.insert(pair);
         _semaphore.v();
@@ -12,11 +12,63 @@
 #include <linux/types.h>
 #include <sys/syscall.h>
 #include <pthread.h>
+#include <sched.h>
+#include <errno.h>
 #include <atomic>
+#include <string>
+#include <ostream>
 
 #include "sched_utils.h"
+#include "traits.h"
+#include "latency_histogram.h"
+#include "thread_placement.h"
+#include "simulator.h"
+#include "console_logger.h"
 
+// Runs a task once per period.
+// DEADLINE asks the kernel for SCHED_DEADLINE (runtime/period reservation).
+// TIMER sleeps to absolute CLOCK_MONOTONIC deadlines with clock_nanosleep,
+// optionally under SCHED_FIFO and pinned to one CPU; it works without
+// CAP_SYS_NICE (containers) and when deadline admission control is full.
+// AUTO tries DEADLINE and falls back to TIMER; it goes straight to TIMER
+// when the thread placement plan pins its role to some CPUs.
+// Every activation records its jitter (how late it ran compared to the start
+// of its period) and execution time, so both modes can be compared and the
+// runtime budgets tuned. Live threads are registered under an owner label and
+// can all be dumped with dump_all(); each one logs a summary when destroyed.
+// With an adaptive runtime the budget follows the measured CPU time of the
+// task (a high percentile plus margin over the last activations) instead of
+// the guess given at construction, and all adaptive threads together stay
+// under an agent-wide utilization cap so admission control keeps room for
+// more components.
+// While the Simulator is active no thread is created: start() schedules the
+// activations as simulator events (SIMULATED mode), in virtual time.
 class PeriodicThread {
+public:
+    enum Mode {
+        AUTO,
+        DEADLINE,
+        TIMER,
+        SIMULATED
+    };
+
+    struct Stats {
+        std::string label;
+        Mode mode;                        // What the thread actually runs as
+        __u64 period_us;
+        __u64 runtime_us;
+        LatencyHistogram::Snapshot jitter;
+        LatencyHistogram::Snapshot execution;
+        unsigned long budget_overruns;    // Executions longer than the runtime budget
+        unsigned long deadline_misses;    // Executions that ended after their period
+        unsigned long skipped;            // TIMER: periods skipped after a late execution
+        unsigned long kernel_overruns;    // DEADLINE: SIGXCPU from SCHED_FLAG_DL_OVERRUN
+        bool adaptive;
+        unsigned long adaptations;        // Runtime budget changes
+    };
+
+    static const unsigned int ADAPT_WINDOW = Traits<PeriodicThread>::ADAPT_WINDOW;
+
 private:
     pthread_t thread;
     std::atomic<bool> running;
@@ -25,13 +77,113 @@ private:
 
     std::function<void ()> task_func;
 
+    Mode mode;
+    std::atomic<int> active_mode;
+    int fifo_priority;   // 0: keep the default policy (TIMER only)
+    int cpu;             // -1: no affinity (TIMER only; DEADLINE needs the whole root domain)
+    ThreadPlacement::Role role;
+
+    std::string label;
+    LatencyHistogram jitter;
+    LatencyHistogram execution;
+    std::atomic<unsigned long> budget_overruns;
+    std::atomic<unsigned long> deadline_misses;
+    std::atomic<unsigned long> skipped;
+    std::atomic<unsigned long> kernel_overruns;
+
+    bool adaptive;
+    std::atomic<unsigned long> adaptations;
+    // CPU time of the last activations (thread only)
+    __u64 cpu_samples[ADAPT_WINDOW];
+    unsigned int cpu_sample_count;
+
+    // SIMULATED: pending activation and its release in virtual time
+    Simulator::Id simulated_event;
+    __u64 simulated_release_us;
+
+    static __u64 now_ns() {
+        return clock_ns(CLOCK_MONOTONIC);
+    }
+
+    static __u64 clock_ns(clockid_t clock) {
+        struct timespec ts;
+        clock_gettime(clock, &ts);
+        return static_cast<__u64>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+    }
+
+    // One activation: released at `release`, must be done by `deadline`
+    void activate(__u64 release, __u64 deadline) {
+        __u64 start = now_ns();
+        __u64 cpu_start = adaptive ? clock_ns(CLOCK_THREAD_CPUTIME_ID) : 0;
+        jitter.record(start > release ? start - release : 0);
+        task_func();
+        __u64 end = now_ns();
+
+        // The kernel charges CPU time against the budget, not wall time. A
+        // throttled task may take many periods per activation, so an
+        // activation over budget resizes at once instead of waiting for the window
+        if (adaptive) {
+            __u64 cpu = clock_ns(CLOCK_THREAD_CPUTIME_ID) - cpu_start;
+            cpu_samples[cpu_sample_count++] = cpu;
+            if (cpu_sample_count == ADAPT_WINDOW || cpu > runtime_ns.load(std::memory_order_relaxed)) {
+                adapt_runtime(cpu_sample_count);
+                cpu_sample_count = 0;
+            }
+        }
+
+        execution.record(end - start);
+        if (end - start > runtime_ns.load(std::memory_order_relaxed)) {
+            budget_overruns++;
+        }
+        if (end > deadline) {
+            deadline_misses++;
+        }
+    }
+
+    // Registry of live threads (source/period_thread.cpp)
+    static void register_thread(PeriodicThread* thread);
+    static void unregister_thread(PeriodicThread* thread);
+    // Routes SIGXCPU of the calling thread to `counter`
+    static void count_kernel_overruns(std::atomic<unsigned long>* counter);
+    // Largest runtime up to `wanted` that keeps the adaptive threads under the cap
+    __u64 grant_runtime(__u64 wanted, __u64 period) const;
+    // Resizes runtime_ns from the first `count` CPU time samples
+    void adapt_runtime(unsigned int count);
+
+    // SIMULATED: one activation, then the next one is scheduled
+    void start_simulated();
+    void simulated_activation();
+
+    // Thread label for logs and placement
+    const char* name() const { return label.empty() ? "periodic" : label.c_str(); }
+
     static void* threadFunction(void* arg) {
         PeriodicThread* self = static_cast<PeriodicThread*>(arg);
+        ThreadPlacement::Guard placement(self->role, self->name());
         self->executeThread();
         return NULL;
     }
     
     void executeThread() {
+        // SCHED_DEADLINE refuses threads pinned to part of the root domain
+        if (mode == AUTO && ThreadPlacement::restricted(role)) {
+            runTimer();
+            return;
+        }
+        if (mode != TIMER) {
+            if (runDeadline()) {
+                return;
+            }
+            if (mode == DEADLINE) {
+                return;
+            }
+            LOG_WARNING("PeriodicThread {}: SCHED_DEADLINE unavailable, falling back to timer mode", name());
+        }
+        runTimer();
+    }
+
+    // False if SCHED_DEADLINE could not be set
+    bool runDeadline() {
         struct VehicleSched::sched_attr attr;
         int ret;
         unsigned int flags = 0;
@@ -40,43 +192,134 @@ private:
         
         // Set scheduler attributes
         attr.size = sizeof(attr);
-        attr.sched_flags = 0;
+        attr.sched_flags = SCHED_FLAG_DL_OVERRUN;
         attr.sched_nice = 0;
         attr.sched_priority = 0;
         attr.sched_policy = SCHED_DEADLINE;
-        attr.sched_runtime = runtime_ns.load();
         attr.sched_period = attr.sched_deadline = period_ns.load();
+        if (adaptive) {
+            runtime_ns.store(grant_runtime(runtime_ns.load(), attr.sched_period));
+        }
+        attr.sched_runtime = runtime_ns.load();
         
+        // Budget overruns are signalled with SIGXCPU; kernels before 4.16 do
+        // not know the flag, so retry without it
+        count_kernel_overruns(&kernel_overruns);
         ret = VehicleSched::sched_setattr(0, &attr, flags);
+        if (ret < 0 && errno == EINVAL) {
+            attr.sched_flags = 0;
+            ret = VehicleSched::sched_setattr(0, &attr, flags);
+        }
         if (ret < 0) {
-            perror("sched_setattr");
-            return;
+            LOG_WARNING("PeriodicThread {}: sched_setattr: {}", name(), strerror(errno));
+            count_kernel_overruns(nullptr);
+            return false;
         }
+        active_mode.store(DEADLINE);
+
+        // The kernel replenishes the budget at the start of each period; the
+        // jitter is measured against that grid
+        __u64 period_start = now_ns();
+        // Last reservation the kernel refused; not retried until it changes
+        __u64 refused_period = 0;
+        __u64 refused_runtime = 0;
         
         // Execute the task periodically
         while (running.load()) {
+            __u64 now = now_ns();
+            __u64 period = attr.sched_period;
+            if (now >= period_start + period) {
+                period_start += (now - period_start) / period * period;
+            }
+
             // Execute the provided function
-            task_func();
+            activate(period_start, period_start + attr.sched_deadline);
             sched_yield();
+            period_start += period;
             
-            // Check if period has been updated
+            // Check if period or runtime have been updated
             __u64 current_period = period_ns.load();
-            if (current_period != attr.sched_period) {
+            __u64 current_runtime = runtime_ns.load();
+            bool changed = current_period != attr.sched_period || current_runtime != attr.sched_runtime;
+            if (changed && (current_period != refused_period || current_runtime != refused_runtime)) {
+                struct VehicleSched::sched_attr previous = attr;
                 attr.sched_period = attr.sched_deadline = current_period;
+                attr.sched_runtime = current_runtime;
                 ret = VehicleSched::sched_setattr(0, &attr, flags);
                 if (ret < 0) {
-                    perror("sched_setattr(update)");
+                    LOG_WARNING("PeriodicThread {}: sched_setattr(update) to period {} ns, runtime {} ns: {}", name(),
+                                current_period, current_runtime, strerror(errno));
+                    // The kernel keeps the old reservation, and so do the jitter
+                    // grid and the published budget; the refused request is
+                    // retried only once period or runtime change again
+                    attr = previous;
+                    runtime_ns.store(previous.sched_runtime);
+                    refused_period = current_period;
+                    refused_runtime = previous.sched_runtime;
                 }
             }
         }
         
         //printf("Periodic thread dies [%ld]\n", gettid());
+        count_kernel_overruns(nullptr);
+        return true;
+    }
+
+    void runTimer() {
+        if (fifo_priority > 0) {
+            struct sched_param param;
+            param.sched_priority = fifo_priority;
+            int ret = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+            if (ret != 0) {
+                LOG_WARNING("PeriodicThread {}: pthread_setschedparam(SCHED_FIFO): {}", name(), strerror(ret));
+            }
+        }
+        if (cpu >= 0) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu, &set);
+            int ret = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+            if (ret != 0) {
+                LOG_WARNING("PeriodicThread {}: pthread_setaffinity_np: {}", name(), strerror(ret));
+            }
+        }
+        active_mode.store(TIMER);
+
+        __u64 next = now_ns();
+        while (running.load()) {
+            struct timespec deadline;
+            deadline.tv_sec = next / 1000000000ULL;
+            deadline.tv_nsec = next % 1000000000ULL;
+            while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR) {}
+            if (!running.load()) {
+                break;
+            }
+
+            __u64 period = period_ns.load();
+            activate(next, next + period);
+
+            // Absolute deadlines do not accumulate drift; periods the task
+            // overran are skipped instead of fired back to back
+            next += period;
+            __u64 now = now_ns();
+            if (now >= next) {
+                __u64 missed = (now - next) / period + 1;
+                skipped += missed;
+                next += missed * period;
+            }
+        }
     }
     
 public:
     // Constructor
-    PeriodicThread(std::function<void ()> function, __u64 period_microseconds, __u64 runtime_microseconds = 400 * 1000) 
-        : running(false), task_func(function) {
+    PeriodicThread(std::function<void ()> function, __u64 period_microseconds, __u64 runtime_microseconds = 400 * 1000,
+                   Mode mode = static_cast<Mode>(Traits<PeriodicThread>::MODE))
+        : running(false), task_func(function), mode(mode), active_mode(mode),
+          fifo_priority(Traits<PeriodicThread>::FIFO_PRIORITY), cpu(Traits<PeriodicThread>::CPU),
+          role(ThreadPlacement::PERIODIC),
+          budget_overruns(0), deadline_misses(0), skipped(0), kernel_overruns(0),
+          adaptive(Traits<PeriodicThread>::ADAPTIVE_RUNTIME), adaptations(0), cpu_sample_count(0),
+          simulated_event(0), simulated_release_us(0) {
             if(period_microseconds < 300) {
                 period_microseconds = 300;
             }
@@ -86,11 +329,13 @@ public:
 
             runtime_ns.store(runtime_microseconds * 1000);
             period_ns.store(period_microseconds * 1000);
+            register_thread(this);
     }
     
     // Destructor
     ~PeriodicThread() {
         stop();
+        unregister_thread(this);
     }
     
     // Start the thread
@@ -100,6 +345,10 @@ public:
         }
         
         running.store(true);
+        if (Simulator::active()) {
+            start_simulated();
+            return true;
+        }
         if (pthread_create(&thread, NULL, threadFunction, this) != 0) {
             running.store(false);
             perror("pthread_create");
@@ -109,18 +358,75 @@ public:
         return true;
     }
     
+    // Timer mode options; take effect on start()
+    void set_fifo_priority(int priority) {
+        fifo_priority = priority;
+    }
+
+    // Overrides the placement plan
+    void set_affinity(int cpu_index) {
+        cpu = cpu_index;
+    }
+
+    // CPUs from the agent's placement plan (PERIODIC unless set); set before start()
+    void set_role(ThreadPlacement::Role placement_role) {
+        role = placement_role;
+    }
+
+    // Let the runtime budget follow the measured CPU time; set before start()
+    void set_adaptive_runtime(bool enabled) {
+        adaptive = enabled;
+    }
+
+    // Owner shown in the statistics (e.g. "component 3"); set before start()
+    void set_label(const std::string& owner) {
+        label = owner;
+    }
+
+    Stats stats() const {
+        Stats stats;
+        stats.label = label;
+        stats.mode = static_cast<Mode>(active_mode.load());
+        stats.period_us = period_ns.load() / 1000;
+        stats.runtime_us = runtime_ns.load() / 1000;
+        stats.jitter = jitter.snapshot();
+        stats.execution = execution.snapshot();
+        stats.budget_overruns = budget_overruns.load();
+        stats.deadline_misses = deadline_misses.load();
+        stats.skipped = skipped.load();
+        stats.kernel_overruns = kernel_overruns.load();
+        stats.adaptive = adaptive;
+        stats.adaptations = adaptations.load();
+        return stats;
+    }
+
+    // One line per thread: jitter and execution percentiles plus the counters
+    void dump(std::ostream& out) const;
+    static void dump_all(std::ostream& out);
+
     // Stop the thread
     void stop() {
         if (running.load()) {
             running.store(false);
-            pthread_join(thread, NULL);
+            if (active_mode.load() == SIMULATED) {
+                Simulator::cancel(simulated_event);
+            } else {
+                pthread_join(thread, NULL);
+            }
         }
     }
     
-    // Update the period
+    // Update the period. An adaptive budget is kept (it only has to fit the
+    // new period); a fixed one becomes half the period
     void update(const __u64 new_period_microseconds) {
-        period_ns.store(new_period_microseconds * 1000);
-        runtime_ns.store(new_period_microseconds * 1000 * 0.5);
+        __u64 period = new_period_microseconds * 1000;
+        if (adaptive) {
+            __u64 runtime = runtime_ns.load();
+            runtime_ns.store(runtime < period ? runtime : period);
+        } else {
+            runtime_ns.store(period * 0.5);
+        }
+        period_ns.store(period);
     }
 };
 
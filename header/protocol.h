@@ -116,39 +116,16 @@ public:
         Data _data;
     } __attribute__((packed));
 
-protected:
-    Protocol() {}
-
 public:
-    ~Protocol() {
-        unregister_nic(_nic);
-    }
-    
-    static Protocol* get_instance() {  
-        if (!_instance) {
-            _instance = new Protocol();
-        }
-
-        return _instance;
-    }
-
-    static void register_nic(NIC* nic) {
-        if (_instance) {
-            ConsoleLogger::print("Protocol: Registering NIC");
-            //std::string mac_string = mac_to_string(nic->address());
-            //ConsoleLogger::log("MAC string " + mac_string);
-            //_mac_table[mac_string] = nic;
-            nic->attach(_instance, PROTO);
-            _nic = nic;
-        }
+    // One protocol per NIC; several agents can share a process, each with its own
+    explicit Protocol(NIC* nic) : _nic(nic) {
+        ConsoleLogger::print("Protocol: Registering NIC");
+        _nic->attach(this, PROTO);
     }
 
-    static void unregister_nic(NIC* nic) {
-        if (_instance) {
-            ConsoleLogger::print("Protocol: Unregistering NIC");
-            nic->detach(_instance, PROTO);
-            _nic = nullptr;
-        }
+    virtual ~Protocol() {
+        ConsoleLogger::print("Protocol: Unregistering NIC");
+        _nic->detach(this, PROTO);
     }
 
     int send(Address from, Address to, const void * data, unsigned int size) {
@@ -196,10 +173,10 @@ public:
         return -1;
     }
 
-    static void attach(Observer * obs, Port port) {
+    void attach(Observer * obs, Port port) {
         _observed.attach(obs, port);
     }
-    static void detach(Observer * obs, Port port) {
+    void detach(Observer * obs, Port port) {
         _observed.detach(obs, port);
     }
 
@@ -216,11 +193,8 @@ private:
     }
 
 private:
-    static Protocol* _instance;
-    static NIC* _nic;
-
-    // Channel protocols are usually singletons
-    static Observed _observed;
+    NIC* _nic;
+    Observed _observed;
 };
 
 template <typename NIC>
@@ -232,13 +206,4 @@ const typename Protocol<NIC>::Address Protocol<NIC>::Address::BROADCAST(Protocol
 template <typename NIC>
 const unsigned int Protocol<NIC>::MTU = NIC::MTU - sizeof(Protocol<NIC>::Header) - sizeof(Ethernet::Attributes);
 
-template <typename NIC>
-typename Protocol<NIC>::Observed Protocol<NIC>::_observed;
-
-template <typename NIC>
-NIC* Protocol<NIC>::_nic = nullptr;
-
-template <typename NIC>
-Protocol<NIC>* Protocol<NIC>::_instance = nullptr;
-
 #endif // PROTOCOL_H
\ No newline at end of file
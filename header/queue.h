@@ -2,6 +2,8 @@
 #define QUEUE_H
 
 #include <mutex>
+#include <atomic>
+#include <cstddef>
 
 template <typename T, size_t SIZE>
 class Queue {
@@ -42,4 +44,177 @@ private:
     std::mutex mutex;
 };
 
+// The mutex-free rings below keep the producer and consumer indices on
+// separate cache lines. Padded rather than aligned: C++11 operator new
+// ignores over-alignment and the queues live inside heap allocated objects.
+static const size_t QUEUE_CACHE_LINE = 64;
+
+// Single producer / single consumer ring of pointers. add* may only be called
+// from one thread and remove* from one (other) thread. Each side caches the
+// other's index and only reloads it when the ring looks full or empty.
+template <typename T, size_t SIZE>
+class SPSCQueue {
+    static_assert(SIZE >= 2 && (SIZE & (SIZE - 1)) == 0, "SPSCQueue size must be a power of two");
+
+public:
+    SPSCQueue() : _tail(0), _head_cache(0), _head(0), _tail_cache(0) {}
+
+    bool add(T* value) {
+        return add_batch(&value, 1) == 1;
+    }
+
+    T* remove() {
+        T* value = nullptr;
+        remove_batch(&value, 1);
+        return value;
+    }
+
+    // Adds up to n values in order, returns how many fit
+    size_t add_batch(T* const* values, size_t n) {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        if (SIZE - (tail - _head_cache) < n) {
+            _head_cache = _head.load(std::memory_order_acquire);
+        }
+        size_t free = SIZE - (tail - _head_cache);
+        if (n > free) n = free;
+
+        for (size_t i = 0; i < n; i++) {
+            _data[(tail + i) & MASK] = values[i];
+        }
+        _tail.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    // Removes up to n values in order, returns how many there were
+    size_t remove_batch(T** values, size_t n) {
+        size_t head = _head.load(std::memory_order_relaxed);
+        if (_tail_cache - head < n) {
+            _tail_cache = _tail.load(std::memory_order_acquire);
+        }
+        size_t available = _tail_cache - head;
+        if (n > available) n = available;
+
+        for (size_t i = 0; i < n; i++) {
+            values[i] = _data[(head + i) & MASK];
+        }
+        _head.store(head + n, std::memory_order_release);
+        return n;
+    }
+
+    size_t size() const {
+        return _tail.load(std::memory_order_acquire) - _head.load(std::memory_order_acquire);
+    }
+
+private:
+    static const size_t MASK = SIZE - 1;
+
+    char _pad0[QUEUE_CACHE_LINE];
+    // Producer line
+    std::atomic<size_t> _tail;
+    size_t _head_cache;
+    char _pad1[QUEUE_CACHE_LINE - sizeof(std::atomic<size_t>) - sizeof(size_t)];
+    // Consumer line
+    std::atomic<size_t> _head;
+    size_t _tail_cache;
+    char _pad2[QUEUE_CACHE_LINE - sizeof(std::atomic<size_t>) - sizeof(size_t)];
+
+    T* _data[SIZE];
+};
+
+// Multi producer / multi consumer ring of pointers (Vyukov's bounded queue):
+// every cell carries a sequence number telling whose turn it is, so producers
+// and consumers only contend on their own position counter. Nothing ever
+// waits for another thread: a cell still being filled or emptied reads as
+// full or empty, and batches return short. Null values cannot be queued.
+template <typename T, size_t SIZE>
+class MPMCQueue {
+    static_assert(SIZE >= 2 && (SIZE & (SIZE - 1)) == 0, "MPMCQueue size must be a power of two");
+
+public:
+    MPMCQueue() : _enqueue(0), _dequeue(0) {
+        for (size_t i = 0; i < SIZE; i++) {
+            _cells[i].sequence.store(i, std::memory_order_relaxed);
+            _cells[i].value = nullptr;
+        }
+    }
+
+    bool add(T* value) {
+        size_t position = _enqueue.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = _cells[position & MASK];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            ptrdiff_t difference = static_cast<ptrdiff_t>(sequence - position);
+            if (difference == 0) {
+                if (_enqueue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    cell.value = value;
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0) {
+                return false; // Full
+            } else {
+                position = _enqueue.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    T* remove() {
+        size_t position = _dequeue.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = _cells[position & MASK];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            ptrdiff_t difference = static_cast<ptrdiff_t>(sequence - (position + 1));
+            if (difference == 0) {
+                if (_dequeue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    T* value = cell.value;
+                    cell.sequence.store(position + SIZE, std::memory_order_release);
+                    return value;
+                }
+            } else if (difference < 0) {
+                return nullptr; // Empty
+            } else {
+                position = _dequeue.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Adds up to n values, returns how many fit. One add() per value: a
+    // range claimed with a single CAS would have to wait for slow owners of
+    // the previous lap, so the batch stops at the first cell not ready instead
+    size_t add_batch(T* const* values, size_t n) {
+        size_t count = 0;
+        while (count < n && add(values[count])) {
+            count++;
+        }
+        return count;
+    }
+
+    // Removes up to n values, returns how many there were; stops, like
+    // add_batch, at the first cell whose producer has not finished
+    size_t remove_batch(T** values, size_t n) {
+        size_t count = 0;
+        while (count < n) {
+            T* value = remove();
+            if (!value) break;
+            values[count++] = value;
+        }
+        return count;
+    }
+
+private:
+    static const size_t MASK = SIZE - 1;
+
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T* value;
+    };
+
+    char _pad0[QUEUE_CACHE_LINE];
+    std::atomic<size_t> _enqueue;
+    char _pad1[QUEUE_CACHE_LINE - sizeof(std::atomic<size_t>)];
+    std::atomic<size_t> _dequeue;
+    char _pad2[QUEUE_CACHE_LINE - sizeof(std::atomic<size_t>)];
+    Cell _cells[SIZE];
+};
+
 #endif // QUEUE_H
\ No newline at end of file
@@ -3,6 +3,9 @@
 
 #include <sys/socket.h>
 #include <sys/ioctl.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <semaphore.h>
 #include <linux/if_packet.h>
 #include <net/if.h>
 #include <unistd.h>
@@ -14,14 +17,32 @@
 #include <ifaddrs.h>
 #include <set>
 #include <string>
+#include <linux/net_tstamp.h>
+#include <linux/sockios.h>
+#include <linux/errqueue.h>
+#include <poll.h>
+#include <time.h>
+#include <atomic>
+#include <mutex>
 
 #include "ethernet.h"
+#include "traits.h"
+#include "u64_type.h"
 #include "console_logger.h"
 
 class RawSocketEngine 
 {
+public:
+    // Where frame timestamps come from
+    enum Timestamping {
+        TIMESTAMPING_NONE,      // Caller stamps in user space
+        TIMESTAMPING_SOFTWARE,  // Kernel stamps at the driver boundary (CLOCK_REALTIME)
+        TIMESTAMPING_HARDWARE   // NIC stamps; the PHC must be disciplined to CLOCK_REALTIME (phc2sys)
+    };
+
 protected:
-    RawSocketEngine() {
+    RawSocketEngine() : _timestamping(TIMESTAMPING_NONE), _tx_timestamps(false), _tx_next(0), _notify_slot(-1) {
+        memset(_tx_stamps, 0, sizeof(_tx_stamps));
         _socket = socket(AF_PACKET, SOCK_RAW, htons(ETH_P_ALL));
         if(_socket < 0) {
             ConsoleLogger::error("Socket creation failed");
@@ -64,14 +85,19 @@ protected:
 
         //ConsoleLogger::print("Raw Socket Engine: MAC Address = " + mac.str());
         memcpy(_addr, ifr.ifr_hwaddr.sa_data, ETH_ALEN);
+
+        enable_timestamping(interface_name);
     }
     
     ~RawSocketEngine() {
+        notify(nullptr);
         if(_socket >= 0)
             close(_socket);
     }
     
-    int raw_send(Ethernet::Address dst, Ethernet::Protocol prot, Ethernet::Attributes* attributes, const void* data, unsigned int size) {
+    // With TX timestamps enabled, `tx_timestamp` receives the kernel send time of
+    // this frame in microseconds (0 if it did not come within TX_TIMESTAMP_WAIT_US)
+    int raw_send(Ethernet::Address dst, Ethernet::Protocol prot, Ethernet::Attributes* attributes, const void* data, unsigned int size, U64* tx_timestamp = nullptr) {
         //ConsoleLogger::print("Raw Socket Engine: Sending frame.");
         Ethernet::Frame frame(dst, _addr, prot);
         //ConsoleLogger::print("Raw Socket Engine:PROTO -> " + std::to_string(prot));
@@ -85,21 +111,61 @@ protected:
         socket_address.sll_halen = ETH_ALEN;
         memcpy(socket_address.sll_addr, dst, ETH_ALEN);
         
-        int bytes_sent = sendto(_socket, &frame, sizeof(Ethernet::Header) + sizeof(Ethernet::Attributes) + size, 0,
-                               (struct sockaddr*)&socket_address, sizeof(socket_address));
+        size_t length = sizeof(Ethernet::Header) + sizeof(Ethernet::Attributes) + size;
+
+        if (tx_timestamp) {
+            *tx_timestamp = 0;
+        }
+        if (!_tx_timestamps) {
+            int bytes_sent = sendto(_socket, &frame, length, 0, (struct sockaddr*)&socket_address, sizeof(socket_address));
+            return bytes_sent - sizeof(Ethernet::Header) - sizeof(Ethernet::Attributes);
+        }
 
+        // SOF_TIMESTAMPING_OPT_ID numbers the sends in socket order: keep our
+        // counter in step by sending under the lock
+        uint32_t id;
+        int bytes_sent;
+        {
+            std::lock_guard<std::mutex> lock(_tx_mutex);
+            id = _tx_next;
+            bytes_sent = sendto(_socket, &frame, length, 0, (struct sockaddr*)&socket_address, sizeof(socket_address));
+            if (bytes_sent >= 0) {
+                _tx_next++;
+            }
+        }
+        if (bytes_sent >= 0) {
+            // Stamps of other sends are drained too (the error queue is charged to the receive buffer)
+            U64 stamp = wait_tx_timestamp(id);
+            if (tx_timestamp) {
+                *tx_timestamp = stamp;
+            }
+        }
 
         //ConsoleLogger::print("Raw Socket Engine: Frame sent.");                  
         return bytes_sent - sizeof(Ethernet::Header) - sizeof(Ethernet::Attributes);
     }
     
-    int raw_receive(Ethernet::Address* src, Ethernet::Protocol* prot, Ethernet::Attributes* attributes, void* data, unsigned int size) {
+    // `timestamp` receives the kernel arrival time in microseconds, or 0 when the kernel did not stamp the frame
+    int raw_receive(Ethernet::Address* src, Ethernet::Protocol* prot, Ethernet::Attributes* attributes, void* data, unsigned int size, U64* timestamp = nullptr) {
         //ConsoleLogger::print("Raw Socket Engine: Receive started.");  
         Ethernet::Frame frame;
-        int bytes_received = recvfrom(_socket, &frame, sizeof(frame), 0, NULL, NULL);
+        struct iovec iov = { &frame, sizeof(frame) };
+        char control[CMSG_SPACE(sizeof(struct scm_timestamping))];
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+
+        int bytes_received = recvmsg(_socket, &msg, 0);
         if(bytes_received < 0)
             return -1;
 
+        if (timestamp) {
+            *timestamp = control_timestamp(&msg);
+        }
+
 
         memcpy(src, frame.header()->h_source, ETH_ALEN);
         *prot = ntohs(frame.header()->h_proto);
@@ -139,10 +205,224 @@ protected:
         return name;
     }
 
+    Timestamping timestamping() const {
+        return _timestamping;
+    }
+
+    // Send timestamps cost an error-queue read per frame, so only nodes that use them turn them on
+    bool enable_tx_timestamps() {
+        if (_timestamping == TIMESTAMPING_NONE || _tx_timestamps) {
+            return _tx_timestamps;
+        }
+        // OPT_ID tags each stamp with the send it belongs to (ee_data)
+        int flags = timestamping_flags(_timestamping) | SOF_TIMESTAMPING_OPT_TSONLY | SOF_TIMESTAMPING_OPT_ID |
+                    (_timestamping == TIMESTAMPING_HARDWARE ? SOF_TIMESTAMPING_TX_HARDWARE : SOF_TIMESTAMPING_TX_SOFTWARE);
+        std::lock_guard<std::mutex> lock(_tx_mutex);
+        _tx_timestamps = setsockopt(_socket, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) == 0;
+        // The kernel numbers sends from zero once OPT_ID is set
+        _tx_next = 0;
+        return _tx_timestamps;
+    }
+
+    // Posts `semaphore` (from the SIGIO handler) whenever frames arrive; nullptr
+    // stops it. SIGIO is per process, so every engine in it is woken
+    void notify(sem_t* semaphore) {
+        if (_notify_slot >= 0) {
+            notify_slots()[_notify_slot].store(nullptr);
+            _notify_slot = -1;
+        }
+        if (!semaphore) {
+            return;
+        }
+
+        for (unsigned int slot = 0; slot < NOTIFY_SLOTS; slot++) {
+            sem_t* expected = nullptr;
+            if (notify_slots()[slot].compare_exchange_strong(expected, semaphore)) {
+                _notify_slot = slot;
+                break;
+            }
+        }
+        if (_notify_slot < 0) {
+            ConsoleLogger::error("RawSocketEngine: no free SIGIO slot");
+            return;
+        }
+
+        struct sigaction sa;
+        memset(&sa, 0, sizeof(sa));
+        sa.sa_flags = SA_RESTART;
+        sa.sa_handler = &RawSocketEngine::sigio_handler;
+        if (sigaction(SIGIO, &sa, NULL) < 0) {
+            ConsoleLogger::error("sigaction");
+            exit(EXIT_FAILURE);
+        }
+
+        // Configure socket for async I/O
+        int flags = fcntl(_socket, F_GETFL, 0);
+        fcntl(_socket, F_SETFL, flags | O_ASYNC | O_NONBLOCK);
+        fcntl(_socket, F_SETOWN, getpid());
+    }
+
+private:
+    static const unsigned int NOTIFY_SLOTS = 16;
+    // Stamps drained for sends whose thread has not picked them up yet
+    static const unsigned int TX_STAMPS = 64;
+
+    struct TxStamp {
+        uint32_t id;
+        bool valid;
+        U64 stamp;
+    };
+
+    // Zero-initialized before any constructor runs, so safe to read in the handler
+    static std::atomic<sem_t*>* notify_slots() {
+        static std::atomic<sem_t*> slots[NOTIFY_SLOTS];
+        return slots;
+    }
+
+    static void sigio_handler(int signum) {
+        for (unsigned int slot = 0; slot < NOTIFY_SLOTS; slot++) {
+            sem_t* semaphore = notify_slots()[slot].load();
+            if (semaphore) {
+                sem_post(semaphore);
+            }
+        }
+    }
+
+    static int timestamping_flags(Timestamping timestamping) {
+        if (timestamping == TIMESTAMPING_HARDWARE) {
+            return SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE;
+        }
+        return SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+    }
+
+    void enable_timestamping(const std::string& interface_name) {
+        if (Traits<RawSocketEngine>::HARDWARE_TIMESTAMPS) {
+            // Needs CAP_NET_ADMIN and driver support; software stamps are the fallback
+            struct hwtstamp_config config;
+            memset(&config, 0, sizeof(config));
+            config.tx_type = HWTSTAMP_TX_ON;
+            config.rx_filter = HWTSTAMP_FILTER_ALL;
+
+            struct ifreq ifr;
+            memset(&ifr, 0, sizeof(ifr));
+            strncpy(ifr.ifr_name, interface_name.c_str(), IFNAMSIZ - 1);
+            ifr.ifr_data = reinterpret_cast<char*>(&config);
+
+            int flags = timestamping_flags(TIMESTAMPING_HARDWARE);
+            if (ioctl(_socket, SIOCSHWTSTAMP, &ifr) == 0 &&
+                setsockopt(_socket, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) == 0) {
+                _timestamping = TIMESTAMPING_HARDWARE;
+                return;
+            }
+        }
+
+        int flags = timestamping_flags(TIMESTAMPING_SOFTWARE);
+        if (setsockopt(_socket, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) == 0) {
+            _timestamping = TIMESTAMPING_SOFTWARE;
+        }
+    }
+
+    // Microseconds from an SCM_TIMESTAMPING control message, 0 if absent
+    U64 control_timestamp(struct msghdr* msg) {
+        for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(msg); cmsg; cmsg = CMSG_NXTHDR(msg, cmsg)) {
+            if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_TIMESTAMPING) {
+                continue;
+            }
+            struct scm_timestamping stamps;
+            memcpy(&stamps, CMSG_DATA(cmsg), sizeof(stamps));
+            // ts[0] is the software stamp, ts[2] the raw hardware one
+            const struct timespec& ts = _timestamping == TIMESTAMPING_HARDWARE ? stamps.ts[2] : stamps.ts[0];
+            if (ts.tv_sec == 0 && ts.tv_nsec == 0) {
+                return 0;
+            }
+            return static_cast<U64>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+        }
+        return 0;
+    }
+
+    // Send id from the sock_extended_err of an error-queue message, false if it is not a stamp
+    static bool control_tx_id(struct msghdr* msg, uint32_t& id) {
+        for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(msg); cmsg; cmsg = CMSG_NXTHDR(msg, cmsg)) {
+            if (cmsg->cmsg_level == SOL_SOCKET) {
+                continue;
+            }
+            struct sock_extended_err error;
+            memcpy(&error, CMSG_DATA(cmsg), sizeof(error));
+            if (error.ee_errno == ENOMSG && error.ee_origin == SO_EE_ORIGIN_TIMESTAMPING) {
+                id = error.ee_data;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Moves every stamp in the error queue into _tx_stamps. Caller holds _tx_mutex
+    void drain_tx_timestamps() {
+        while (true) {
+            char control[CMSG_SPACE(sizeof(struct scm_timestamping)) + CMSG_SPACE(sizeof(struct sock_extended_err) + sizeof(struct sockaddr_ll))];
+            struct msghdr msg;
+            memset(&msg, 0, sizeof(msg));
+            msg.msg_control = control;
+            msg.msg_controllen = sizeof(control);
+
+            if (recvmsg(_socket, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+                return;
+            }
+            uint32_t id;
+            if (!control_tx_id(&msg, id)) {
+                continue;
+            }
+            TxStamp& entry = _tx_stamps[id % TX_STAMPS];
+            entry.id = id;
+            entry.valid = true;
+            entry.stamp = control_timestamp(&msg);
+        }
+    }
+
+    // The stamp of send `id`, polling the error queue for up to TX_TIMESTAMP_WAIT_US; 0 if it never came
+    U64 wait_tx_timestamp(uint32_t id) {
+        struct timespec start;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        while (true) {
+            {
+                std::lock_guard<std::mutex> lock(_tx_mutex);
+                drain_tx_timestamps();
+                TxStamp& entry = _tx_stamps[id % TX_STAMPS];
+                if (entry.valid && entry.id == id) {
+                    entry.valid = false;
+                    return entry.stamp;
+                }
+                // Lapped by newer sends: it is gone
+                if (_tx_next - id > TX_STAMPS) {
+                    return 0;
+                }
+            }
+
+            struct timespec now;
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            long long waited_ns = (now.tv_sec - start.tv_sec) * 1000000000LL + (now.tv_nsec - start.tv_nsec);
+            long long remaining_ns = static_cast<long long>(Traits<RawSocketEngine>::TX_TIMESTAMP_WAIT_US) * 1000 - waited_ns;
+            if (remaining_ns <= 0) {
+                return 0;
+            }
+            // POLLERR is raised while the error queue is not empty; another
+            // sender may drain it first, so the wait is also bounded
+            struct pollfd pfd = {_socket, 0, 0};
+            struct timespec timeout = {0, remaining_ns < 50000 ? remaining_ns : 50000};
+            ppoll(&pfd, 1, &timeout, nullptr);
+        }
+    }
+
 protected:
     int _socket;
     int _ifindex;
     Ethernet::Address _addr;
+    Timestamping _timestamping;
+    bool _tx_timestamps;
+    std::mutex _tx_mutex;
+    uint32_t _tx_next;
+    TxStamp _tx_stamps[TX_STAMPS];
+    int _notify_slot;
 };
 
 #endif // RAW_SOCKET_ENGINE_H
\ No newline at end of file
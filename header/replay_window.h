@@ -0,0 +1,114 @@
+#ifndef REPLAY_WINDOW_H
+#define REPLAY_WINDOW_H
+
+#include <cstring>
+#include <cstdint>
+
+#include "ethernet.h"
+
+// Per-sender anti-replay window (RFC 4303 style).
+// Each sender keeps the highest sequence number seen and a 64-bit bitmap of
+// the sequences just below it. Sequence numbers wrap (serial arithmetic).
+// The sender table has fixed capacity; the least recently seen sender is
+// evicted when a new one arrives. Not thread-safe: used by the NIC worker.
+template <unsigned int SENDERS>
+class ReplayWindow
+{
+public:
+    static const unsigned int WINDOW = 64;
+
+    enum Result {
+        ACCEPTED,
+        DUPLICATE,  // Already seen inside the window
+        TOO_OLD     // Behind the window: cannot tell, so it is dropped
+    };
+
+    ReplayWindow() : _clock(0), _duplicates(0), _too_old(0) {
+        memset(_senders, 0, sizeof(_senders));
+    }
+
+    Result check(const Ethernet::Address origin, uint32_t sequence) {
+        Sender* sender = find(origin);
+        if (!sender) {
+            sender = evict();
+            memcpy(sender->address, origin, ETH_ALEN);
+            sender->used = true;
+            sender->highest = sequence;
+            sender->bitmap = 1;
+            sender->last_seen = ++_clock;
+            return ACCEPTED;
+        }
+        sender->last_seen = ++_clock;
+
+        int32_t ahead = static_cast<int32_t>(sequence - sender->highest);
+        if (ahead > 0) {
+            sender->bitmap = static_cast<unsigned int>(ahead) < WINDOW ? (sender->bitmap << ahead) | 1 : 1;
+            sender->highest = sequence;
+            return ACCEPTED;
+        }
+
+        uint32_t behind = static_cast<uint32_t>(-static_cast<int64_t>(ahead));
+        if (behind >= WINDOW) {
+            _too_old++;
+            return TOO_OLD;
+        }
+
+        uint64_t bit = 1ULL << behind;
+        if (sender->bitmap & bit) {
+            _duplicates++;
+            return DUPLICATE;
+        }
+        sender->bitmap |= bit;
+        return ACCEPTED;
+    }
+
+    bool accept(const Ethernet::Address origin, uint32_t sequence) {
+        return check(origin, sequence) == ACCEPTED;
+    }
+
+    unsigned long duplicates() const { return _duplicates; }
+    unsigned long too_old() const { return _too_old; }
+    unsigned long rejected() const { return _duplicates + _too_old; }
+
+private:
+    struct Sender {
+        unsigned char address[ETH_ALEN];
+        bool used;
+        uint32_t highest;
+        uint64_t bitmap;
+        unsigned long last_seen;
+    };
+
+    Sender* find(const Ethernet::Address origin) {
+        for (unsigned int i = 0; i < SENDERS; i++) {
+            if (_senders[i].used && memcmp(_senders[i].address, origin, ETH_ALEN) == 0) {
+                return &_senders[i];
+            }
+        }
+        return nullptr;
+    }
+
+    Sender* evict() {
+        Sender* oldest = &_senders[0];
+        for (unsigned int i = 0; i < SENDERS; i++) {
+            if (!_senders[i].used) {
+                return &_senders[i];
+            }
+            if (_senders[i].last_seen < oldest->last_seen) {
+                oldest = &_senders[i];
+            }
+        }
+        return oldest;
+    }
+
+private:
+    Sender _senders[SENDERS];
+    unsigned long _clock;
+    unsigned long _duplicates;
+    unsigned long _too_old;
+};
+
+template <unsigned int SENDERS>
+const unsigned int ReplayWindow<SENDERS>::WINDOW;
+
+#endif // REPLAY_WINDOW_H
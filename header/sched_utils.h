@@ -10,6 +10,10 @@
 namespace VehicleSched {
     #define gettid() syscall(__NR_gettid)
     #define SCHED_DEADLINE 6
+    // Deliver SIGXCPU when a SCHED_DEADLINE task exhausts its runtime (Linux 4.16)
+    #ifndef SCHED_FLAG_DL_OVERRUN
+    #define SCHED_FLAG_DL_OVERRUN 0x04
+    #endif
 
     // Define syscall numbers for different architectures
     #ifdef __x86_64__
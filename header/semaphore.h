@@ -1,11 +1,14 @@
 #ifndef SEMAPHORE_H
 #define SEMAPHORE_H
 
-#include <mutex>
-#include <condition_variable>
 #include <atomic>
 
-// Semaphore implementation for thread synchronization
+#include "traits.h"
+
+// Counting semaphore for thread synchronization, built on a Linux futex.
+// p() and v() are a single atomic operation while the count is positive and
+// nobody sleeps; a p() that finds the count at zero spins for a short,
+// adaptive number of rounds before parking in the kernel.
 class Semaphore 
 {
 public:
@@ -15,14 +18,22 @@ public:
 
     void p();
     bool try_p();
+    // Waits at most `timeout_us` microseconds; false on timeout
+    bool p(long long timeout_us);
 
     void v();
 
     int count();
 private:
-    int _count;
-    std::mutex _mutex;
-    std::condition_variable _condition;
+    bool acquire();
+    bool spin();
+    // Parks until woken or the absolute CLOCK_MONOTONIC deadline (ns, 0 = none) passes
+    bool park(long long deadline_ns);
+
+    std::atomic<int> _count;
+    std::atomic<int> _waiters;
+    // Current spin budget, grows while spinning pays off
+    std::atomic<int> _spin;
 };
 
-#endif // SEMAPHORE_H
\ No newline at end of file
+#endif // SEMAPHORE_H
@@ -0,0 +1,58 @@
+#ifndef SIMULATOR_H
+#define SIMULATOR_H
+
+#include <cstdint>
+#include <functional>
+
+#include "traits.h"
+#include "u64_type.h"
+
+// Discrete-event simulation core: a virtual clock and a queue of events run
+// in time order, ties in the order they were scheduled. While it is active,
+// TimeKeeper reads the virtual clock, PeriodicThreads become timer events and
+// the MemoryBus delivers frames through a ChannelModel, so a whole scenario
+// runs on the thread that calls run_until(), as fast as the events allow.
+// Every random choice of the simulation comes from random(), so a seed
+// reproduces a run bit for bit. Not thread safe: schedule and run from the
+// simulation thread only.
+class Simulator
+{
+public:
+    typedef std::function<void()> Event;
+    typedef unsigned long long Id;
+
+    // Starts virtual time at `start_us` (system time, in microseconds)
+    static void start(uint64_t seed, U64 start_us = Traits<Simulator>::START_US);
+    // Drops the pending events and goes back to real time
+    static void stop();
+    static bool active();
+
+    static U64 now_us();
+    static U64 start_us();
+
+    static Id schedule(U64 at_us, const Event& event);
+    static Id schedule_in(U64 delay_us, const Event& event);
+    // False if the event already ran or was cancelled
+    static bool cancel(Id id);
+
+    // Runs the next event; false if there is none
+    static bool step();
+    // Runs every event up to `at_us`, then leaves the clock there
+    static void run_until(U64 at_us);
+
+    // xorshift64*: the same sequence on every platform for a given seed
+    static uint64_t random();
+    // Uniform in [low, high]
+    static long long uniform(long long low, long long high);
+    // True with probability ppm / 1e6
+    static bool chance(unsigned int ppm);
+
+    static unsigned long long events_run();
+    static unsigned long pending();
+
+private:
+    struct State;
+    static State& state();
+};
+
+#endif // SIMULATOR_H
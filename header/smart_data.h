@@ -17,7 +17,7 @@
 
 class SmartData {
 public:
-    SmartData(Ethernet::Address& address, const unsigned short id);
+    SmartData(EthernetProtocol* protocol, Ethernet::Address& address, const unsigned short id);
     ~SmartData();
 
     typedef std::function<std::vector<InterestData>()>  GetInterestsCallback;
@@ -62,7 +62,8 @@ private:
     std::vector<MessageAddressPair> _external_interest_messages;
     std::vector<MessageAddressPair> _internal_interest_messages;
 
-    Queue<int, 32> _queue;
+    // Shared by the receive and response threads
+    MPMCQueue<int, 32> _queue;
 
     GetInterestsCallback _get_interests;
     GetDataCallback _get_data;
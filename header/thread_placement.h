@@ -0,0 +1,68 @@
+#ifndef THREAD_PLACEMENT_H
+#define THREAD_PLACEMENT_H
+
+#include <pthread.h>
+#include <sched.h>
+#include <string>
+
+#include "traits.h"
+
+// CPU placement of the agent's threads by role, so the RX path and the
+// component logic stop sharing (and thrashing) the same caches.
+// Each agent runs in its own process: the agent calls configure() when it
+// starts, and every thread calls place() with its role when it starts (a
+// Guard does both place() and leave()). Threads placed before configure()
+// (NIC worker, logger) are moved when the plan changes.
+//
+// The plan comes from Traits<ThreadPlacement>, overridden by the file named
+// Traits<ThreadPlacement>::config_file() when it exists. One "key = cpus"
+// per line, '#' starts a comment:
+//
+//     nic_worker = 2            # every agent
+//     rsu.nic_worker = 3        # agents of one kind
+//     vehicle7.periodic = 4-5   # one agent (kind + id)
+//     logger = isolated         # the isolcpus= CPUs
+//
+// cpus is a cpulist ("0-3,6"), "isolated" for the CPUs the kernel keeps out
+// of load balancing, or empty/"any" for the process default.
+class ThreadPlacement
+{
+public:
+    enum Role {
+        NIC_WORKER,     // NIC RX processing
+        RECEIVER,       // SmartData receive threads
+        SENDER,         // Periodic threads that send (responses, sync beacons)
+        PERIODIC,       // Component and interest periodic tasks
+        LOGGER,         // AsyncLogger drain
+        ROLES
+    };
+
+    class Guard {
+    public:
+        Guard(Role role, const char* name) { place(role, name); }
+        ~Guard() { leave(); }
+    private:
+        Guard(const Guard&);
+        Guard& operator=(const Guard&);
+    };
+
+    // Loads the plan for agent `kind` (e.g. "rsu") number `id` and applies it
+    static void configure(const std::string& kind, int id, const char* file = Traits<ThreadPlacement>::config_file());
+    // Registers the calling thread and pins it to its role's CPUs
+    static void place(Role role, const char* name);
+    static void leave();
+
+    // False if the role keeps the process default affinity
+    static bool restricted(Role role);
+    // Role's CPUs as a cpulist ("any" if unrestricted)
+    static std::string cpus(Role role);
+    // Logs the plan and the affinity every registered thread actually has
+    static void report();
+
+    static const char* role_name(Role role);
+    // Parses a cpulist or "isolated"; false on syntax errors
+    static bool parse_cpus(const std::string& text, cpu_set_t& set, bool& restricted);
+    static std::string format_cpus(const cpu_set_t& set);
+};
+
+#endif // THREAD_PLACEMENT_H
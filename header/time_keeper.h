@@ -2,20 +2,22 @@
 #define TIME_KEEPER_H
 
 #include <chrono>
-#include <random>
+#include <mutex>
 
 #include "u64_type.h"
 #include "ethernet.h"
+#include "traits.h"
+#include "clock_estimator.h"
+#include "fast_clock.h"
 #include "console_logger.h"
 
-#define SYNC_TIMEOUT 50;
-
 
 class TimeKeeper 
 {
 public:
     typedef Ethernet::Attributes::SyncState SyncState;
     typedef Ethernet::Attributes::PacketOrigin PacketOrigin;
+    typedef ClockEstimator::Quality SyncQuality;
 
     TimeKeeper();
     ~TimeKeeper();
@@ -23,26 +25,36 @@ public:
     U64 get_system_timestamp();
     U64 get_local_timestamp();
     SyncState get_sync_state();
+    SyncQuality get_sync_quality();
 
     void update_sync_state(SyncState sync_sate);
-    void update_time_keeper(U64 system_timestamp, U64 local_timestamp);
+    // Under the Simulator an RSU clock is the reference (GPS disciplined): no offset or skew
+    void set_packet_origin(PacketOrigin packet_origin);
+    // RSU sync beacon: pairs the follow-up with the stored arrival of beacon follow_up_sequence
+    void update_sync_beacon(uint32_t sequence, U64 origin_timestamp, U64 follow_up, uint32_t follow_up_sequence, U64 local_timestamp);
+    // Beacon interval this node needs to stay within the drift budget
+    uint32_t wanted_beacon_interval();
     void update_sync_status();
 
 private:
-    bool is_t1 = true;
-    bool synchronize_time = true;
-    int fake_offset;
-    
-    U64 offset = 0;
-    U64 last_update;
-    U64 t1 = 0;
-    U64 t2 = 0;
-    U64 t3 = 0;
-    U64 t4 = 0;
+    // Caller holds _mutex
+    void evaluate_sync_state(U64 local_timestamp);
+
+    // Under the Simulator: this node's clock, off the virtual time by an
+    // offset and a skew drawn when the TimeKeeper is created
+    bool _virtual;
+    long long _virtual_offset_us;
+    long long _virtual_skew_ppm;
+
+    std::mutex _mutex;
+    ClockEstimator _estimator;
+
+    bool _has_last_beacon = false;
+    uint32_t _last_beacon_sequence = 0;
+    U64 _last_beacon_local = 0;
     
     PacketOrigin _packet_origin = PacketOrigin::OTHERS;
     SyncState sync_state = SyncState::NOT_SYNCHRONIZED;
-    U64 sync_timeout = SYNC_TIMEOUT;
 };
 
-#endif // TIME_KEEPER_H 
\ No newline at end of file
+#endif // TIME_KEEPER_H 
@@ -3,12 +3,38 @@
 
 #include <random>
 
+class ConsoleLogger;
+class AsyncLogger;
+class MACHandler;
+class VehicleTable;
+class TimeKeeper;
+class RawSocketEngine;
+class MemoryEngine;
+class FastClock;
+class Semaphore;
+class PeriodicThread;
+class ThreadPlacement;
+class Simulator;
+class ChannelModel;
+class DatasetCursor;
+
 template<typename T>
-class Traits 
+class Traits
 {
 public:
     static const unsigned int SEND_BUFFERS = 16;
     static const unsigned int RECEIVE_BUFFERS = 16;
+    // Frames drained from the socket before they are verified together
+    static const unsigned int RECEIVE_BURST = 16;
+    // Senders tracked by the replay window
+    static const unsigned int REPLAY_SENDERS = 64;
+    // RSU: vehicles waiting for MAC keys, and how many one key frame addresses
+    static const unsigned int KEY_DISTRIBUTION_VEHICLES = 1024;
+    static const unsigned int KEY_DISTRIBUTION_BATCH = 32;
+    // RSU: TX timestamp samples above this are scheduling stalls, not send latency
+    static const unsigned int TX_LATENCY_MAX_US = 1000;
+    // Lifetime of a quadrant MAC key; the RSU announces the next one a full epoch ahead
+    static const unsigned long long MAC_KEY_EPOCH_US = 10000000;
     static const unsigned int ETHERNET_PROTOCOL_NUMBER = 0x8888;
     static const unsigned int NUM_COMPONENTS = 4;
     static const unsigned int NUM_VEHICLE = 2;
@@ -22,4 +48,180 @@ public:
     }
 };
 
-#endif // TRAITS_H
\ No newline at end of file
+template<>
+class Traits<ConsoleLogger>: public Traits<void>
+{
+public:
+    // Lowest level that is compiled in (0 = TRACE ... 4 = ERROR)
+    static const int LEVEL = 2;
+    // Enabled levels go to the binary AsyncLogger instead of being formatted in place
+    static const bool ASYNC = true;
+};
+
+template<>
+class Traits<AsyncLogger>: public Traits<void>
+{
+public:
+    static const int LEVEL = Traits<ConsoleLogger>::LEVEL;
+    // Records per thread ring (must be a power of two)
+    static const unsigned int RING_SLOTS = 512;
+    // Drain thread sleep when every ring is empty
+    static const unsigned int DRAIN_INTERVAL_US = 1000;
+};
+
+template<>
+class Traits<MACHandler>: public Traits<void>
+{
+public:
+    // MACAlgorithm::Type (0 = XOR_FOLD, 1 = SIPHASH_2_4, 2 = NH_UNIVERSAL); every node must agree
+    static const int ALGORITHM = 0;
+};
+
+template<>
+class Traits<VehicleTable>: public Traits<void>
+{
+public:
+    // Slots in the RSU vehicle table (must be a power of two)
+    static const unsigned int CAPACITY = 4096;
+    // Slots probed per lookup before the table gives up or evicts
+    static const unsigned int MAX_PROBE = 32;
+    // A vehicle not heard from for this long has left the quadrant
+    static const long long TTL_US = 30000000;
+};
+
+template<>
+class Traits<TimeKeeper>: public Traits<void>
+{
+public:
+    // RSU timestamps kept for the offset/skew fit
+    static const unsigned int SYNC_WINDOW = 32;
+    static const unsigned int SYNC_MIN_SAMPLES = 4;
+    // Residuals beyond this many robust deviations (and the floor) are outliers
+    static const unsigned int OUTLIER_SIGMAS = 4;
+    static const unsigned int OUTLIER_FLOOR_US = 20;
+    // Largest believable skew between two clocks (NTP's limit)
+    static const unsigned int MAX_SKEW_PPM = 500;
+    // SYNCHRONIZED while the offset error bound is below this and samples keep arriving
+    static const unsigned int SYNC_ERROR_BOUND_US = 100;
+    static const unsigned int SYNC_TIMEOUT_US = 300000;
+    // Sync beacon interval range; within it, the interval over which the
+    // estimated skew drifts the clock by DRIFT_BUDGET_US
+    static const unsigned int BEACON_MIN_US = 1000;
+    static const unsigned int BEACON_MAX_US = 100000;
+    static const unsigned int DRIFT_BUDGET_US = 10;
+    // RSU: a vehicle's interval request counts for this long
+    static const unsigned int BEACON_REQUEST_TTL_US = 1000000;
+};
+
+template<>
+class Traits<RawSocketEngine>: public Traits<void>
+{
+public:
+    // Ask the NIC driver for hardware timestamps (falls back to kernel software stamps)
+    static const bool HARDWARE_TIMESTAMPS = false;
+    // How long raw_send() waits for its own send timestamp (hardware ones come late)
+    static const unsigned int TX_TIMESTAMP_WAIT_US = 500;
+};
+
+template<>
+class Traits<MemoryEngine>: public Traits<void>
+{
+public:
+    // Frames queued per engine before the bus drops them (its socket buffer)
+    static const unsigned int QUEUE_FRAMES = 256;
+};
+
+template<>
+class Traits<FastClock>: public Traits<void>
+{
+public:
+    // Start-up measurement of the TSC rate
+    static const unsigned int CALIBRATION_US = 10000;
+    // How often the monotonic -> CLOCK_REALTIME offset is measured again
+    static const unsigned int RESYNC_INTERVAL_US = 1000000;
+};
+
+template<>
+class Traits<Semaphore>: public Traits<void>
+{
+public:
+    // Upper bound of the adaptive spin (pause rounds) before p() parks
+    static const int SPIN_MAX = 256;
+};
+
+template<>
+class Traits<PeriodicThread>: public Traits<void>
+{
+public:
+    // PeriodicThread::Mode (0 = AUTO, 1 = DEADLINE, 2 = TIMER)
+    static const int MODE = 0;
+    // Timer mode: SCHED_FIFO priority (0 = default policy) and CPU (-1 = any)
+    static const int FIFO_PRIORITY = 0;
+    static const int CPU = -1;
+    // Log each thread's jitter/execution statistics when it is destroyed
+    static const bool LOG_STATS = true;
+    // Adaptive runtime: every ADAPT_WINDOW activations the budget becomes the
+    // ADAPT_PERCENTILE of their CPU time plus ADAPT_MARGIN_PERCENT, at least
+    // MIN_RUNTIME_US, with all adaptive threads together under UTILIZATION_CAP_PERCENT of a CPU
+    static const bool ADAPTIVE_RUNTIME = true;
+    static const unsigned int ADAPT_WINDOW = 32;
+    static const unsigned int ADAPT_PERCENTILE = 99;
+    static const unsigned int ADAPT_MARGIN_PERCENT = 25;
+    static const unsigned int MIN_RUNTIME_US = 50;
+    static const unsigned int UTILIZATION_CAP_PERCENT = 80;
+};
+
+template<>
+class Traits<ThreadPlacement>: public Traits<void>
+{
+public:
+    // Overrides the defaults below when present (format in thread_placement.h)
+    static const char* config_file() { return "placement.conf"; }
+
+    // CPUs per ThreadPlacement::Role as a cpulist, "isolated" or "" (any)
+    static const char* cpus(int role) {
+        static const char* const DEFAULT[] = {
+            "",     // NIC_WORKER
+            "",     // RECEIVER
+            "",     // SENDER
+            "",     // PERIODIC
+            ""      // LOGGER
+        };
+        return DEFAULT[role];
+    }
+};
+
+template<>
+class Traits<Simulator>: public Traits<void>
+{
+public:
+    // Virtual time at start: 2025-06-01 09:00 UTC, where the datasets begin
+    static const unsigned long long START_US = 1748768400000000ULL;
+    // Each node's clock starts up to CLOCK_OFFSET_US off and runs up to CLOCK_SKEW_PPM fast or slow
+    static const unsigned int CLOCK_OFFSET_US = 5000;
+    static const unsigned int CLOCK_SKEW_PPM = 50;
+    // Simulated vehicles: status broadcast period and time spent in each quadrant
+    static const unsigned int STATUS_PERIOD_US = 100000;
+    static const unsigned int QUADRANT_DWELL_US = 1000000;
+};
+
+template<>
+class Traits<ChannelModel>: public Traits<void>
+{
+public:
+    // Default link of every quadrant (roughly 802.11p at its lowest rate)
+    static const unsigned int LATENCY_US = 100;
+    static const unsigned int JITTER_US = 20;
+    static const unsigned int LOSS_PPM = 10000;
+    static const unsigned long long BANDWIDTH_BPS = 6000000;
+};
+
+template<>
+class Traits<DatasetCursor>: public Traits<void>
+{
+public:
+    // Rows are 100 ms apart; a longer gap is a recording pause, not motion to interpolate
+    static const long long MAX_GAP_US = 1000000;
+};
+
+#endif // TRAITS_H
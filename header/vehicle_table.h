@@ -1,21 +1,50 @@
 #ifndef VEHICLE_TABLE
 #define VEHICLE_TABLE
 
-#include <vector>
-#include <random>
+#include <cstdint>
 
 #include "traits.h"
 #include "ethernet.h"
+#include "u64_type.h"
 #include "console_logger.h"
 
+// Vehicles an RSU has seen in its quadrant, keyed by MAC48.
+// Open-addressed (linear probing, bounded to MAX_PROBE slots) with a last-seen
+// timestamp per entry. Entries are never removed eagerly: one older than
+// TTL_US reads as absent and its slot is reused by the next insert that
+// probes over it. Slots never return to empty, so a bounded probe that stops
+// at an empty slot cannot miss a key. When every slot in the probe window
+// holds a live vehicle, the least recently seen one is evicted.
 class VehicleTable {
 public:
+    static const unsigned int CAPACITY = Traits<VehicleTable>::CAPACITY;
+    static const unsigned int MAX_PROBE = Traits<VehicleTable>::MAX_PROBE;
+    static const U64 TTL_US = Traits<VehicleTable>::TTL_US;
+
     VehicleTable();
-    bool check_vehicle(Ethernet::Address* address);
-    void set_vehicle(std::array<unsigned char, ETH_ALEN> address);
+
+    // True if the vehicle was seen within TTL_US of `now`; refreshes its timestamp
+    bool check_vehicle(const Ethernet::Address* address, U64 now);
+    void set_vehicle(const Ethernet::Address* address, U64 now);
+
+    // Live vehicles as of `now` (walks the whole table)
+    unsigned int size(U64 now) const;
+    unsigned long evictions() const { return _evictions; }
 
 private:
-    std::vector<std::array<unsigned char, ETH_ALEN>> _vehicles;
+    struct Entry {
+        uint64_t key;       // MAC48 | USED, 0 when the slot was never used
+        U64 last_seen;
+    };
+
+    static const uint64_t USED = 1ULL << 48;
+
+    static uint64_t key_of(const Ethernet::Address* address);
+    static unsigned int home_of(uint64_t key);
+    bool live(const Entry& entry, U64 now) const { return now - entry.last_seen < TTL_US; }
+
+    Entry _entries[CAPACITY];
+    unsigned long _evictions;
 };
 
-#endif // VEHICLE_TABLE
\ No newline at end of file
+#endif // VEHICLE_TABLE
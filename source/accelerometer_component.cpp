@@ -1,22 +1,32 @@
 #include "../header/component/accelerometer_component.h"
+#include "../header/dataset_service.h"
 #include <chrono>
 
 void AccelerometerComponent::run() 
 {
-    ConsoleLogger::log("About to generate Accelerometer data");
+    LOG_DEBUG("About to generate Accelerometer data");
     generate_data();
-    ConsoleLogger::log("Accelerometer data generation completed");
+    LOG_DEBUG("Accelerometer data generation completed");
 }
 
 AccelerometerComponent::AccelerometerComponent(AutonomousAgent* autonomous_agent, const unsigned short& id, int dataset_id)
-    : Component(autonomous_agent, id) {
+    : Component(autonomous_agent, id), _value(0), _initial_time(0), _dataset(nullptr), _acceleration(-1) {
     // SI unit: meter => m+1 => 0b101 (5) => m+4 = 9
     _data_type = ComponentDataTypes::ACCELERATION_DATA_TYPE;
 
-    _reader = new CSVReader("dataset/dynamics-vehicle_"+ std::to_string(dataset_id) + ".csv");
-    _reader->read_row(_row);
-
-    _initial_time = _row["timestamp"].get<U64>();
+    _dataset = DatasetService::get(dataset_id);
+    // Built from the CSVs by `make datasets`
+    if (!_dataset && _own.open(Dataset::path(dataset_id))) {
+        _dataset = &_own;
+    }
+    if (_dataset) {
+        _cursor.reset(_dataset);
+        _acceleration = _dataset->column("acceleration");
+        _initial_time = _dataset->first_timestamp();
+    }
+    if (_acceleration < 0 || !_cursor.valid()) {
+        ConsoleLogger::error("AccelerometerComponent: no acceleration data for dataset " + std::to_string(dataset_id));
+    }
     _local_initial_time = _autonomous_agent->nic()->get_local_timestamp();
 }
 
@@ -24,9 +34,11 @@ void AccelerometerComponent::generate_data() {
     auto timestamp_now = _autonomous_agent->nic()->get_local_timestamp();
     auto dataset_timestamp = (timestamp_now - _local_initial_time) + _initial_time;
 
-    _value = _row["acceleration"].get<double>();
-    ConsoleLogger::log("Accelerometer data generated: " + std::to_string(_value) + " - Simulated timestamp: " + std::to_string(dataset_timestamp));
-    _reader->read_row(_row); 
+    // The sample for the synchronized time, whatever the period since the last one
+    if (_acceleration >= 0 && _cursor.valid()) {
+        _value = _cursor.sample(static_cast<unsigned int>(_acceleration), dataset_timestamp);
+    }
+    LOG_DEBUG("Accelerometer data generated: {} - Simulated timestamp: {}", _value.load(), dataset_timestamp);
 }
 
 void AccelerometerComponent::set_interests() {
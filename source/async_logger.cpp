@@ -0,0 +1,284 @@
+#include "../header/async_logger.h"
+#include "../header/fast_clock.h"
+#include "../header/thread_placement.h"
+
+#include <chrono>
+#include <sstream>
+#include <new>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+const char AsyncLogger::MAGIC[8] = {'V', '2', 'X', 'B', 'L', 'O', 'G', '1'};
+const unsigned char AsyncLogger::FORMAT_ENTRY;
+const unsigned char AsyncLogger::RECORD_ENTRY;
+const unsigned char AsyncLogger::DROPPED_ENTRY;
+
+std::mutex AsyncLogger::_mutex;
+std::vector<AsyncLogger::Ring*> AsyncLogger::_rings;
+std::vector<AsyncLogger::Format> AsyncLogger::_formats;
+size_t AsyncLogger::_written_formats = 0;
+std::atomic<unsigned long> AsyncLogger::_dropped(0);
+unsigned long AsyncLogger::_written_dropped = 0;
+std::atomic<bool> AsyncLogger::_running(false);
+bool AsyncLogger::_closed = false;
+unsigned int AsyncLogger::_generation = 1;
+int AsyncLogger::_fd = -1;
+std::thread AsyncLogger::_thread;
+thread_local AsyncLogger::Handle AsyncLogger::_handle;
+
+static void append(std::vector<unsigned char>& out, const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    out.insert(out.end(), bytes, bytes + size);
+}
+
+void AsyncLogger::init() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _closed = false;
+    if (!_running.load()) start();
+}
+
+void AsyncLogger::close() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_running.load()) return;
+        _closed = true;
+        _running.store(false);
+    }
+
+    if (_thread.joinable()) _thread.join();
+    drain_once();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_fd >= 0) {
+        ::close(_fd);
+        _fd = -1;
+    }
+}
+
+unsigned short AsyncLogger::format(Level level, const char* file, int line, const char* text) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    Format f = {level, file, line, text};
+    _formats.push_back(f);
+    return static_cast<unsigned short>(_formats.size() - 1);
+}
+
+AsyncLogger::Ring* AsyncLogger::attach() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_closed) return nullptr;
+    if (!_running.load()) start();
+
+    Ring* ring = new Ring();
+    _rings.push_back(ring);
+
+    _handle.ring = ring;
+    _handle.thread = static_cast<uint32_t>(syscall(SYS_gettid));
+    _handle.generation = _generation;
+    return ring;
+}
+
+// Called with _mutex held
+void AsyncLogger::start() {
+    static bool registered = false;
+    if (!registered) {
+        pthread_atfork(&AsyncLogger::prepare_fork, &AsyncLogger::parent_after_fork, &AsyncLogger::child_after_fork);
+        atexit(&AsyncLogger::close);
+        registered = true;
+    }
+
+    mkdir("logs", 0755);
+    std::stringstream filename;
+    filename << "logs/process_" << getpid() << ".blog";
+    _fd = open(filename.str().c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (_fd < 0) {
+        filename.str("");
+        filename << "process_" << getpid() << ".blog";
+        _fd = open(filename.str().c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    }
+
+    std::vector<unsigned char> header;
+    uint32_t pid = getpid();
+    append(header, MAGIC, sizeof(MAGIC));
+    append(header, &pid, sizeof(pid));
+    flush(header);
+
+    _written_formats = 0;
+    _written_dropped = 0;
+    _running.store(true);
+    _thread = std::thread(&AsyncLogger::drain);
+}
+
+void AsyncLogger::drain() {
+    ThreadPlacement::Guard placement(ThreadPlacement::LOGGER, "logger");
+    while (_running.load()) {
+        if (drain_once() == 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(static_cast<long>(Traits<AsyncLogger>::DRAIN_INTERVAL_US)));
+        }
+    }
+}
+
+size_t AsyncLogger::drain_once() {
+    std::vector<Ring*> rings;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        rings = _rings;
+    }
+
+    // Records first: any format they reference is registered by now
+    std::vector<unsigned char> records;
+    size_t count = 0;
+    for (Ring* ring : rings) {
+        const Record* record;
+        while ((record = ring->front()) != nullptr) {
+            records.push_back(RECORD_ENTRY);
+            append(records, record, RECORD_HEADER_SIZE + record->size);
+            ring->pop();
+            count++;
+        }
+    }
+
+    std::vector<unsigned char> out;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (; _written_formats < _formats.size(); _written_formats++) {
+            const Format& f = _formats[_written_formats];
+            uint16_t id = static_cast<uint16_t>(_written_formats);
+            uint8_t level = f.level;
+            uint16_t line = static_cast<uint16_t>(f.line);
+            uint16_t file_length = static_cast<uint16_t>(strlen(f.file));
+            uint16_t text_length = static_cast<uint16_t>(strlen(f.text));
+
+            out.push_back(FORMAT_ENTRY);
+            append(out, &id, sizeof(id));
+            append(out, &level, sizeof(level));
+            append(out, &line, sizeof(line));
+            append(out, &file_length, sizeof(file_length));
+            append(out, f.file, file_length);
+            append(out, &text_length, sizeof(text_length));
+            append(out, f.text, text_length);
+        }
+
+        // Rings of finished threads are released once empty
+        for (auto it = _rings.begin(); it != _rings.end();) {
+            if ((*it)->retired() && !(*it)->front()) {
+                delete *it;
+                it = _rings.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    out.insert(out.end(), records.begin(), records.end());
+
+    unsigned long dropped = _dropped.load(std::memory_order_relaxed);
+    if (dropped != _written_dropped) {
+        uint64_t total = dropped;
+        out.push_back(DROPPED_ENTRY);
+        append(out, &total, sizeof(total));
+        _written_dropped = dropped;
+    }
+
+    flush(out);
+    return count;
+}
+
+void AsyncLogger::flush(std::vector<unsigned char>& out) {
+    size_t offset = 0;
+    while (_fd >= 0 && offset < out.size()) {
+        ssize_t written = ::write(_fd, out.data() + offset, out.size() - offset);
+        if (written <= 0) break;
+        offset += written;
+    }
+}
+
+U64 AsyncLogger::timestamp() {
+    return FastClock::system_us();
+}
+
+void AsyncLogger::prepare_fork() {
+    _mutex.lock();
+}
+
+void AsyncLogger::parent_after_fork() {
+    _mutex.unlock();
+}
+
+// Only the forking thread survives: drop the parent's rings, thread and file
+void AsyncLogger::child_after_fork() {
+    _rings.clear();
+    _generation++;
+    _written_formats = 0;
+    _written_dropped = 0;
+    _dropped.store(0);
+    _running.store(false);
+    _closed = false;
+    new (&_thread) std::thread();
+    if (_fd >= 0) {
+        ::close(_fd);
+        _fd = -1;
+    }
+    _mutex.unlock();
+}
+
+const char* AsyncLogger::level_name(Level level) {
+    switch (level) {
+        case TRACE: return "TRACE";
+        case DEBUG: return "DEBUG";
+        case INFO: return "INFO";
+        case WARNING: return "WARNING";
+        case ERROR: return "ERROR";
+    }
+    return "?";
+}
+
+std::string AsyncLogger::render(const char* text, const unsigned char* args, unsigned int argc, unsigned int size) {
+    std::stringstream ss;
+    unsigned int offset = 0;
+    unsigned int used = 0;
+
+    for (const char* c = text; *c; ++c) {
+        if (c[0] != '{' || c[1] != '}' || used == argc || offset >= size) {
+            ss << *c;
+            continue;
+        }
+        ++c;
+        used++;
+
+        unsigned char type = args[offset++];
+        switch (type) {
+            case INT: {
+                int64_t v;
+                memcpy(&v, args + offset, sizeof(v));
+                offset += sizeof(v);
+                ss << v;
+                break;
+            }
+            case UINT: {
+                uint64_t v;
+                memcpy(&v, args + offset, sizeof(v));
+                offset += sizeof(v);
+                ss << v;
+                break;
+            }
+            case DOUBLE: {
+                double v;
+                memcpy(&v, args + offset, sizeof(v));
+                offset += sizeof(v);
+                ss << v;
+                break;
+            }
+            case STRING: {
+                unsigned char length = args[offset++];
+                ss.write(reinterpret_cast<const char*>(args + offset), length);
+                offset += length;
+                break;
+            }
+            default:
+                return ss.str();
+        }
+    }
+
+    return ss.str();
+}
@@ -19,4 +19,8 @@ AutonomousAgent::~AutonomousAgent() {}
 
 EthernetNIC* AutonomousAgent::nic() const { 
     return _nic; 
+}
+
+EthernetProtocol* AutonomousAgent::protocol() const {
+    return _protocol;
 }
\ No newline at end of file
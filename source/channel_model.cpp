@@ -0,0 +1,57 @@
+#include "../header/channel_model.h"
+
+#include "../header/simulator.h"
+
+ChannelModel::ChannelModel() {
+    Link link = {Traits<ChannelModel>::LATENCY_US, Traits<ChannelModel>::JITTER_US,
+                 Traits<ChannelModel>::LOSS_PPM, Traits<ChannelModel>::BANDWIDTH_BPS};
+    for (unsigned int i = 0; i <= QUADRANTS; i++) {
+        _links[i] = link;
+    }
+    reset();
+}
+
+void ChannelModel::reset() {
+    for (unsigned int i = 0; i <= QUADRANTS; i++) {
+        _busy_until[i] = 0;
+        _statistics[i] = Statistics{0, 0, 0, 0};
+    }
+}
+
+unsigned int ChannelModel::index(unsigned int quadrant) const {
+    return quadrant <= QUADRANTS ? quadrant : 0;
+}
+
+void ChannelModel::set_link(unsigned int quadrant, const Link& link) {
+    _links[index(quadrant)] = link;
+}
+
+const ChannelModel::Link& ChannelModel::link(unsigned int quadrant) const {
+    return _links[index(quadrant)];
+}
+
+U64 ChannelModel::transmit(unsigned int quadrant, unsigned int bytes, U64 now) {
+    unsigned int i = index(quadrant);
+    U64 start = _busy_until[i] > now ? _busy_until[i] : now;
+    U64 airtime = _links[i].bandwidth_bps ? static_cast<U64>(bytes) * 8 * 1000000 / _links[i].bandwidth_bps : 0;
+    _busy_until[i] = start + airtime;
+    _statistics[i].frames++;
+    _statistics[i].queued_us += start - now;
+    return _busy_until[i];
+}
+
+bool ChannelModel::arrival(unsigned int quadrant, U64 sent, U64& at) {
+    unsigned int i = index(quadrant);
+    const Link& link = _links[i];
+    if (Simulator::chance(link.loss_ppm)) {
+        _statistics[i].lost++;
+        return false;
+    }
+    at = sent + link.latency_us + Simulator::uniform(0, link.jitter_us);
+    _statistics[i].deliveries++;
+    return true;
+}
+
+ChannelModel::Statistics ChannelModel::statistics(unsigned int quadrant) const {
+    return _statistics[index(quadrant)];
+}
@@ -0,0 +1,118 @@
+#include "../header/clock_estimator.h"
+
+#include <algorithm>
+#include <cmath>
+
+const unsigned int ClockEstimator::WINDOW;
+const unsigned int ClockEstimator::MIN_SAMPLES;
+
+ClockEstimator::ClockEstimator() : _accepted(0), _rejected(0) {
+    reset();
+}
+
+void ClockEstimator::reset() {
+    _head = 0;
+    _count = 0;
+    _reference = 0;
+    _offset = 0;
+    _skew = 0;
+    _mean_time = 0;
+    _sxx = 0;
+    _sigma = 0;
+    _jitter = 0;
+    _last_update = 0;
+    _consecutive_rejects = 0;
+}
+
+bool ClockEstimator::add(U64 system_timestamp, U64 local_timestamp) {
+    double offset = static_cast<double>(system_timestamp - local_timestamp);
+
+    if (_count >= MIN_SAMPLES) {
+        double residual = offset - offset_at(local_timestamp);
+        double gate = std::max(Traits<TimeKeeper>::OUTLIER_SIGMAS * _jitter, static_cast<double>(Traits<TimeKeeper>::OUTLIER_FLOOR_US));
+        if (std::fabs(residual) > gate) {
+            _rejected++;
+            if (++_consecutive_rejects < WINDOW / 2) {
+                return false;
+            }
+            // Persistent disagreement: the reference clock stepped
+            reset();
+        }
+    }
+    _consecutive_rejects = 0;
+
+    _samples[_head].local = local_timestamp;
+    _samples[_head].offset = offset;
+    _head = (_head + 1) % WINDOW;
+    if (_count < WINDOW) _count++;
+
+    _last_update = local_timestamp;
+    _accepted++;
+    fit();
+    return true;
+}
+
+void ClockEstimator::fit() {
+    // Oldest sample in the window is the time origin, keeping the doubles small
+    unsigned int oldest = (_head + WINDOW - _count) % WINDOW;
+    _reference = _samples[oldest].local;
+
+    double sum_t = 0, sum_x = 0;
+    for (unsigned int i = 0; i < _count; i++) {
+        sum_t += static_cast<double>(_samples[i].local - _reference);
+        sum_x += _samples[i].offset;
+    }
+    _mean_time = sum_t / _count;
+    double mean_x = sum_x / _count;
+
+    double sxx = 0, sxy = 0;
+    for (unsigned int i = 0; i < _count; i++) {
+        double t = static_cast<double>(_samples[i].local - _reference) - _mean_time;
+        sxx += t * t;
+        sxy += t * (_samples[i].offset - mean_x);
+    }
+    _sxx = sxx;
+    _skew = (_count >= MIN_SAMPLES && sxx > 0) ? sxy / sxx : 0;
+    // Jitter over a short window can fake any slope; real oscillators stay within MAX_SKEW_PPM
+    double max_skew = Traits<TimeKeeper>::MAX_SKEW_PPM * 1e-6;
+    _skew = std::max(-max_skew, std::min(max_skew, _skew));
+    _offset = mean_x - _skew * _mean_time;
+
+    double residuals[WINDOW];
+    double sum_squares = 0;
+    for (unsigned int i = 0; i < _count; i++) {
+        double r = _samples[i].offset - (_offset + _skew * static_cast<double>(_samples[i].local - _reference));
+        sum_squares += r * r;
+        residuals[i] = std::fabs(r);
+    }
+    _sigma = _count > 2 ? std::sqrt(sum_squares / (_count - 2)) : 0;
+
+    std::nth_element(residuals, residuals + _count / 2, residuals + _count);
+    _jitter = 1.4826 * residuals[_count / 2];
+}
+
+double ClockEstimator::offset_at(U64 local_timestamp) const {
+    return _offset + _skew * static_cast<double>(local_timestamp - _reference);
+}
+
+double ClockEstimator::error_at(U64 local_timestamp) const {
+    if (_count < MIN_SAMPLES || _sxx <= 0) {
+        return HUGE_VAL;
+    }
+    // Prediction error of the fitted line: grows away from the window centre
+    double t = static_cast<double>(local_timestamp - _reference) - _mean_time;
+    return 3 * _sigma * std::sqrt(1.0 / _count + t * t / _sxx);
+}
+
+ClockEstimator::Quality ClockEstimator::quality(U64 local_timestamp) const {
+    Quality quality;
+    quality.samples = _count;
+    quality.accepted = _accepted;
+    quality.rejected = _rejected;
+    quality.offset_us = fitted() ? offset_at(local_timestamp) : 0;
+    quality.skew_ppm = _skew * 1e6;
+    quality.jitter_us = _jitter;
+    quality.error_us = error_at(local_timestamp);
+    quality.age_us = fitted() ? local_timestamp - _last_update : -1;
+    return quality;
+}
@@ -3,7 +3,7 @@
 
 Component::Component(AutonomousAgent* autonomous_agent, const unsigned short& id)
     : _id(id), _running(false), _semaphore(0), _autonomous_agent(autonomous_agent) {
-        _smart_data = new SmartData(_autonomous_agent->nic()->address(), id);
+        _smart_data = new SmartData(_autonomous_agent->protocol(), _autonomous_agent->nic()->address(), id);
     }
 
 Component::~Component() {
@@ -29,6 +29,7 @@ void Component::start() {
             static_cast<__u64>(std::chrono::microseconds(100 * 1000).count()),
             static_cast<__u64>(std::chrono::microseconds(400).count())
         );
+    _running_thread->set_label("component " + std::to_string(_id));
     _running_thread->start();
 
     _smart_data->start();
@@ -37,11 +38,11 @@ void Component::start() {
 void Component::stop() {
     _running = false;
 
-    ConsoleLogger::log("COMPONENT: STOPPING RUNNING THREAD");
+    LOG_INFO("COMPONENT: STOPPING RUNNING THREAD");
     if (_running_thread != nullptr) {
         delete _running_thread;
     }
-    ConsoleLogger::log("COMPONENT: STOPPING SMART DATA");
+    LOG_INFO("COMPONENT: STOPPING SMART DATA");
     delete _smart_data;
 }
 
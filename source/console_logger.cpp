@@ -66,6 +66,14 @@ void ConsoleLogger::log(const std::string& message) {
     //std::cout << "[" << timestamp << "] - " << "[PID:" << getpid() << "] " << "[THREAD ID:" << std::to_string(pthread_self()) << "] " << message << std::endl;
 }
 
+void ConsoleLogger::log(AsyncLogger::Level level, const std::string& message) {
+    //std::lock_guard<std::mutex> lock_guard(thread_mutex);
+    if (!log_file.is_open()) init();
+
+    std::string timestamp = get_current_timestamp();
+    log_file << "[" << timestamp << "] - " << "[PID:" << getpid() << "] " << "[THREAD ID:" << std::to_string(pthread_self()) << "] " << "[" << AsyncLogger::level_name(level) << "] " << message << std::endl;
+}
+
 void ConsoleLogger::print(const std::string& message) {
     //std::lock_guard<std::mutex> lock_guard(thread_mutex);
     if (!log_file.is_open()) init();
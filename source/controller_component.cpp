@@ -2,9 +2,9 @@
 
 void ControllerComponent::run() 
 {
-    ConsoleLogger::log("Controller processing and generating commands");
+    LOG_DEBUG("Controller processing and generating commands");
     generate_data();
-    ConsoleLogger::log("Command generation completed");
+    LOG_DEBUG("Command generation completed");
 }
 
 ControllerComponent::ControllerComponent(AutonomousAgent* autonomous_agent, const unsigned short& id)
@@ -23,7 +23,7 @@ void ControllerComponent::generate_data() {
     }
     
     _value = steering_angle;
-    ConsoleLogger::log("Controller generated command: " + std::to_string(_value));
+    LOG_DEBUG("Controller generated command: {}", _value.load());
 }
 
 void ControllerComponent::set_interests() {
@@ -72,23 +72,20 @@ void ControllerComponent::process_data(Message::ResponseMessage* data, const uns
     
     if (data_type == (ComponentDataTypes::METER_DATATYPE)) {
         _lidar_value = data->value;
-        ConsoleLogger::log("Received Lidar data: " + std::to_string(_lidar_value));
+        LOG_DEBUG("Received Lidar data: {}", _lidar_value);
     } else if (data_type == (ComponentDataTypes::POSITION_DATA_TYPE)) {
         // GPS data
         if (is_internal) {
             // Own GPS data
             _gps_value = data->value;
-            ConsoleLogger::log("Received GPS data: " + std::to_string(_gps_value));
+            LOG_DEBUG("Received GPS data: {}", _gps_value);
         } else {
             // External GPS data
             _external_gps_value = data->value;
-            ConsoleLogger::log("Received external GPS data: " + std::to_string(_external_gps_value));
+            LOG_DEBUG("Received external GPS data: {}", _external_gps_value);
         }
     }
 
-    ConsoleLogger::log("Controller Component: Message info received: Origin MAC address -> " + mac_to_string(message_info.origin_mac) +
-        "; Origin ID -> " + std::to_string(message_info.origin_id) +
-        "; Timestamp -> " + std::to_string(message_info.timestamp) + 
-        "; Quadrant -> " + std::to_string(message_info.quadrant) +
-        "; MAC -> " + std::to_string(message_info.mac));
+    LOG_DEBUG("Controller Component: Message info received: Origin MAC address -> {}; Origin ID -> {}; Timestamp -> {}; Quadrant -> {}; MAC -> {}",
+        mac_to_string(message_info.origin_mac), message_info.origin_id, message_info.timestamp, message_info.quadrant, message_info.mac);
 }
@@ -0,0 +1,243 @@
+#include "../header/dataset.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "../header/csv.hpp"
+#include "../header/console_logger.h"
+
+const char Dataset::MAGIC[8] = {'V', '2', 'X', 'D', 'A', 'T', 'A', '1'};
+const uint32_t Dataset::VERSION;
+const unsigned int Dataset::NAME_SIZE;
+const unsigned int Dataset::ALIGNMENT;
+
+Dataset::Dataset() : _mapped(false), _map(nullptr), _size(0), _header(nullptr), _descriptors(nullptr) {}
+
+Dataset::~Dataset() {
+    close();
+}
+
+bool Dataset::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        ConsoleLogger::error("Dataset: cannot open " + path);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0 || static_cast<size_t>(st.st_size) < sizeof(Header)) {
+        ConsoleLogger::error("Dataset: " + path + " is too short");
+        ::close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        ConsoleLogger::error("Dataset: cannot map " + path);
+        return false;
+    }
+    if (!validate(map, size, path)) {
+        munmap(map, size);
+        return false;
+    }
+    _mapped = true;
+    return true;
+}
+
+bool Dataset::view(const void* data, size_t size) {
+    close();
+    return data && size >= sizeof(Header) && validate(data, size, "memory");
+}
+
+bool Dataset::validate(const void* data, size_t size, const std::string& source) {
+    // Check every descriptor up front so accessors only check the type
+    const Header* header = static_cast<const Header*>(data);
+    const Descriptor* descriptors = reinterpret_cast<const Descriptor*>(header + 1);
+    bool valid = memcmp(header->magic, MAGIC, sizeof(MAGIC)) == 0 && header->version == VERSION &&
+                 header->columns > 0 && header->rows < size &&
+                 sizeof(Header) + header->columns * sizeof(Descriptor) <= size;
+    for (uint32_t i = 0; valid && i < header->columns; i++) {
+        const Descriptor& d = descriptors[i];
+        valid = d.type <= REAL && d.offset % ALIGNMENT == 0 && d.offset <= size &&
+                header->rows * sizeof(uint64_t) <= size - d.offset &&
+                memchr(d.name, '\0', NAME_SIZE) != nullptr;
+    }
+    valid = valid && strcmp(descriptors[0].name, "timestamp") == 0 && descriptors[0].type == INTEGER;
+    if (!valid) {
+        ConsoleLogger::error("Dataset: " + source + " is not a valid dataset");
+        return false;
+    }
+
+    _map = const_cast<void*>(data);
+    _size = size;
+    _header = header;
+    _descriptors = descriptors;
+    return true;
+}
+
+void Dataset::close() {
+    if (_mapped) {
+        munmap(_map, _size);
+    }
+    _mapped = false;
+    _map = nullptr;
+    _size = 0;
+    _header = nullptr;
+    _descriptors = nullptr;
+}
+
+int Dataset::column(const std::string& name) const {
+    for (unsigned int i = 0; i < columns(); i++) {
+        if (name == _descriptors[i].name) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+std::string Dataset::name(unsigned int column) const {
+    return column < columns() ? std::string(_descriptors[column].name) : std::string();
+}
+
+Dataset::Type Dataset::type(unsigned int column) const {
+    return column < columns() ? static_cast<Type>(_descriptors[column].type) : INTEGER;
+}
+
+const void* Dataset::column_data(unsigned int column, Type type) const {
+    if (column >= columns() || _descriptors[column].type != static_cast<uint32_t>(type)) {
+        return nullptr;
+    }
+    return static_cast<const char*>(_map) + _descriptors[column].offset;
+}
+
+const U64* Dataset::integers(unsigned int column) const {
+    return static_cast<const U64*>(column_data(column, INTEGER));
+}
+
+const double* Dataset::reals(unsigned int column) const {
+    return static_cast<const double*>(column_data(column, REAL));
+}
+
+static uint64_t align(uint64_t offset) {
+    return (offset + Dataset::ALIGNMENT - 1) / Dataset::ALIGNMENT * Dataset::ALIGNMENT;
+}
+
+bool Dataset::encode(const std::string& csv_path, std::vector<char>& binary) {
+    std::vector<std::string> names;
+    std::vector<Type> types;
+    // Column-major while reading: each column is written as one block
+    std::vector<std::vector<uint64_t>> values;
+
+    try {
+        csv::CSVReader reader(csv_path);
+        std::vector<std::string> csv_names = reader.get_col_names();
+        std::vector<size_t> order;
+        for (size_t i = 0; i < csv_names.size(); i++) {
+            if (csv_names[i] == "timestamp") {
+                order.insert(order.begin(), i);
+            } else {
+                order.push_back(i);
+            }
+        }
+        if (order.empty() || csv_names[order[0]] != "timestamp") {
+            ConsoleLogger::error("Dataset: " + csv_path + " has no timestamp column");
+            return false;
+        }
+        for (size_t i : order) {
+            if (csv_names[i].size() >= NAME_SIZE) {
+                ConsoleLogger::error("Dataset: column name too long: " + csv_names[i]);
+                return false;
+            }
+            names.push_back(csv_names[i]);
+            types.push_back(csv_names[i] == "timestamp" || csv_names[i] == "id" ? INTEGER : REAL);
+        }
+        values.resize(names.size());
+
+        for (csv::CSVRow& row : reader) {
+            for (size_t c = 0; c < order.size(); c++) {
+                csv::CSVField field = row[order[c]];
+                uint64_t bits = 0;
+                if (types[c] == INTEGER) {
+                    if (!field.is_int()) {
+                        ConsoleLogger::error("Dataset: " + csv_path + ": " + names[c] + " is not an integer");
+                        return false;
+                    }
+                    U64 value = field.get<U64>();
+                    memcpy(&bits, &value, sizeof(bits));
+                } else {
+                    double value = field.is_num() ? field.get<double>() : std::numeric_limits<double>::quiet_NaN();
+                    memcpy(&bits, &value, sizeof(bits));
+                }
+                values[c].push_back(bits);
+            }
+        }
+    } catch (const std::exception& e) {
+        ConsoleLogger::error("Dataset: cannot read " + csv_path + ": " + e.what());
+        return false;
+    }
+
+    Header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.columns = static_cast<uint32_t>(names.size());
+    header.rows = values[0].size();
+    const U64* timestamps = reinterpret_cast<const U64*>(values[0].data());
+    header.first_timestamp = header.rows ? timestamps[0] : 0;
+    header.last_timestamp = header.rows ? timestamps[header.rows - 1] : 0;
+
+    std::vector<Descriptor> descriptors(names.size());
+    uint64_t offset = align(sizeof(Header) + descriptors.size() * sizeof(Descriptor));
+    for (size_t c = 0; c < names.size(); c++) {
+        memset(&descriptors[c], 0, sizeof(Descriptor));
+        strncpy(descriptors[c].name, names[c].c_str(), NAME_SIZE - 1);
+        descriptors[c].type = types[c];
+        descriptors[c].offset = offset;
+        offset = align(offset + header.rows * sizeof(uint64_t));
+    }
+
+    // Padding between columns stays zero
+    binary.assign(offset, 0);
+    memcpy(binary.data(), &header, sizeof(header));
+    memcpy(binary.data() + sizeof(header), descriptors.data(), descriptors.size() * sizeof(Descriptor));
+    for (size_t c = 0; c < names.size(); c++) {
+        memcpy(binary.data() + descriptors[c].offset, values[c].data(), values[c].size() * sizeof(uint64_t));
+    }
+    return true;
+}
+
+bool Dataset::convert(const std::string& csv_path, const std::string& binary_path) {
+    std::vector<char> binary;
+    if (!encode(csv_path, binary)) {
+        return false;
+    }
+
+    std::string temporary = binary_path + ".tmp";
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        ConsoleLogger::error("Dataset: cannot write " + temporary);
+        return false;
+    }
+    out.write(binary.data(), binary.size());
+    out.close();
+    if (!out || rename(temporary.c_str(), binary_path.c_str()) != 0) {
+        ConsoleLogger::error("Dataset: cannot write " + binary_path);
+        unlink(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+std::string Dataset::path(int dataset_id, const std::string& directory, const std::string& extension) {
+    return directory + "/perception-vehicle_" + std::to_string(dataset_id) + extension;
+}
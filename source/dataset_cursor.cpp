@@ -0,0 +1,125 @@
+#include "../header/dataset_cursor.h"
+
+#include <cmath>
+#include <limits>
+
+const U64 DatasetCursor::MAX_GAP_US;
+const unsigned int DatasetCursor::KINEMATICS;
+
+static const char* const KINEMATICS_COLUMNS[] = {"x", "y", "speed", "heading", "yawrate", "acceleration"};
+
+DatasetCursor::DatasetCursor(const Dataset* dataset, Interpolation interpolation) : _interpolation(interpolation) {
+    reset(dataset);
+}
+
+void DatasetCursor::reset(const Dataset* dataset) {
+    _dataset = dataset && dataset->rows() > 0 ? dataset : nullptr;
+    _timestamps = _dataset ? _dataset->timestamps() : nullptr;
+    _rows = _dataset ? _dataset->rows() : 0;
+    _row = 0;
+    _heading = _dataset ? _dataset->column("heading") : -1;
+    for (unsigned int i = 0; i < KINEMATICS; i++) {
+        _kinematics[i] = _dataset ? _dataset->column(KINEMATICS_COLUMNS[i]) : -1;
+    }
+}
+
+uint64_t DatasetCursor::seek(U64 timestamp) {
+    if (!_timestamps) {
+        return 0;
+    }
+
+    // Gallop to a bracket [low, high) with _timestamps[low] <= timestamp < _timestamps[high]
+    uint64_t low, high;
+    uint64_t step = 1;
+    if (_timestamps[_row] <= timestamp) {
+        low = _row;
+        high = low + 1;
+        while (high < _rows && _timestamps[high] <= timestamp) {
+            low = high;
+            step *= 2;
+            high = low + step;
+        }
+        if (high > _rows) {
+            high = _rows;
+        }
+    } else {
+        high = _row;
+        low = high > 0 ? high - 1 : 0;
+        while (low > 0 && _timestamps[low] > timestamp) {
+            high = low;
+            step *= 2;
+            low = high > step ? high - step : 0;
+        }
+        if (_timestamps[low] > timestamp) {
+            // Before the first row
+            _row = 0;
+            return _row;
+        }
+    }
+
+    while (high - low > 1) {
+        uint64_t middle = low + (high - low) / 2;
+        if (_timestamps[middle] <= timestamp) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+    _row = low;
+    return _row;
+}
+
+double DatasetCursor::value(unsigned int column, double weight) const {
+    const double* values = _dataset->reals(column);
+    if (!values) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    double current = values[_row];
+    if (weight <= 0) {
+        return current;
+    }
+    double difference = values[_row + 1] - current;
+    if (static_cast<int>(column) == _heading) {
+        difference = std::remainder(difference, 2 * M_PI);
+    }
+    return current + weight * difference;
+}
+
+void DatasetCursor::sample(const unsigned int* columns, unsigned int count, U64 timestamp, double* values) {
+    if (!_dataset) {
+        for (unsigned int i = 0; i < count; i++) {
+            values[i] = std::numeric_limits<double>::quiet_NaN();
+        }
+        return;
+    }
+
+    seek(timestamp);
+    double weight = 0;
+    if (_interpolation == LINEAR && _row + 1 < _rows && timestamp > _timestamps[_row]) {
+        U64 span = _timestamps[_row + 1] - _timestamps[_row];
+        if (span <= static_cast<U64>(MAX_GAP_US)) {
+            weight = static_cast<double>(timestamp - _timestamps[_row]) / static_cast<double>(span);
+        }
+    }
+    for (unsigned int i = 0; i < count; i++) {
+        values[i] = value(columns[i], weight);
+    }
+}
+
+double DatasetCursor::sample(unsigned int column, U64 timestamp) {
+    double value;
+    sample(&column, 1, timestamp, &value);
+    return value;
+}
+
+bool DatasetCursor::kinematics(U64 timestamp, Kinematics& kinematics) {
+    unsigned int columns[KINEMATICS];
+    for (unsigned int i = 0; i < KINEMATICS; i++) {
+        if (_kinematics[i] < 0) {
+            return false;
+        }
+        columns[i] = static_cast<unsigned int>(_kinematics[i]);
+    }
+    sample(columns, KINEMATICS, timestamp, reinterpret_cast<double*>(&kinematics));
+    return true;
+}
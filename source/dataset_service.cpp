@@ -0,0 +1,161 @@
+#include "../header/dataset_service.h"
+
+#include <cstring>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "../header/console_logger.h"
+
+struct DatasetService::State {
+    void* map;
+    size_t size;
+    std::vector<Dataset*> datasets;
+
+    State() : map(nullptr), size(0) {}
+};
+
+DatasetService::State& DatasetService::state() {
+    static State* state = new State();
+    return *state;
+}
+
+static bool read_file(const std::string& path, std::vector<char>& data) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    bool ok = fstat(fd, &st) == 0;
+    if (ok) {
+        data.resize(static_cast<size_t>(st.st_size));
+        size_t done = 0;
+        while (ok && done < data.size()) {
+            ssize_t n = read(fd, data.data() + done, data.size() - done);
+            ok = n > 0;
+            done += ok ? static_cast<size_t>(n) : 0;
+        }
+    }
+    close(fd);
+    return ok;
+}
+
+// A sealed memfd (or an unlinked shm object on old kernels) holding `data`
+static int shared_file(const std::vector<char>& data) {
+    int fd = memfd_create("v2x-datasets", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    bool sealable = fd >= 0;
+    if (fd < 0) {
+        std::string name = "/v2x-datasets-" + std::to_string(getpid());
+        fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+        shm_unlink(name.c_str());
+        if (fd < 0) {
+            return -1;
+        }
+    }
+
+    size_t done = 0;
+    while (done < data.size()) {
+        ssize_t n = write(fd, data.data() + done, data.size() - done);
+        if (n <= 0) {
+            close(fd);
+            return -1;
+        }
+        done += static_cast<size_t>(n);
+    }
+    if (sealable && fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) < 0) {
+        ConsoleLogger::error("DatasetService: cannot seal the shared datasets");
+    }
+    return fd;
+}
+
+bool DatasetService::load(const std::string& directory) {
+    unload();
+    State& s = state();
+
+    // Datasets back to back, each on a cache line as Dataset expects
+    std::vector<char> data;
+    std::vector<size_t> offsets;
+    std::vector<size_t> sizes;
+    for (int id = 0;; id++) {
+        // The converted file if it is usable, otherwise parse the CSV here, once
+        std::vector<char> binary;
+        Dataset check;
+        if (!read_file(Dataset::path(id, directory), binary) || !check.view(binary.data(), binary.size())) {
+            std::string csv_path = Dataset::path(id, directory, ".csv");
+            if (access(csv_path.c_str(), R_OK) != 0 || !Dataset::encode(csv_path, binary)) {
+                break;
+            }
+        }
+        size_t offset = (data.size() + Dataset::ALIGNMENT - 1) / Dataset::ALIGNMENT * Dataset::ALIGNMENT;
+        data.resize(offset + binary.size());
+        memcpy(data.data() + offset, binary.data(), binary.size());
+        offsets.push_back(offset);
+        sizes.push_back(binary.size());
+    }
+    if (offsets.empty()) {
+        ConsoleLogger::error("DatasetService: no datasets in " + directory);
+        return false;
+    }
+
+    int fd = shared_file(data);
+    if (fd < 0) {
+        ConsoleLogger::error("DatasetService: cannot create the shared datasets");
+        return false;
+    }
+    void* map = mmap(nullptr, data.size(), PROT_READ, MAP_SHARED | MAP_POPULATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        ConsoleLogger::error("DatasetService: cannot map the shared datasets");
+        return false;
+    }
+    s.map = map;
+    s.size = data.size();
+
+    for (size_t i = 0; i < offsets.size(); i++) {
+        Dataset* dataset = new Dataset();
+        if (!dataset->view(static_cast<const char*>(map) + offsets[i], sizes[i])) {
+            delete dataset;
+            unload();
+            return false;
+        }
+        s.datasets.push_back(dataset);
+    }
+    ConsoleLogger::log("DatasetService: " + std::to_string(s.datasets.size()) + " datasets, " +
+                       std::to_string(s.size) + " bytes shared");
+    return true;
+}
+
+void DatasetService::unload() {
+    State& s = state();
+    for (Dataset* dataset : s.datasets) {
+        delete dataset;
+    }
+    s.datasets.clear();
+    if (s.map) {
+        munmap(s.map, s.size);
+    }
+    s.map = nullptr;
+    s.size = 0;
+}
+
+bool DatasetService::loaded() {
+    return !state().datasets.empty();
+}
+
+unsigned int DatasetService::count() {
+    return static_cast<unsigned int>(state().datasets.size());
+}
+
+size_t DatasetService::bytes() {
+    return state().size;
+}
+
+const Dataset* DatasetService::get(int id) {
+    State& s = state();
+    if (s.datasets.empty() || id < 0) {
+        return nullptr;
+    }
+    return s.datasets[static_cast<size_t>(id) % s.datasets.size()];
+}
@@ -0,0 +1,166 @@
+#include "../header/fast_clock.h"
+
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#define HAS_TSC 1
+#else
+#define HAS_TSC 0
+#endif
+
+namespace {
+
+U64 clock_ns(clockid_t clock) {
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return static_cast<U64>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+uint64_t read_tsc() {
+#if HAS_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+bool invariant_tsc() {
+#if HAS_TSC
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) || eax < 0x80000007) {
+        return false;
+    }
+    __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+    return (edx & (1u << 8)) != 0;
+#else
+    return false;
+#endif
+}
+
+}
+
+struct FastClock::State {
+    std::atomic<int> source;
+
+    // TSC -> CLOCK_MONOTONIC: base_ns + ((tsc - base_tsc) * mult) >> 32
+    bool tsc_usable;
+    uint64_t base_tsc;
+    U64 base_ns;
+    uint64_t mult;
+
+    // CLOCK_REALTIME - monotonic_ns(), and when to measure it again
+    std::atomic<long long> realtime_offset_ns;
+    std::atomic<long long> next_resync_ns;
+
+    State() : source(MONOTONIC), tsc_usable(false), base_tsc(0), base_ns(0), mult(0),
+              realtime_offset_ns(0), next_resync_ns(0) {
+        if (invariant_tsc()) {
+            // Rate measured over CALIBRATION_US against CLOCK_MONOTONIC_RAW (not slewed by NTP)
+            U64 start_ns = clock_ns(CLOCK_MONOTONIC_RAW);
+            uint64_t start_tsc = read_tsc();
+            struct timespec pause = {0, static_cast<long>(Traits<FastClock>::CALIBRATION_US) * 1000};
+            nanosleep(&pause, nullptr);
+            U64 end_ns = clock_ns(CLOCK_MONOTONIC_RAW);
+            uint64_t end_tsc = read_tsc();
+
+            if (end_tsc > start_tsc && end_ns > start_ns) {
+                mult = static_cast<uint64_t>((static_cast<unsigned __int128>(end_ns - start_ns) << 32) / (end_tsc - start_tsc));
+                base_tsc = read_tsc();
+                base_ns = clock_ns(CLOCK_MONOTONIC);
+                tsc_usable = true;
+                source = TSC;
+            }
+        }
+        resync(*this, read_ns(*this));
+    }
+};
+
+FastClock::State& FastClock::state() {
+    static State state;
+    return state;
+}
+
+U64 FastClock::read_ns(const State& state) {
+    switch (state.source.load(std::memory_order_relaxed)) {
+        case TSC: {
+            uint64_t delta = read_tsc() - state.base_tsc;
+            return state.base_ns + static_cast<U64>((static_cast<unsigned __int128>(delta) * state.mult) >> 32);
+        }
+        case MONOTONIC_COARSE:
+            return clock_ns(CLOCK_MONOTONIC_COARSE);
+        default:
+            return clock_ns(CLOCK_MONOTONIC);
+    }
+}
+
+// Realtime is read between two fast reads; the midpoint halves the read cost error
+void FastClock::resync(State& state, U64 now_ns) {
+    U64 before = read_ns(state);
+    U64 realtime = clock_ns(CLOCK_REALTIME);
+    U64 after = read_ns(state);
+    state.realtime_offset_ns.store(realtime - (before + (after - before) / 2), std::memory_order_relaxed);
+    state.next_resync_ns.store(now_ns + static_cast<U64>(Traits<FastClock>::RESYNC_INTERVAL_US) * 1000, std::memory_order_relaxed);
+}
+
+U64 FastClock::monotonic_ns() {
+    return read_ns(state());
+}
+
+U64 FastClock::system_us() {
+    State& s = state();
+    U64 now = read_ns(s);
+    long long due = s.next_resync_ns.load(std::memory_order_relaxed);
+    // One caller wins the deadline and re-measures; the rest keep the current offset
+    if (now >= due && s.next_resync_ns.compare_exchange_strong(due, now + static_cast<U64>(Traits<FastClock>::RESYNC_INTERVAL_US) * 1000)) {
+        resync(s, now);
+    }
+    return (now + s.realtime_offset_ns.load(std::memory_order_relaxed)) / 1000;
+}
+
+FastClock::Source FastClock::source() {
+    return static_cast<Source>(state().source.load(std::memory_order_relaxed));
+}
+
+bool FastClock::supports(Source source) {
+    return source != TSC || state().tsc_usable;
+}
+
+bool FastClock::use(Source source) {
+    if (!supports(source)) {
+        return false;
+    }
+    State& s = state();
+    s.source.store(source, std::memory_order_relaxed);
+    // The new source may not start where the old one was: re-anchor now
+    resync(s, read_ns(s));
+    return true;
+}
+
+const char* FastClock::source_name(Source source) {
+    switch (source) {
+        case TSC: return "TSC";
+        case MONOTONIC: return "MONOTONIC";
+        case MONOTONIC_COARSE: return "MONOTONIC_COARSE";
+    }
+    return "UNKNOWN";
+}
+
+U64 FastClock::resolution_ns() {
+    State& s = state();
+    switch (source()) {
+        case TSC:
+            return s.mult >> 32 ? static_cast<U64>(s.mult >> 32) : 1;
+        case MONOTONIC_COARSE: {
+            struct timespec ts;
+            clock_getres(CLOCK_MONOTONIC_COARSE, &ts);
+            return static_cast<U64>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+        }
+        default: {
+            struct timespec ts;
+            clock_getres(CLOCK_MONOTONIC, &ts);
+            return static_cast<U64>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+        }
+    }
+}
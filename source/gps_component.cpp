@@ -3,9 +3,9 @@
 
 void GPSComponent::run() 
 {
-    ConsoleLogger::log("About to generate GPS data");
+    LOG_DEBUG("About to generate GPS data");
     generate_data();
-    ConsoleLogger::log("GPS data generation completed");
+    LOG_DEBUG("GPS data generation completed");
 }
 
 GPSComponent::GPSComponent(AutonomousAgent* autonamous_agent, const unsigned short& id)
@@ -17,8 +17,7 @@ GPSComponent::GPSComponent(AutonomousAgent* autonamous_agent, const unsigned sho
 void GPSComponent::generate_data() {    
     _value = static_cast<int>(getpid());
     
-    ConsoleLogger::log("GPS data generated: Lat: " + std::to_string(_value) + 
-                      ", Long: " + std::to_string(_value));
+    LOG_DEBUG("GPS data generated: Lat: {}, Long: {}", _value.load(), _value.load());
 }
 
 void GPSComponent::set_interests() {
@@ -26,9 +25,6 @@ void GPSComponent::set_interests() {
 
 void GPSComponent::process_data(Message::ResponseMessage* data, const unsigned int id) {
     Ethernet::MessageInfo message_info = get_message_info(id);
-    ConsoleLogger::log("GPS Component: Message info received: Origin MAC address -> " + mac_to_string(message_info.origin_mac) +
-        "; Origin ID -> " + std::to_string(message_info.origin_id) +
-        "; Timestamp -> " + std::to_string(message_info.timestamp) + 
-        "; Quadrant -> " + std::to_string(message_info.quadrant) +
-        "; MAC -> " + std::to_string(message_info.mac));
+    LOG_DEBUG("GPS Component: Message info received: Origin MAC address -> {}; Origin ID -> {}; Timestamp -> {}; Quadrant -> {}; MAC -> {}",
+        mac_to_string(message_info.origin_mac), message_info.origin_id, message_info.timestamp, message_info.quadrant, message_info.mac);
 }
\ No newline at end of file
@@ -2,9 +2,9 @@
 
 void LidarComponent::run() 
 {
-    ConsoleLogger::log("About to generate Lidar data");
+    LOG_DEBUG("About to generate Lidar data");
     generate_data();
-    ConsoleLogger::log("Lidar data generation completed");
+    LOG_DEBUG("Lidar data generation completed");
 }
 
 LidarComponent::LidarComponent(AutonomousAgent* autonomous_agent, const unsigned short& id)
@@ -19,7 +19,7 @@ void LidarComponent::generate_data() {
     std::uniform_int_distribution<> dist(1, 100); // Lidar range in meters
 
     _value = dist(gen);
-    ConsoleLogger::log("Lidar data generated: " + std::to_string(_value));
+    LOG_DEBUG("Lidar data generated: {}", _value.load());
 }
 
 void LidarComponent::set_interests() {
@@ -27,11 +27,8 @@ void LidarComponent::set_interests() {
 
 void LidarComponent::process_data(Message::ResponseMessage* data, const unsigned int id) {
     Ethernet::MessageInfo message_info = get_message_info(id);
-    ConsoleLogger::log("Lidar Component: Message info received: Origin MAC address -> " + mac_to_string(message_info.origin_mac) +
-        "; Origin ID -> " + std::to_string(message_info.origin_id) +
-        "; Timestamp -> " + std::to_string(message_info.timestamp) + 
-        "; Quadrant -> " + std::to_string(message_info.quadrant) +
-        "; MAC -> " + std::to_string(message_info.mac));
+    LOG_DEBUG("Lidar Component: Message info received: Origin MAC address -> {}; Origin ID -> {}; Timestamp -> {}; Quadrant -> {}; MAC -> {}",
+        mac_to_string(message_info.origin_mac), message_info.origin_id, message_info.timestamp, message_info.quadrant, message_info.mac);
 }
 
 
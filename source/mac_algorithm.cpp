@@ -0,0 +1,470 @@
+#include "../header/mac_algorithm.h"
+
+#include <stdexcept>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define MAC_ALGORITHM_X86
+#include <immintrin.h>
+#endif
+
+const size_t XorFoldMAC::MAX_MAC_BYTE_SIZE;
+const size_t SipHashMAC::LANES;
+const size_t NHUniversalMAC::BLOCK_SIZE;
+const size_t NHUniversalMAC::CHUNK_SIZE;
+const size_t NHUniversalMAC::KEY_WORDS;
+
+static const size_t FOLD_BLOCK = XorFoldMAC::MAX_MAC_BYTE_SIZE;
+
+// Domains for extend_key, so no two algorithms share key material
+static const uint64_t SIPHASH_KEY_DOMAIN = 1;
+static const uint64_t NH_KEY_DOMAIN = 2;
+static const uint64_t NH_FINALIZE_DOMAIN = 3;
+
+static inline uint64_t load_le64(const unsigned char* p) {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+#else
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; --i) v = (v << 8) | p[i];
+    return v;
+#endif
+}
+
+static inline uint32_t load_le32(const unsigned char* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+/* ---------------------------------- Kernels --------------------------------- */
+
+// XOR fold: XOR `blocks` consecutive 32-byte blocks into the 32 lanes
+
+static void fold_scalar(const unsigned char* data, size_t blocks, unsigned char* lanes) {
+    uint64_t acc[4];
+    memcpy(acc, lanes, sizeof(acc));
+    for (size_t b = 0; b < blocks; ++b, data += FOLD_BLOCK) {
+        uint64_t word[4];
+        memcpy(word, data, sizeof(word));
+        acc[0] ^= word[0];
+        acc[1] ^= word[1];
+        acc[2] ^= word[2];
+        acc[3] ^= word[3];
+    }
+    memcpy(lanes, acc, sizeof(acc));
+}
+
+// NH: sum of (m[2i] + k[2i]) * (m[2i+1] + k[2i+1]) over 32-bit little-endian words, mod 2^64
+
+static uint64_t nh_scalar(const unsigned char* data, size_t blocks, const uint32_t* key) {
+    uint64_t sum = 0;
+    for (size_t b = 0; b < blocks; ++b, data += NHUniversalMAC::BLOCK_SIZE, key += 8) {
+        for (size_t i = 0; i < 8; i += 2) {
+            uint32_t a = load_le32(data + 4 * i) + key[i];
+            uint32_t c = load_le32(data + 4 * i + 4) + key[i + 1];
+            sum += static_cast<uint64_t>(a) * c;
+        }
+    }
+    return sum;
+}
+
+#ifdef MAC_ALGORITHM_X86
+__attribute__((target("sse2")))
+static void fold_sse2(const unsigned char* data, size_t blocks, unsigned char* lanes) {
+    __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes));
+    __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes + 16));
+    for (size_t b = 0; b < blocks; ++b, data += FOLD_BLOCK) {
+        low = _mm_xor_si128(low, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data)));
+        high = _mm_xor_si128(high, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16)));
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), low);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes + 16), high);
+}
+
+__attribute__((target("avx2")))
+static void fold_avx2(const unsigned char* data, size_t blocks, unsigned char* lanes) {
+    __m256i acc = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lanes));
+    for (size_t b = 0; b < blocks; ++b, data += FOLD_BLOCK) {
+        acc = _mm256_xor_si256(acc, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)));
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), acc);
+}
+
+// Word pairs sit in the low/high halves of each 64-bit lane, so one
+// pmuludq against the lane shifted right by 32 yields every pair product
+__attribute__((target("sse2")))
+static uint64_t nh_sse2(const unsigned char* data, size_t blocks, const uint32_t* key) {
+    __m128i acc = _mm_setzero_si128();
+    for (size_t b = 0; b < blocks; ++b, data += NHUniversalMAC::BLOCK_SIZE, key += 8) {
+        __m128i low = _mm_add_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)),
+                                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(key)));
+        __m128i high = _mm_add_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16)),
+                                     _mm_loadu_si128(reinterpret_cast<const __m128i*>(key + 4)));
+        acc = _mm_add_epi64(acc, _mm_mul_epu32(low, _mm_srli_epi64(low, 32)));
+        acc = _mm_add_epi64(acc, _mm_mul_epu32(high, _mm_srli_epi64(high, 32)));
+    }
+    uint64_t lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    return lanes[0] + lanes[1];
+}
+
+__attribute__((target("avx2")))
+static uint64_t nh_avx2(const unsigned char* data, size_t blocks, const uint32_t* key) {
+    __m256i acc = _mm256_setzero_si256();
+    for (size_t b = 0; b < blocks; ++b, data += NHUniversalMAC::BLOCK_SIZE, key += 8) {
+        __m256i x = _mm256_add_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)),
+                                     _mm256_loadu_si256(reinterpret_cast<const __m256i*>(key)));
+        acc = _mm256_add_epi64(acc, _mm256_mul_epu32(x, _mm256_srli_epi64(x, 32)));
+    }
+    uint64_t lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+#endif
+
+/* --------------------------------- SipHash ---------------------------------- */
+
+class SipState
+{
+public:
+    SipState(const uint64_t key[2]) :
+        _v0(key[0] ^ 0x736f6d6570736575ULL), _v1(key[1] ^ 0x646f72616e646f6dULL),
+        _v2(key[0] ^ 0x6c7967656e657261ULL), _v3(key[1] ^ 0x7465646279746573ULL) {}
+
+    // Resumes from a state left by the batch kernel
+    SipState(uint64_t v0, uint64_t v1, uint64_t v2, uint64_t v3) : _v0(v0), _v1(v1), _v2(v2), _v3(v3) {}
+
+    void compress(uint64_t m) {
+        _v3 ^= m;
+        round();
+        round();
+        _v0 ^= m;
+    }
+
+    uint64_t finalize(uint64_t last) {
+        compress(last);
+        _v2 ^= 0xff;
+        round();
+        round();
+        round();
+        round();
+        return _v0 ^ _v1 ^ _v2 ^ _v3;
+    }
+
+private:
+    static inline uint64_t rotl(uint64_t x, int b) { return (x << b) | (x >> (64 - b)); }
+
+    void round() {
+        _v0 += _v1; _v1 = rotl(_v1, 13); _v1 ^= _v0; _v0 = rotl(_v0, 32);
+        _v2 += _v3; _v3 = rotl(_v3, 16); _v3 ^= _v2;
+        _v0 += _v3; _v3 = rotl(_v3, 21); _v3 ^= _v0;
+        _v2 += _v1; _v1 = rotl(_v1, 17); _v1 ^= _v2; _v2 = rotl(_v2, 32);
+    }
+
+    uint64_t _v0, _v1, _v2, _v3;
+};
+
+// Absorbs the remaining whole words and the tail of one message
+static uint64_t sip_finish(SipState& state, const unsigned char* data, size_t length, size_t offset) {
+    for (; offset + 8 <= length; offset += 8) {
+        state.compress(load_le64(data + offset));
+    }
+
+    uint64_t last = static_cast<uint64_t>(length & 0xff) << 56;
+    for (size_t i = 0; offset + i < length; i++) {
+        last |= static_cast<uint64_t>(data[offset + i]) << (8 * i);
+    }
+    return state.finalize(last);
+}
+
+#ifdef MAC_ALGORITHM_X86
+__attribute__((target("avx2")))
+static inline __m256i rotl_x4(__m256i x, int b) {
+    return _mm256_or_si256(_mm256_slli_epi64(x, b), _mm256_srli_epi64(x, 64 - b));
+}
+
+__attribute__((target("avx2")))
+static inline void sip_round_x4(__m256i& v0, __m256i& v1, __m256i& v2, __m256i& v3) {
+    v0 = _mm256_add_epi64(v0, v1); v1 = rotl_x4(v1, 13); v1 = _mm256_xor_si256(v1, v0); v0 = _mm256_shuffle_epi32(v0, 0xb1);
+    v2 = _mm256_add_epi64(v2, v3); v3 = rotl_x4(v3, 16); v3 = _mm256_xor_si256(v3, v2);
+    v0 = _mm256_add_epi64(v0, v3); v3 = rotl_x4(v3, 21); v3 = _mm256_xor_si256(v3, v0);
+    v2 = _mm256_add_epi64(v2, v1); v1 = rotl_x4(v1, 17); v1 = _mm256_xor_si256(v1, v2); v2 = _mm256_shuffle_epi32(v2, 0xb1);
+}
+
+// Four messages in the 64-bit lanes: the words all of them have are compressed
+// in lockstep, each lane then finishes on its own
+__attribute__((target("avx2")))
+static void siphash_x4(const uint64_t key[2], const unsigned char* const* data, const size_t* lengths, uint64_t* out) {
+    const size_t lanes = SipHashMAC::LANES;
+    size_t common = lengths[0] / 8;
+    for (size_t l = 1; l < lanes; l++) {
+        if (lengths[l] / 8 < common) common = lengths[l] / 8;
+    }
+
+    __m256i v0 = _mm256_set1_epi64x(static_cast<long long>(key[0] ^ 0x736f6d6570736575ULL));
+    __m256i v1 = _mm256_set1_epi64x(static_cast<long long>(key[1] ^ 0x646f72616e646f6dULL));
+    __m256i v2 = _mm256_set1_epi64x(static_cast<long long>(key[0] ^ 0x6c7967656e657261ULL));
+    __m256i v3 = _mm256_set1_epi64x(static_cast<long long>(key[1] ^ 0x7465646279746573ULL));
+
+    for (size_t w = 0; w < common; w++) {
+        __m256i m = _mm256_set_epi64x(static_cast<long long>(load_le64(data[3] + 8 * w)),
+                                      static_cast<long long>(load_le64(data[2] + 8 * w)),
+                                      static_cast<long long>(load_le64(data[1] + 8 * w)),
+                                      static_cast<long long>(load_le64(data[0] + 8 * w)));
+        v3 = _mm256_xor_si256(v3, m);
+        sip_round_x4(v0, v1, v2, v3);
+        sip_round_x4(v0, v1, v2, v3);
+        v0 = _mm256_xor_si256(v0, m);
+    }
+
+    uint64_t s0[4], s1[4], s2[4], s3[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(s0), v0);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(s1), v1);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(s2), v2);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(s3), v3);
+
+    for (size_t l = 0; l < lanes; l++) {
+        SipState state(s0[l], s1[l], s2[l], s3[l]);
+        out[l] = sip_finish(state, data[l], lengths[l], 8 * common);
+    }
+}
+#endif
+
+/* -------------------------------- MACAlgorithm ------------------------------ */
+
+MACAlgorithm* MACAlgorithm::create(Type type, size_t mac_byte_size) {
+    switch (type) {
+        case XOR_FOLD: return new XorFoldMAC(mac_byte_size);
+        case SIPHASH_2_4: return new SipHashMAC();
+        case NH_UNIVERSAL: return new NHUniversalMAC();
+    }
+    throw std::invalid_argument("MACAlgorithm: unknown type " + std::to_string(type));
+}
+
+const char* MACAlgorithm::type_name(Type type) {
+    switch (type) {
+        case XOR_FOLD: return "xor-fold";
+        case SIPHASH_2_4: return "siphash-2-4";
+        case NH_UNIVERSAL: return "nh-universal";
+    }
+    return "?";
+}
+
+bool MACAlgorithm::supports(Implementation implementation) {
+    switch (implementation) {
+        case SCALAR:
+            return true;
+#ifdef MAC_ALGORITHM_X86
+        case SSE2:
+            return __builtin_cpu_supports("sse2");
+        case AVX2:
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return false;
+    }
+}
+
+MACAlgorithm::Implementation MACAlgorithm::best_implementation() {
+    if (supports(AVX2)) return AVX2;
+    if (supports(SSE2)) return SSE2;
+    return SCALAR;
+}
+
+const char* MACAlgorithm::implementation_name(Implementation implementation) {
+    switch (implementation) {
+        case SCALAR: return "scalar";
+        case SSE2: return "sse2";
+        case AVX2: return "avx2";
+    }
+    return "?";
+}
+
+// splitmix64 stream seeded by key and domain
+void MACAlgorithm::extend_key(const Ethernet::MAC_KEY& key, uint64_t domain, uint64_t* words, size_t count) {
+    uint64_t state = load_le64(key.data()) ^ (domain * 0xd1b54a32d192ed03ULL);
+    for (size_t i = 0; i < count; i++) {
+        state += 0x9e3779b97f4a7c15ULL;
+        uint64_t z = state;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        words[i] = z ^ (z >> 31);
+    }
+}
+
+/* --------------------------------- XorFoldMAC ------------------------------- */
+
+XorFoldMAC::XorFoldMAC(size_t mac_byte_size) : _mac_byte_size(mac_byte_size), _key() {
+    if (mac_byte_size == 0 || mac_byte_size > MAX_MAC_BYTE_SIZE) {
+        throw std::invalid_argument("XorFoldMAC: MAC size must be between 1 and " + std::to_string(MAX_MAC_BYTE_SIZE) + " bytes");
+    }
+    use(best_implementation());
+}
+
+void XorFoldMAC::set_key(const Ethernet::MAC_KEY& key) {
+    _key = key;
+}
+
+bool XorFoldMAC::use(Implementation implementation) {
+    if (!supports(implementation)) {
+        return false;
+    }
+    _implementation = implementation;
+    switch (implementation) {
+#ifdef MAC_ALGORITHM_X86
+        case SSE2: _fold = &fold_sse2; break;
+        case AVX2: _fold = &fold_avx2; break;
+#endif
+        default: _fold = &fold_scalar; break;
+    }
+    return true;
+}
+
+uint32_t XorFoldMAC::compute(const unsigned char* data, size_t length) const {
+    unsigned char mac_buffer[MAX_MAC_BYTE_SIZE] = {0};
+    size_t i = 0;
+
+    // Whole blocks go through the kernel when byte i lands on lane i % 32 == i % _mac_byte_size
+    if (FOLD_BLOCK % _mac_byte_size == 0 && length >= FOLD_BLOCK) {
+        unsigned char lanes[FOLD_BLOCK] = {0};
+        size_t blocks = length / FOLD_BLOCK;
+        _fold(data, blocks, lanes);
+        // _mac_byte_size divides 32, so it is a power of two: halve the lanes down to it
+        for (size_t width = FOLD_BLOCK / 2; width >= _mac_byte_size; width /= 2) {
+            for (size_t lane = 0; lane < width; ++lane) {
+                lanes[lane] ^= lanes[lane + width];
+            }
+        }
+        memcpy(mac_buffer, lanes, _mac_byte_size);
+        i = blocks * FOLD_BLOCK;
+    }
+
+    size_t position = i % _mac_byte_size;
+    for (; i < length; ++i) {
+        mac_buffer[position] ^= data[i];
+        if (++position == _mac_byte_size) position = 0;
+    }
+
+    for (size_t k = 0; k < Ethernet::MAC_BYTE_SIZE; ++k) {
+        mac_buffer[k % _mac_byte_size] ^= _key[k];
+    }
+
+    uint32_t result_mac = mac_buffer[0];
+    for (size_t k = 1; k < _mac_byte_size; ++k) {
+        result_mac = (result_mac << 8) | mac_buffer[k];
+    }
+
+    return result_mac;
+}
+
+/* --------------------------------- SipHashMAC ------------------------------- */
+
+SipHashMAC::SipHashMAC() {
+    _key[0] = _key[1] = 0;
+    use(supports(AVX2) ? AVX2 : SCALAR);
+}
+
+// One message has no parallelism to exploit, so only the batch kernel is vectorized
+bool SipHashMAC::use(Implementation implementation) {
+    if (implementation == SSE2 || !supports(implementation)) {
+        return false;
+    }
+    _implementation = implementation;
+    return true;
+}
+
+void SipHashMAC::compute_batch(const unsigned char* const* data, const size_t* lengths, uint32_t* tags, size_t n) const {
+    size_t i = 0;
+#ifdef MAC_ALGORITHM_X86
+    if (_implementation == AVX2) {
+        for (; i + LANES <= n; i += LANES) {
+            // Short frames do not amortize moving the state in and out of the vector lanes
+            size_t shortest = lengths[i];
+            for (size_t l = 1; l < LANES; l++) {
+                if (lengths[i + l] < shortest) shortest = lengths[i + l];
+            }
+            if (shortest < 128) {
+                for (size_t l = 0; l < LANES; l++) tags[i + l] = compute(data[i + l], lengths[i + l]);
+                continue;
+            }
+
+            uint64_t out[LANES];
+            siphash_x4(_key, data + i, lengths + i, out);
+            for (size_t l = 0; l < LANES; l++) tags[i + l] = static_cast<uint32_t>(out[l]);
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        tags[i] = compute(data[i], lengths[i]);
+    }
+}
+
+void SipHashMAC::set_key(const Ethernet::MAC_KEY& key) {
+    extend_key(key, SIPHASH_KEY_DOMAIN, _key, 2);
+}
+
+uint32_t SipHashMAC::compute(const unsigned char* data, size_t length) const {
+    return static_cast<uint32_t>(siphash(_key, data, length));
+}
+
+uint64_t SipHashMAC::siphash(const uint64_t key[2], const unsigned char* data, size_t length) {
+    SipState state(key);
+    return sip_finish(state, data, length, 0);
+}
+
+/* ------------------------------- NHUniversalMAC ----------------------------- */
+
+NHUniversalMAC::NHUniversalMAC() {
+    memset(_nh_key, 0, sizeof(_nh_key));
+    _finalize_key[0] = _finalize_key[1] = 0;
+    use(best_implementation());
+}
+
+void NHUniversalMAC::set_key(const Ethernet::MAC_KEY& key) {
+    uint64_t words[KEY_WORDS / 2];
+    extend_key(key, NH_KEY_DOMAIN, words, KEY_WORDS / 2);
+    for (size_t i = 0; i < KEY_WORDS / 2; i++) {
+        _nh_key[2 * i] = static_cast<uint32_t>(words[i]);
+        _nh_key[2 * i + 1] = static_cast<uint32_t>(words[i] >> 32);
+    }
+    extend_key(key, NH_FINALIZE_DOMAIN, _finalize_key, 2);
+}
+
+bool NHUniversalMAC::use(Implementation implementation) {
+    if (!supports(implementation)) {
+        return false;
+    }
+    _implementation = implementation;
+    switch (implementation) {
+#ifdef MAC_ALGORITHM_X86
+        case SSE2: _nh = &nh_sse2; break;
+        case AVX2: _nh = &nh_avx2; break;
+#endif
+        default: _nh = &nh_scalar; break;
+    }
+    return true;
+}
+
+// SipHash over (NH(chunk_1) || ... || NH(chunk_n) || length); a partial last
+// block is zero padded, which the length makes unambiguous
+uint32_t NHUniversalMAC::compute(const unsigned char* data, size_t length) const {
+    SipState state(_finalize_key);
+
+    for (size_t offset = 0; offset < length; offset += CHUNK_SIZE) {
+        size_t chunk = length - offset < CHUNK_SIZE ? length - offset : CHUNK_SIZE;
+        size_t blocks = chunk / BLOCK_SIZE;
+        size_t rest = chunk % BLOCK_SIZE;
+
+        uint64_t hash = _nh(data + offset, blocks, _nh_key);
+        if (rest) {
+            unsigned char padded[BLOCK_SIZE] = {0};
+            memcpy(padded, data + offset + blocks * BLOCK_SIZE, rest);
+            hash += _nh(padded, 1, _nh_key + blocks * (BLOCK_SIZE / sizeof(uint32_t)));
+        }
+        state.compress(hash);
+    }
+
+    return static_cast<uint32_t>(state.finalize(static_cast<uint64_t>(length)));
+}
@@ -1,11 +1,25 @@
 #include "../header/mac_handler.h"
 
-MACHandler::MACHandler(size_t mac_size_bytes) : 
-    _key_is_set(false), _mac_byte_size(mac_size_bytes), _mac_key(std::array<unsigned char, Ethernet::MAC_BYTE_SIZE>()) {
+const size_t MACHandler::KEY_CONTEXTS;
+const size_t MACHandler::BATCH_GROUP;
+const size_t MACHandler::BOUND_SIZE;
+
+MACHandler::MACHandler(size_t mac_size_bytes, MACAlgorithm::Type algorithm) : 
+    _key_is_set(false), _mac_byte_size(mac_size_bytes), _mac_key(std::array<unsigned char, Ethernet::MAC_BYTE_SIZE>()),
+    _algorithm(MACAlgorithm::create(algorithm, mac_size_bytes)), _next_context(0) {
+}
+
+void MACHandler::set_algorithm(MACAlgorithm::Type algorithm) {
+    _algorithm.reset(MACAlgorithm::create(algorithm, _mac_byte_size));
+    _algorithm->set_key(_mac_key);
+    for (size_t i = 0; i < KEY_CONTEXTS; i++) {
+        _contexts[i].algorithm.reset();
+    }
 }
 
 void MACHandler::set_mac_key(Ethernet::MAC_KEY *key) {
     memcpy(&_mac_key, key, Ethernet::MAC_BYTE_SIZE);
+    _algorithm->set_key(_mac_key);
     _key_is_set = true;
 }
 
@@ -13,6 +27,18 @@ Ethernet::MAC_KEY* MACHandler::get_mac_key() {
     return &_mac_key;
 }
 
+Ethernet::MAC_KEY MACHandler::derive_epoch_key(const Ethernet::MAC_KEY& base, uint32_t epoch) {
+    // Domain "EPOC" in the high bytes keeps these apart from the algorithm key expansions
+    uint64_t word;
+    MACAlgorithm::extend_key(base, 0x45504f4300000000ULL | epoch, &word, 1);
+
+    Ethernet::MAC_KEY key;
+    for (size_t i = 0; i < Ethernet::MAC_BYTE_SIZE; i++) {
+        key[i] = static_cast<unsigned char>(word >> (8 * (i % 8)));
+    }
+    return key;
+}
+
 void MACHandler::create_mac_key() {
     Ethernet::MAC_KEY key;
 
@@ -39,34 +65,119 @@ uint32_t MACHandler::generate_mac(const unsigned char* data, size_t data_length)
         return 0;
     }
 
-    std::vector<unsigned char> mac_buffer(this->_mac_byte_size, 0);
+    return _algorithm->compute(data, data_length);
+}
+
+bool MACHandler::verify_mac(const unsigned char* data, size_t data_length, uint32_t received_mac) const {
+    if (!_key_is_set) {
+        return false; 
+    }
+
+    
+    uint32_t calculated_mac = generate_mac(data, data_length);
+    return calculated_mac == received_mac;
+}
 
-    for (size_t i = 0; i < data_length; ++i) {
-        mac_buffer[i % this->_mac_byte_size] ^= data[i];
+size_t MACHandler::bind(unsigned char* out, uint32_t sequence, uint32_t epoch, const unsigned char* data, size_t data_length) {
+    // Little endian on every host, like the key expansion
+    for (size_t i = 0; i < sizeof(uint32_t); i++) {
+        out[i] = static_cast<unsigned char>(sequence >> (8 * i));
+        out[sizeof(uint32_t) + i] = static_cast<unsigned char>(epoch >> (8 * i));
+    }
+    memcpy(out + BOUND_SIZE, data, data_length);
+    return BOUND_SIZE + data_length;
+}
+
+uint32_t MACHandler::generate_mac(uint32_t sequence, uint32_t epoch, const unsigned char* data, size_t data_length) const {
+    if (!_key_is_set) {
+        return 0;
     }
 
-    for (size_t i = 0; i < Ethernet::MAC_BYTE_SIZE; ++i) {
-        mac_buffer[i % this->_mac_byte_size] ^= _mac_key[i];
+    // Frames fit on the stack; anything larger takes the slow path
+    unsigned char stack[BOUND_SIZE + Ethernet::MTU];
+    std::vector<unsigned char> heap;
+    unsigned char* input = stack;
+    if (data_length > Ethernet::MTU) {
+        heap.resize(BOUND_SIZE + data_length);
+        input = heap.data();
     }
+    return _algorithm->compute(input, bind(input, sequence, epoch, data, data_length));
+}
 
-    uint32_t result_mac = 0;
-    if (!mac_buffer.empty()) {
-        result_mac = mac_buffer[0];
-        for (size_t i = 1; i < this->_mac_byte_size; ++i) {
-            result_mac = (result_mac << 8) | mac_buffer[i];
+const MACAlgorithm* MACHandler::context(const Ethernet::MAC_KEY& key) {
+    if (_key_is_set && key == _mac_key) {
+        return _algorithm.get();
+    }
+
+    for (size_t i = 0; i < KEY_CONTEXTS; i++) {
+        if (_contexts[i].algorithm && _contexts[i].key == key) {
+            return _contexts[i].algorithm.get();
         }
     }
-    
-    
-    return result_mac;
+
+    // Round-robin replacement: the working set is the few neighbouring quadrants
+    KeyContext& slot = _contexts[_next_context];
+    _next_context = (_next_context + 1) % KEY_CONTEXTS;
+
+    slot.key = key;
+    slot.algorithm.reset(MACAlgorithm::create(_algorithm->type(), _mac_byte_size));
+    slot.algorithm->use(_algorithm->implementation());
+    slot.algorithm->set_key(key);
+    return slot.algorithm.get();
 }
 
-bool MACHandler::verify_mac(const unsigned char* data, size_t data_length, uint32_t received_mac) const {
-    if (!_key_is_set) {
-        return false; 
+void MACHandler::verify_group(const MACAlgorithm* algorithm, Frame** group, size_t count) {
+    const unsigned char* data[BATCH_GROUP];
+    size_t lengths[BATCH_GROUP];
+    uint32_t tags[BATCH_GROUP];
+
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+        total += BOUND_SIZE + group[i]->length;
+    }
+    if (_bound.size() < total) {
+        _bound.resize(total);
     }
 
-    
-    uint32_t calculated_mac = generate_mac(data, data_length);
-    return calculated_mac == received_mac;
+    size_t offset = 0;
+    for (size_t i = 0; i < count; i++) {
+        data[i] = _bound.data() + offset;
+        lengths[i] = bind(_bound.data() + offset, group[i]->sequence, group[i]->epoch, group[i]->data, group[i]->length);
+        offset += lengths[i];
+    }
+    algorithm->compute_batch(data, lengths, tags, count);
+    for (size_t i = 0; i < count; i++) {
+        group[i]->valid = tags[i] == group[i]->mac;
+    }
+}
+
+size_t MACHandler::verify_batch(Frame* frames, size_t n) {
+    Frame* group[BATCH_GROUP];
+    size_t valid = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        // Frames sharing a key with an earlier one were verified with its group
+        bool seen = false;
+        for (size_t k = 0; k < i && !seen; k++) {
+            seen = frames[k].key == frames[i].key;
+        }
+        if (seen) continue;
+
+        const MACAlgorithm* algorithm = context(frames[i].key);
+        size_t count = 0;
+        for (size_t j = i; j < n; j++) {
+            if (frames[j].key != frames[i].key) continue;
+            group[count++] = &frames[j];
+            if (count == BATCH_GROUP) {
+                verify_group(algorithm, group, count);
+                count = 0;
+            }
+        }
+        if (count) verify_group(algorithm, group, count);
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        if (frames[i].valid) valid++;
+    }
+    return valid;
 }
\ No newline at end of file
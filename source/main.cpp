@@ -9,22 +9,196 @@
 #include <vector>
 #include <random>
 #include <pthread.h>
+#include <cstring>
 
 #include "../header/communicator.h"
 #include "../header/protocol.h"
 #include "../header/traits.h"
 #include "../header/ethernet.h"
 #include "../header/nic.h"
-#include "../header/raw_socket_engine.h"
+#include "../header/network_engine.h"
+#include "../header/async_logger.h"
 #include "../header/agent/vehicle.h"
 #include "../header/agent/rsu.h"
+#include "../header/agent/simulated_vehicle.h"
+#include "../header/simulator.h"
+#include "../header/channel_model.h"
+#include "../header/dataset_service.h"
 
 constexpr int MAX_RUNTIME_SECONDS = 5; // total simulation time for the parent process (e.g., 5 min)
 constexpr int SPAWN_INTERVAL_MS = 500;  // interval between spawns (in milliseconds)
 constexpr int MIN_LIFETIME = 4;         // min vehicle lifetime (in seconds)
 constexpr int MAX_LIFETIME = 6;         // max vehicle lifetime (in seconds)
 
-int main() {
+// --simulate: every agent is a set of threads in this process, talking over the
+// in-memory engine instead of one process per agent on the raw socket
+int simulate(unsigned int vehicles, const std::vector<Ethernet::MAC_KEY>& mac_key_vector) {
+    NetworkEngine::use(NetworkEngine::MEMORY);
+    std::string prefix = "SIM" + std::to_string(getpid());
+
+    std::vector<EthernetNIC*> nics;
+    std::vector<EthernetProtocol*> protocols;
+    std::vector<RSU*> rsus;
+    std::vector<Vehicle*> vehicle_agents;
+
+    for (unsigned short i = 0; i < Traits<RSU>::NUM_RSU; i++) {
+        EthernetNIC* nic = new EthernetNIC(prefix + "RSU" + std::to_string(i), i + 1);
+        EthernetProtocol* protocol = new EthernetProtocol(nic);
+        RSU* rsu = new RSU(nic, protocol, mac_key_vector);
+        nics.push_back(nic);
+        protocols.push_back(protocol);
+        rsus.push_back(rsu);
+        rsu->start();
+    }
+
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<> distrib(1, Traits<Vehicle>::NUM_RSU);
+    for (unsigned int i = 0; i < vehicles; i++) {
+        EthernetNIC* nic = new EthernetNIC(prefix + "VEH" + std::to_string(i), static_cast<unsigned short>(distrib(gen)));
+        EthernetProtocol* protocol = new EthernetProtocol(nic);
+        Vehicle* vehicle = new Vehicle(i, nic, protocol, MAX_RUNTIME_SECONDS);
+        nics.push_back(nic);
+        protocols.push_back(protocol);
+        vehicle_agents.push_back(vehicle);
+        vehicle->start();
+    }
+    ConsoleLogger::log("Simulating " + std::to_string(rsus.size()) + " RSUs and " + std::to_string(vehicles) + " vehicles in one process");
+
+    // Each vehicle's run() moves it across quadrants for its lifetime
+    std::vector<std::thread> runners;
+    for (Vehicle* vehicle : vehicle_agents) {
+        runners.push_back(std::thread(&Vehicle::run, vehicle));
+    }
+    for (std::thread& runner : runners) {
+        runner.join();
+    }
+
+    for (Vehicle* vehicle : vehicle_agents) {
+        vehicle->stop();
+        delete vehicle;
+    }
+    for (RSU* rsu : rsus) {
+        rsu->stop();
+        delete rsu;
+    }
+    for (EthernetProtocol* protocol : protocols) {
+        delete protocol;
+    }
+    for (EthernetNIC* nic : nics) {
+        delete nic;
+    }
+
+    ConsoleLogger::log("Simulation finished.");
+    AsyncLogger::close();
+    ConsoleLogger::close();
+    return 0;
+}
+
+// FNV-1a over the results, to compare runs with the same seed
+uint64_t digest(uint64_t hash, uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        hash = (hash ^ ((value >> (8 * i)) & 0xFF)) * 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+// --des: discrete-event run of `seconds` of virtual time. RSUs and simulated
+// vehicles share the in-memory engine, whose frames go through the channel
+// model; every timer is a simulator event, so one seed gives one result
+int simulate_events(unsigned int vehicles, unsigned int seconds, uint64_t seed) {
+    Simulator::start(seed);
+    NetworkEngine::use(NetworkEngine::MEMORY);
+    ChannelModel channel;
+    MemoryBus::shared().channel(&channel);
+
+    std::vector<Ethernet::MAC_KEY> mac_key_vector(Traits<RSU>::NUM_RSU);
+    for (Ethernet::MAC_KEY& key : mac_key_vector) {
+        for (size_t j = 0; j < Ethernet::MAC_BYTE_SIZE; ++j) {
+            key[j] = static_cast<unsigned char>(Simulator::random());
+        }
+    }
+
+    std::vector<EthernetNIC*> nics;
+    std::vector<EthernetProtocol*> protocols;
+    std::vector<RSU*> rsus;
+    std::vector<SimulatedVehicle*> vehicle_agents;
+
+    for (unsigned short i = 0; i < Traits<RSU>::NUM_RSU; i++) {
+        EthernetNIC* nic = new EthernetNIC("DES-RSU" + std::to_string(i), i + 1);
+        EthernetProtocol* protocol = new EthernetProtocol(nic);
+        RSU* rsu = new RSU(nic, protocol, mac_key_vector);
+        nics.push_back(nic);
+        protocols.push_back(protocol);
+        rsus.push_back(rsu);
+        rsu->start();
+    }
+    for (unsigned int i = 0; i < vehicles; i++) {
+        unsigned short quadrant = 1 + Simulator::random() % Traits<Vehicle>::NUM_RSU;
+        EthernetNIC* nic = new EthernetNIC("DES-VEH" + std::to_string(i), quadrant);
+        EthernetProtocol* protocol = new EthernetProtocol(nic);
+        SimulatedVehicle* vehicle = new SimulatedVehicle(i, nic, protocol);
+        nics.push_back(nic);
+        protocols.push_back(protocol);
+        vehicle_agents.push_back(vehicle);
+        vehicle->start();
+    }
+
+    auto wall_start = std::chrono::steady_clock::now();
+    Simulator::run_until(Simulator::start_us() + static_cast<U64>(seconds) * 1000000);
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    hash = digest(hash, Simulator::events_run());
+    unsigned long sent = 0, received = 0;
+    long long worst_error = 0;
+    for (SimulatedVehicle* vehicle : vehicle_agents) {
+        // Clock error against the RSU of the vehicle's quadrant
+        EthernetNIC* rsu_nic = rsus[vehicle->nic()->get_quadrant() - 1]->nic();
+        long long error = static_cast<long long>(vehicle->nic()->get_system_timestamp() - rsu_nic->get_system_timestamp());
+        if (std::llabs(error) > worst_error) worst_error = std::llabs(error);
+        sent += vehicle->sent();
+        received += vehicle->received();
+        hash = digest(digest(digest(hash, vehicle->sent()), vehicle->received()), static_cast<uint64_t>(error));
+    }
+    unsigned long frames = 0, lost = 0;
+    for (unsigned int q = 0; q <= ChannelModel::QUADRANTS; q++) {
+        ChannelModel::Statistics statistics = channel.statistics(q);
+        frames += statistics.frames;
+        lost += statistics.lost;
+        hash = digest(digest(hash, statistics.frames), statistics.lost);
+    }
+
+    std::cout << "DES: " << seconds << " s simulated in " << wall << " s (" << Simulator::events_run() << " events)" << std::endl;
+    std::cout << "DES: " << rsus.size() << " RSUs, " << vehicles << " vehicles, seed " << seed << std::endl;
+    std::cout << "DES: frames on air " << frames << ", receptions lost " << lost << std::endl;
+    std::cout << "DES: vehicle messages sent " << sent << ", received " << received << std::endl;
+    std::cout << "DES: worst vehicle clock error " << worst_error << " us" << std::endl;
+    std::cout << "DES: digest " << std::hex << hash << std::dec << std::endl;
+
+    for (SimulatedVehicle* vehicle : vehicle_agents) {
+        vehicle->stop();
+        delete vehicle;
+    }
+    for (RSU* rsu : rsus) {
+        rsu->stop();
+        delete rsu;
+    }
+    for (EthernetProtocol* protocol : protocols) {
+        delete protocol;
+    }
+    for (EthernetNIC* nic : nics) {
+        delete nic;
+    }
+    MemoryBus::shared().channel(nullptr);
+    Simulator::stop();
+
+    AsyncLogger::close();
+    ConsoleLogger::close();
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
     srand(time(nullptr));
     ConsoleLogger::init();
     ConsoleLogger::print("DYNAMIC VEHICLE SPAWNER STARTED");
@@ -60,6 +234,22 @@ int main() {
         mac_key_vector.push_back(key);
     }
 
+    if (argc > 3 && strcmp(argv[1], "--des") == 0) {
+        uint64_t seed = argc > 4 ? strtoull(argv[4], nullptr, 10) : 1;
+        return simulate_events(static_cast<unsigned int>(atoi(argv[2])), static_cast<unsigned int>(atoi(argv[3])), seed);
+    }
+    // Once, before forking: every vehicle reads the same shared pages
+    auto load_start = std::chrono::steady_clock::now();
+    if (DatasetService::load()) {
+        std::cout << "Datasets: " << DatasetService::count() << " loaded (" << DatasetService::bytes() / 1024 << " KiB shared) in "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - load_start).count()
+                  << " ms" << std::endl;
+    }
+
+    if (argc > 2 && strcmp(argv[1], "--simulate") == 0) {
+        return simulate(static_cast<unsigned int>(atoi(argv[2])), mac_key_vector);
+    }
+
     for (unsigned short i = 0; i < Traits<RSU>::NUM_RSU; i++) {
         pid_t pid = fork();
         
@@ -74,14 +264,16 @@ int main() {
             
             std::string id = "NIC" + std::to_string(child_pid);
             EthernetNIC* nic = new EthernetNIC(id, i+1);
-            EthernetProtocol* protocol = EthernetProtocol::get_instance();  
+            EthernetProtocol* protocol = new EthernetProtocol(nic);
             RSU* rsu = new RSU(nic, protocol, mac_key_vector);
             rsu->start();
             std::this_thread::sleep_for(std::chrono::seconds(MAX_RUNTIME_SECONDS));
             rsu->stop();
             delete rsu;
             ConsoleLogger::log("RSU AFTER STOP");
+            delete protocol;
             delete nic;
+            AsyncLogger::close();
             ConsoleLogger::close();
             exit(0);
         }       
@@ -97,6 +289,7 @@ int main() {
             break;
         }
         
+        auto spawn_start = std::chrono::steady_clock::now();
         pid_t pid = fork();
         
         if (pid < 0) {
@@ -115,14 +308,15 @@ int main() {
             std::uniform_int_distribution<> distrib(1, Traits<Vehicle>::NUM_RSU);
             
             EthernetNIC* nic = new EthernetNIC(id, static_cast<unsigned short>(distrib(gen)));
-            EthernetProtocol* child_protocol = EthernetProtocol::get_instance();
+            EthernetProtocol* child_protocol = new EthernetProtocol(nic);
             
             int lifetime = MIN_LIFETIME + rand() % (MAX_LIFETIME - MIN_LIFETIME + 1);
             ConsoleLogger::log("Vehicle " + id + " will live for " + std::to_string(lifetime) + " seconds");
             Vehicle* vehicle = new Vehicle(dataset_id, nic, child_protocol, lifetime);
             
             vehicle->start();
-            ConsoleLogger::log("Vehicle " + id + " started");
+            ConsoleLogger::log("Vehicle " + id + " started " + std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - spawn_start).count()) + " us after fork");
 
             vehicle->run();
             // auto sleep_duration = std::chrono::seconds(lifetime);
@@ -136,10 +330,12 @@ int main() {
             vehicle->stop();
 
             delete vehicle;
+            delete child_protocol;
             delete nic;
             
             ConsoleLogger::log("Vehicle " + id + " destroyed after " + std::to_string(lifetime) + " seconds");
             
+            AsyncLogger::close();
             ConsoleLogger::close();
             exit(0);
         } else {
@@ -180,6 +376,8 @@ int main() {
         
     ConsoleLogger::log("All child processes terminated.");
     ConsoleLogger::log("Parent process (PID: " + std::to_string(getpid()) + ") finished.");
+    DatasetService::unload();
+    AsyncLogger::close();
     ConsoleLogger::close();
     
     return 0;
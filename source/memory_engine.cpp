@@ -0,0 +1,164 @@
+#include "../header/memory_engine.h"
+
+#include <algorithm>
+
+#include "../header/fast_clock.h"
+#include "../header/simulator.h"
+
+const unsigned int MemoryEngine::QUEUE_FRAMES;
+
+MemoryBus& MemoryBus::shared() {
+    static MemoryBus* bus = new MemoryBus();
+    return *bus;
+}
+
+void MemoryBus::attach(MemoryEngine* engine) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _engines.push_back(engine);
+}
+
+void MemoryBus::detach(MemoryEngine* engine) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _engines.erase(std::remove(_engines.begin(), _engines.end(), engine), _engines.end());
+}
+
+unsigned int MemoryBus::broadcast(const MemoryEngine* sender, const std::shared_ptr<Ethernet::Frame>& frame, unsigned int size, U64 timestamp) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    unsigned int delivered = 0;
+
+    if (Simulator::active()) {
+        ChannelModel& channel = _channel ? *_channel : _default_channel;
+        unsigned int quadrant = frame->attributes()->get_quadrant();
+        U64 sent = channel.transmit(quadrant, sizeof(Ethernet::Header) + sizeof(Ethernet::Attributes) + size, Simulator::now_us());
+        for (unsigned int i = 0; i < _engines.size(); i++) {
+            MemoryEngine* engine = _engines[i];
+            U64 at;
+            if (engine != sender && channel.arrival(quadrant, sent, at)) {
+                Simulator::schedule(at, std::bind(&MemoryBus::arrive, this, engine, i, frame, size));
+                delivered++;
+            }
+        }
+        return delivered;
+    }
+
+    for (MemoryEngine* engine : _engines) {
+        if (engine != sender && engine->deliver(frame, size, timestamp)) {
+            delivered++;
+        }
+    }
+    return delivered;
+}
+
+void MemoryBus::arrive(MemoryEngine* engine, unsigned int index, const std::shared_ptr<Ethernet::Frame>& frame, unsigned int size) {
+    std::function<void()> handler;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        // Still at `index` unless an engine left since the broadcast
+        bool attached = index < _engines.size() && _engines[index] == engine;
+        if (!attached) {
+            attached = std::find(_engines.begin(), _engines.end(), engine) != _engines.end();
+        }
+        if (!attached || !engine->deliver(frame, size, 0)) {
+            return;
+        }
+        handler = engine->handler();
+    }
+    // The handler may send, which takes _mutex again
+    if (handler) {
+        handler();
+    }
+}
+
+unsigned int MemoryBus::engines() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _engines.size();
+}
+
+MemoryEngine::MemoryEngine(MemoryBus& bus) : _bus(bus), _notify(nullptr), _dropped(0) {
+    // Locally administered, unique within the process
+    static std::atomic<uint32_t> next(1);
+    uint32_t number = next.fetch_add(1);
+    _addr[0] = 0x02;
+    _addr[1] = 0x00;
+    memcpy(_addr + 2, &number, sizeof(number));
+    _bus.attach(this);
+}
+
+MemoryEngine::~MemoryEngine() {
+    _bus.detach(this);
+}
+
+int MemoryEngine::raw_send(Ethernet::Address dst, Ethernet::Protocol prot, Ethernet::Attributes* attributes, const void* data, unsigned int size, U64* tx_timestamp) {
+    std::shared_ptr<Ethernet::Frame> frame = std::make_shared<Ethernet::Frame>(dst, _addr, prot);
+    memcpy(frame->attributes(), attributes, sizeof(Ethernet::Attributes));
+    memcpy(frame->data(), data, size);
+
+    U64 now = Simulator::active() ? 0 : FastClock::system_us();
+    _bus.broadcast(this, frame, size, now);
+    if (tx_timestamp) {
+        *tx_timestamp = now;
+    }
+    return size;
+}
+
+int MemoryEngine::raw_receive(Ethernet::Address* src, Ethernet::Protocol* prot, Ethernet::Attributes* attributes, void* data, unsigned int size, U64* timestamp) {
+    Delivery delivery;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_queue.empty()) {
+            errno = EAGAIN;
+            return -1;
+        }
+        delivery = _queue.front();
+        _queue.pop_front();
+    }
+
+    Ethernet::Frame* frame = delivery.frame.get();
+    memcpy(src, frame->header()->h_source, ETH_ALEN);
+    *prot = ntohs(frame->header()->h_proto);
+    memcpy(attributes, frame->attributes(), sizeof(Ethernet::Attributes));
+    if (timestamp) {
+        *timestamp = delivery.timestamp;
+    }
+
+    unsigned int copy_size = delivery.size > size ? size : delivery.size;
+    memcpy(data, frame->data(), copy_size);
+    return copy_size;
+}
+
+void MemoryEngine::notify(sem_t* semaphore) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _notify = semaphore;
+    if (!semaphore) {
+        _handler = nullptr;
+    }
+}
+
+void MemoryEngine::notify(const std::function<void()>& handler) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _handler = handler;
+}
+
+bool MemoryEngine::enable_tx_timestamps() {
+    return !Simulator::active();
+}
+
+bool MemoryEngine::deliver(const std::shared_ptr<Ethernet::Frame>& frame, unsigned int size, U64 timestamp) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_queue.size() >= QUEUE_FRAMES) {
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    Delivery delivery = {frame, size, timestamp};
+    _queue.push_back(delivery);
+    // Posted under _mutex: notify() cannot swap the semaphore out from under us
+    if (_notify) {
+        sem_post(_notify);
+    }
+    return true;
+}
+
+std::function<void()> MemoryEngine::handler() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _handler;
+}
@@ -0,0 +1,149 @@
+#include "../header/period_thread.h"
+
+#include <signal.h>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#include <sstream>
+
+#include "../header/console_logger.h"
+
+namespace {
+
+std::mutex registry_mutex;
+std::vector<PeriodicThread*>& registry() {
+    static std::vector<PeriodicThread*> threads;
+    return threads;
+}
+
+// Counter of the SCHED_DEADLINE thread the signal is delivered to. A plain
+// pointer: constant initialized, so reading it in the handler is safe
+thread_local std::atomic<unsigned long>* overrun_counter = nullptr;
+
+void on_sigxcpu(int) {
+    if (overrun_counter) {
+        overrun_counter->fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+const char* mode_name(PeriodicThread::Mode mode) {
+    switch (mode) {
+        case PeriodicThread::DEADLINE: return "DEADLINE";
+        case PeriodicThread::TIMER: return "TIMER";
+        case PeriodicThread::SIMULATED: return "SIMULATED";
+        default: return "AUTO";
+    }
+}
+
+}
+
+void PeriodicThread::register_thread(PeriodicThread* thread) {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    registry().push_back(thread);
+}
+
+void PeriodicThread::unregister_thread(PeriodicThread* thread) {
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        std::vector<PeriodicThread*>& threads = registry();
+        threads.erase(std::remove(threads.begin(), threads.end(), thread), threads.end());
+    }
+    if (Traits<PeriodicThread>::LOG_STATS && thread->jitter.snapshot().count > 0) {
+        std::ostringstream line;
+        thread->dump(line);
+        LOG_INFO("PeriodicThread: {}", line.str());
+    }
+}
+
+void PeriodicThread::count_kernel_overruns(std::atomic<unsigned long>* counter) {
+    static std::once_flag installed;
+    std::call_once(installed, []() {
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_handler = on_sigxcpu;
+        sigemptyset(&action.sa_mask);
+        action.sa_flags = SA_RESTART;
+        sigaction(SIGXCPU, &action, nullptr);
+    });
+    overrun_counter = counter;
+}
+
+__u64 PeriodicThread::grant_runtime(__u64 wanted, __u64 period) const {
+    const __u64 PPM = 1000000;
+    __u64 others_ppm = 0;
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        for (PeriodicThread* thread : registry()) {
+            if (thread != this && thread->adaptive && thread->running.load() && thread->active_mode.load() == DEADLINE) {
+                others_ppm += thread->runtime_ns.load() * PPM / thread->period_ns.load();
+            }
+        }
+    }
+
+    __u64 cap_ppm = Traits<PeriodicThread>::UTILIZATION_CAP_PERCENT * (PPM / 100);
+    __u64 minimum = static_cast<__u64>(Traits<PeriodicThread>::MIN_RUNTIME_US) * 1000;
+    __u64 allowed = others_ppm < cap_ppm ? (cap_ppm - others_ppm) * period / PPM : 0;
+    if (wanted > allowed) wanted = allowed;
+    if (wanted > period) wanted = period;
+    return wanted > minimum ? wanted : minimum;
+}
+
+void PeriodicThread::adapt_runtime(unsigned int count) {
+    unsigned int rank = (count * Traits<PeriodicThread>::ADAPT_PERCENTILE + 99) / 100;
+    if (rank == 0) rank = 1;
+    std::nth_element(cpu_samples, cpu_samples + rank - 1, cpu_samples + count);
+
+    __u64 period = period_ns.load();
+    __u64 wanted = cpu_samples[rank - 1] * (100 + Traits<PeriodicThread>::ADAPT_MARGIN_PERCENT) / 100;
+    wanted = grant_runtime(wanted, period);
+
+    // Grow at once, shrink only by a clear amount so the budget does not flap
+    __u64 current = runtime_ns.load();
+    if (wanted > current || wanted < current - current / 8) {
+        runtime_ns.store(wanted);
+        adaptations++;
+    }
+}
+
+void PeriodicThread::start_simulated() {
+    active_mode.store(SIMULATED);
+    simulated_release_us = Simulator::now_us();
+    simulated_event = Simulator::schedule(simulated_release_us, std::bind(&PeriodicThread::simulated_activation, this));
+}
+
+// Virtual time does not pass while the task runs: jitter is always zero and
+// the execution time recorded is the real one, what the task costs the host
+void PeriodicThread::simulated_activation() {
+    __u64 start = now_ns();
+    jitter.record(0);
+    task_func();
+    execution.record(now_ns() - start);
+
+    // The task may have stopped or re-timed the thread
+    if (running.load()) {
+        simulated_release_us += period_ns.load() / 1000;
+        simulated_event = Simulator::schedule(simulated_release_us, std::bind(&PeriodicThread::simulated_activation, this));
+    }
+}
+
+void PeriodicThread::dump(std::ostream& out) const {
+    Stats s = stats();
+    out << (s.label.empty() ? "(unlabeled)" : s.label) << " [" << mode_name(s.mode) << " "
+        << s.period_us << "/" << s.runtime_us << " us] activations " << s.execution.count
+        << " | jitter p50 " << s.jitter.percentile_us(0.5) << " p99 " << s.jitter.percentile_us(0.99)
+        << " max " << s.jitter.max_us << " us | exec mean " << s.execution.mean_us
+        << " p99 " << s.execution.percentile_us(0.99) << " max " << s.execution.max_us
+        << " us | over budget " << s.budget_overruns << " | missed " << s.deadline_misses
+        << " | skipped " << s.skipped << " | SIGXCPU " << s.kernel_overruns;
+    if (s.adaptive) {
+        out << " | runtime changes " << s.adaptations;
+    }
+}
+
+void PeriodicThread::dump_all(std::ostream& out) {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    for (PeriodicThread* thread : registry()) {
+        thread->dump(out);
+        out << std::endl;
+    }
+}
@@ -2,12 +2,12 @@
 
 
 RSU::RSU(EthernetNIC* nic, EthernetProtocol* protocol, std::vector<Ethernet::MAC_KEY> mac_key_vector)
-    : AutonomousAgent(nic, protocol), _mac_key_vector(mac_key_vector), _running_thread(nullptr) {
+    : AutonomousAgent(nic, protocol), _mac_key_vector(mac_key_vector), _running_thread(nullptr),
+      _beacon_interval(Traits<TimeKeeper>::BEACON_MIN_US) {
     ConsoleLogger::log("Initializing NIC MAC KEY data");
     nic->create_mac_key_data(_mac_key_vector);
     ConsoleLogger::log("NIC MAC KEY data initialized");
     ConsoleLogger::log("Quadrant: " + std::to_string(_nic->get_quadrant()));
-    _protocol->register_nic(_nic);
     EthernetProtocol::Address address(nic->address(), 1);
     _communicator = new EthernetCommunicator(protocol, address);
 }
@@ -15,20 +15,24 @@ RSU::RSU(EthernetNIC* nic, EthernetProtocol* protocol, std::vector<Ethernet::MAC
 RSU::~RSU() {
 }
 
+// One beacon per period; the period follows what the vehicles' clock estimates ask for
 void RSU::send_sync_messages() {
-    Message* msg = new Message();
-    EthernetProtocol::Address from(_nic->address(), _id);
-    EthernetProtocol::Address to(EthernetProtocol::Address::BROADCAST_MAC, 0);
-    ConsoleLogger::log("RSU: " + Ethernet::address_to_string(_nic->address()) + " Sending Synchronization Message");
-    std::string t1 = _communicator->send(msg, from, to) ? "Success" : "Failure";
-    std::string t2 = _communicator->send(msg, from, to) ? "Success" : "Failure";
-    ConsoleLogger::log("t1 status: " + t1 + " | t2 status: " + t2);
-    delete msg;
+    if (_nic->send_sync_beacon() < 0) {
+        LOG_WARNING("RSU: Failed to send sync beacon");
+    }
+
+    __u64 interval = _nic->beacon_interval();
+    if (interval != _beacon_interval && _running_thread != nullptr) {
+        LOG_DEBUG("RSU: Sync beacon interval {} -> {} us", _beacon_interval, interval);
+        _beacon_interval = interval;
+        _running_thread->update(interval);
+    }
 }
 
 void RSU::start() {
     if (_running) return;
     ConsoleLogger::log("Starting RSU -> " + std::to_string(_id));
+    ThreadPlacement::configure("rsu", _id);
     
     _nic->set_packet_origin(Ethernet::Attributes::PacketOrigin::RSU);
 
@@ -36,10 +40,14 @@ void RSU::start() {
 
     _running_thread = new PeriodicThread(
         std::bind(&RSU::send_sync_messages, this),
-        static_cast<__u64>(std::chrono::microseconds(1000).count()),
+        _beacon_interval,
         static_cast<__u64>(std::chrono::microseconds(500).count())
     );
+    _running_thread->set_label("rsu " + std::to_string(_id) + " sync");
+    _running_thread->set_role(ThreadPlacement::SENDER);
     _running_thread->start();
+
+    ThreadPlacement::report();
 }
 
 void RSU::stop() {
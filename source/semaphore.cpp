@@ -1,42 +1,113 @@
 #include "../header/semaphore.h"
 
-Semaphore::Semaphore(int initial = 0) : _count(initial) {}
+#include <climits>
+#include <cerrno>
+#include <thread>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CPU_RELAX() _mm_pause()
+#else
+#define CPU_RELAX() std::this_thread::yield()
+#endif
+
+namespace {
+
+// Spinning only helps when the thread calling v() can run at the same time
+const int SPIN_LIMIT = std::thread::hardware_concurrency() > 1 ? Traits<Semaphore>::SPIN_MAX : 0;
+
+long long monotonic_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<long long>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+int futex(std::atomic<int>* address, int operation, int value, const struct timespec* timeout) {
+    return syscall(SYS_futex, reinterpret_cast<int*>(address), operation | FUTEX_PRIVATE_FLAG, value, timeout, nullptr, 0);
+}
+
+}
+
+Semaphore::Semaphore(int initial = 0) : _count(initial), _waiters(0), _spin(SPIN_LIMIT / 2) {}
 
 Semaphore::~Semaphore() {}
 
+bool Semaphore::acquire() {
+    int count = _count.load(std::memory_order_relaxed);
+    while (count > 0) {
+        if (_count.compare_exchange_weak(count, count - 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Semaphore::spin() {
+    int budget = _spin.load(std::memory_order_relaxed);
+    for (int i = 0; i < budget; i++) {
+        CPU_RELAX();
+        if (_count.load(std::memory_order_relaxed) > 0 && acquire()) {
+            // Paid off: allow a little more next time
+            _spin.store(budget < SPIN_LIMIT ? budget + budget / 8 + 1 : SPIN_LIMIT, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    _spin.store(budget / 2, std::memory_order_relaxed);
+    return false;
+}
+
+bool Semaphore::park(long long deadline_ns) {
+    _waiters.fetch_add(1, std::memory_order_seq_cst);
+    bool acquired = false;
+    while (!(acquired = acquire())) {
+        struct timespec timeout;
+        if (deadline_ns) {
+            long long remaining = deadline_ns - monotonic_ns();
+            if (remaining <= 0) break;
+            timeout.tv_sec = remaining / 1000000000LL;
+            timeout.tv_nsec = remaining % 1000000000LL;
+        }
+        // Sleeps only if the count is still zero when the kernel looks
+        futex(&_count, FUTEX_WAIT, 0, deadline_ns ? &timeout : nullptr);
+    }
+    _waiters.fetch_sub(1, std::memory_order_relaxed);
+    return acquired;
+}
+
 void Semaphore::p() { 
-    std::unique_lock<std::mutex> lock(_mutex);
-    
-    _condition.wait(lock, [this] {
-        return _count > 0;
-    });
-    _count--;
+    if (acquire() || spin()) {
+        return;
+    }
+    park(0);
 }
 
 bool Semaphore::try_p() {
-    std::unique_lock<std::mutex> lock(_mutex, std::try_to_lock);
-    if (!lock.owns_lock()) {
-        return false;
+    return acquire();
+}
+
+bool Semaphore::p(long long timeout_us) {
+    if (acquire()) {
+        return true;
     }
-    
-    if (_count == 0) {
+    if (timeout_us <= 0) {
         return false;
     }
-    
-    _count--;
-    return true;
+    long long deadline = monotonic_ns() + timeout_us * 1000;
+    return spin() || park(deadline);
 }
 
 void Semaphore::v() { // Signal operation
-    {
-        std::lock_guard<std::mutex> lock(_mutex);
-        _count++;
+    int before = _count.fetch_add(1, std::memory_order_seq_cst);
+    // Units already pending cover that many waiters, who are awake or will find them
+    if (_waiters.load(std::memory_order_seq_cst) > before) {
+        futex(&_count, FUTEX_WAKE, 1, nullptr);
     }
-
-    _condition.notify_one();
 }
 
 int Semaphore::count() {
-    std::lock_guard<std::mutex> lock(_mutex);
-    return _count;
-}
\ No newline at end of file
+    return _count.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,70 @@
+#include "../header/agent/simulated_vehicle.h"
+#include "../header/simulator.h"
+#include "../header/message.h"
+#include "../header/type_definitions.h"
+#include "../header/component_types.h"
+
+SimulatedVehicle::SimulatedVehicle(int id, EthernetNIC* nic, EthernetProtocol* protocol)
+    : AutonomousAgent(nic, protocol), _listener(protocol), _status_thread(nullptr), _move_thread(nullptr), _dwells(0), _sent(0) {
+    _id = id;
+    _protocol->attach(&_listener, 1);
+}
+
+SimulatedVehicle::~SimulatedVehicle() {
+    stop();
+    _protocol->detach(&_listener, 1);
+}
+
+void SimulatedVehicle::start() {
+    if (_running) return;
+    _running = true;
+
+    _status_thread = new PeriodicThread(std::bind(&SimulatedVehicle::send_status, this), Traits<Simulator>::STATUS_PERIOD_US);
+    _status_thread->set_label("simulated vehicle " + std::to_string(_id) + " status");
+    _move_thread = new PeriodicThread(std::bind(&SimulatedVehicle::move, this), Traits<Simulator>::QUADRANT_DWELL_US);
+    _move_thread->set_label("simulated vehicle " + std::to_string(_id) + " move");
+    _status_thread->start();
+    _move_thread->start();
+}
+
+void SimulatedVehicle::stop() {
+    if (!_running) return;
+    _running = false;
+
+    delete _status_thread;
+    delete _move_thread;
+    _status_thread = _move_thread = nullptr;
+}
+
+void SimulatedVehicle::send_status() {
+    Message message;
+    Message::ResponseMessage payload;
+    payload.type = ComponentDataTypes::POSITION_DATA_TYPE;
+    payload.value = _id;
+    message.set_payload(payload);
+    message.set_type(Message::RESPONSE);
+
+    EthernetProtocol::Address from(_nic->address(), 1);
+    if (_protocol->send(from, EthernetProtocol::Address::BROADCAST, message.data(), message.size()) >= 0) {
+        _sent++;
+    }
+}
+
+void SimulatedVehicle::move() {
+    // The first activation comes at start: stay where the vehicle was placed
+    if (_dwells++ == 0) {
+        return;
+    }
+    unsigned int quadrant = 1 + Simulator::random() % Traits<SimulatedVehicle>::NUM_RSU;
+    if (quadrant != _nic->get_quadrant()) {
+        _nic->set_quadrant(quadrant);
+    }
+}
+
+void SimulatedVehicle::Listener::update(EthernetProtocol::Port port, unsigned int id, EthernetProtocol::NICBuffer* buf) {
+    Message message;
+    EthernetProtocol::Address from;
+    if (_protocol->receive(buf, from, message.data(), message.max_size()) > 0) {
+        received++;
+    }
+}
@@ -0,0 +1,183 @@
+#include "../header/simulator.h"
+
+#include <atomic>
+#include <queue>
+#include <vector>
+
+namespace {
+
+struct Entry {
+    U64 at;
+    Simulator::Id id;
+    uint32_t slot;
+
+    // std::priority_queue keeps the largest on top: invert for earliest first
+    bool operator<(const Entry& other) const {
+        return at != other.at ? at > other.at : id > other.id;
+    }
+};
+
+struct Slot {
+    Simulator::Id id;       // 0 while free
+    Simulator::Event event;
+};
+
+}
+
+struct Simulator::State {
+    std::atomic<bool> active;
+    U64 now;
+    U64 start;
+    uint64_t random;
+    Id next_serial;
+    unsigned long long events_run;
+    std::priority_queue<Entry> queue;
+    // Events live in reusable slots; an Id is its serial number above the
+    // slot index, so cancel() finds it directly. A cancelled slot is freed
+    // at once and its entry skipped when it reaches the top (ids differ)
+    std::vector<Slot> slots;
+    std::vector<uint32_t> free_slots;
+
+    State() : active(false), now(0), start(0), random(1), next_serial(1), events_run(0) {}
+
+    void clear() {
+        queue = std::priority_queue<Entry>();
+        slots.clear();
+        free_slots.clear();
+    }
+
+    void release(uint32_t slot) {
+        slots[slot].id = 0;
+        slots[slot].event = nullptr;
+        free_slots.push_back(slot);
+    }
+};
+
+Simulator::State& Simulator::state() {
+    static State* state = new State();
+    return *state;
+}
+
+void Simulator::start(uint64_t seed, U64 start_us) {
+    State& s = state();
+    s.clear();
+    s.now = s.start = start_us;
+    // xorshift needs a non-zero state; splitmix the seed so near seeds diverge
+    uint64_t z = seed + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    s.random = (z ^ (z >> 31)) | 1;
+    s.next_serial = 1;
+    s.events_run = 0;
+    s.active.store(true);
+}
+
+void Simulator::stop() {
+    State& s = state();
+    s.active.store(false);
+    s.clear();
+}
+
+bool Simulator::active() {
+    return state().active.load(std::memory_order_relaxed);
+}
+
+U64 Simulator::now_us() {
+    return state().now;
+}
+
+U64 Simulator::start_us() {
+    return state().start;
+}
+
+Simulator::Id Simulator::schedule(U64 at_us, const Event& event) {
+    State& s = state();
+    uint32_t slot;
+    if (s.free_slots.empty()) {
+        slot = s.slots.size();
+        s.slots.push_back(Slot());
+    } else {
+        slot = s.free_slots.back();
+        s.free_slots.pop_back();
+    }
+    // The serial in the high bits keeps ties in scheduling order
+    Id id = (s.next_serial++ << 32) | slot;
+    s.slots[slot].id = id;
+    s.slots[slot].event = event;
+    // Nothing runs in the past
+    Entry entry = {at_us > s.now ? at_us : s.now, id, slot};
+    s.queue.push(entry);
+    return id;
+}
+
+Simulator::Id Simulator::schedule_in(U64 delay_us, const Event& event) {
+    return schedule(state().now + delay_us, event);
+}
+
+bool Simulator::cancel(Id id) {
+    State& s = state();
+    uint32_t slot = static_cast<uint32_t>(id);
+    if (id == 0 || slot >= s.slots.size() || s.slots[slot].id != id) {
+        return false;
+    }
+    s.release(slot);
+    return true;
+}
+
+bool Simulator::step() {
+    State& s = state();
+    while (!s.queue.empty()) {
+        Entry entry = s.queue.top();
+        s.queue.pop();
+        Slot& slot = s.slots[entry.slot];
+        if (slot.id != entry.id) {
+            continue;
+        }
+        // The event may schedule or cancel others: take it out first
+        Event event = std::move(slot.event);
+        s.release(entry.slot);
+        s.now = entry.at;
+        s.events_run++;
+        event();
+        return true;
+    }
+    return false;
+}
+
+void Simulator::run_until(U64 at_us) {
+    State& s = state();
+    while (!s.queue.empty() && s.queue.top().at <= at_us) {
+        step();
+    }
+    if (s.now < at_us) {
+        s.now = at_us;
+    }
+}
+
+uint64_t Simulator::random() {
+    State& s = state();
+    s.random ^= s.random >> 12;
+    s.random ^= s.random << 25;
+    s.random ^= s.random >> 27;
+    return s.random * 0x2545F4914F6CDD1DULL;
+}
+
+long long Simulator::uniform(long long low, long long high) {
+    if (high <= low) {
+        return low;
+    }
+    return low + static_cast<long long>(random() % static_cast<uint64_t>(high - low + 1));
+}
+
+bool Simulator::chance(unsigned int ppm) {
+    return ppm > 0 && random() % 1000000 < ppm;
+}
+
+unsigned long long Simulator::events_run() {
+    return state().events_run;
+}
+
+unsigned long Simulator::pending() {
+    State& s = state();
+    return s.slots.size() - s.free_slots.size();
+}
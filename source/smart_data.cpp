@@ -2,13 +2,15 @@
 #include "../header/console_logger.h"
 #include "../header/message.h"
 #include "../header/period_thread.h"
+#include "../header/fast_clock.h"
+#include "../header/thread_placement.h"
 
-SmartData::SmartData(Ethernet::Address& nic_address, const unsigned short id)
+SmartData::SmartData(EthernetProtocol* protocol, Ethernet::Address& nic_address, const unsigned short id)
     : _running(false), _id(id), _semaphore(0), _period_time_internal_response_thread(0), _period_time_external_response_thread(0), _internal_response_thread(nullptr), _external_response_thread(nullptr), _interest_thread(nullptr) 
 {
     _component_addr = EthernetProtocol::Address(nic_address, id);
     
-    _communicator = new EthernetCommunicator(EthernetProtocol::get_instance(), _component_addr);
+    _communicator = new EthernetCommunicator(protocol, _component_addr);
 }
 
 SmartData::~SmartData() {
@@ -27,7 +29,7 @@ SmartData::~SmartData() {
 }
 
 void SmartData::start() {
-    ConsoleLogger::log("SmartData: Starting threads");
+    LOG_INFO("SmartData: Starting threads");
     if (_running) return;
     _running = true;
 
@@ -39,6 +41,7 @@ void SmartData::start() {
             static_cast<__u64>(std::chrono::microseconds(500 * 1000).count()),
             static_cast<__u64>(std::chrono::microseconds(_get_interests().size() * 400).count())
         );
+        _interest_thread->set_label("smartdata " + std::to_string(_id) + " interests");
         _interest_thread->start();
     }
 
@@ -46,26 +49,26 @@ void SmartData::start() {
 }
 
 void SmartData::stop() {
-    ConsoleLogger::log("SmartData: Stopping threads 0");
+    LOG_DEBUG("SmartData: Stopping threads 0");
     _running = false;
 
     if (_interest_thread != nullptr) {
         delete _interest_thread;
     }
-    ConsoleLogger::log("SmartData: Stopping threads 1");
+    LOG_DEBUG("SmartData: Stopping threads 1");
 
     if (_internal_response_thread != nullptr) {
         delete _internal_response_thread;
     }
-    ConsoleLogger::log("SmartData: Stopping threads 2");
+    LOG_DEBUG("SmartData: Stopping threads 2");
 
     if (_external_response_thread != nullptr) {
         delete _external_response_thread;
     }
-    ConsoleLogger::log("SmartData: Stopping threads 3");
+    LOG_DEBUG("SmartData: Stopping threads 3");
 
     if (_receive_thread.joinable()) {
-        ConsoleLogger::log("RECEIVE THREAD JOINABLE");
+        LOG_DEBUG("RECEIVE THREAD JOINABLE");
         _communicator->stop();
         _receive_thread.join();
     }
@@ -131,11 +134,11 @@ void SmartData::send_internal_interests() {
 
 // Modified receive function to register interests
 void SmartData::receive() {
-    std::string component_address = Ethernet::address_to_string(_get_address());
     Message* msg = new Message();
     unsigned int id;
 
-    ConsoleLogger::log("Smart data: Starting receive thread");
+    ThreadPlacement::Guard placement(ThreadPlacement::RECEIVER, "sd-receive");
+    LOG_INFO("Smart data: Starting receive thread");
     while (_running) {
         if (_communicator->receive(msg, id)) {
             if (!_running) {
@@ -152,7 +155,7 @@ void SmartData::receive() {
 
                         bool is_internal = memcmp(message_info.origin_mac, _get_address(), ETH_ALEN) == 0;
 
-                        ConsoleLogger::log("Interest arrived: From -> " + Ethernet::address_to_string(message_info.origin_mac));
+                        LOG_DEBUG("Interest arrived: From -> {}", Ethernet::address_to_string(message_info.origin_mac));
                         Origin origin;
                         memcpy(&origin.mac, &message_info.origin_mac, 6);
                         origin.port = 0;
@@ -171,39 +174,43 @@ void SmartData::receive() {
                         if(is_internal){
                             if (_internal_response_thread == nullptr) {
                                 _period_time_internal_response_thread = new_period;
-                                ConsoleLogger::log("SmartData: Internal Interest arrived and response thread not initialized");
-                                ConsoleLogger::log("SmartData: Initial Internal response period -> " + std::to_string(_period_time_internal_response_thread.count()) + " microseconds.");
+                                LOG_INFO("SmartData: Internal Interest arrived and response thread not initialized");
+                                LOG_INFO("SmartData: Initial Internal response period -> {} microseconds.", _period_time_internal_response_thread.count());
                                 
                                 _internal_response_thread = new PeriodicThread(
                                     std::bind(&SmartData::send_response_internal, this), 
                                     static_cast<__u64>(_period_time_internal_response_thread.count())
                                 );
+                                _internal_response_thread->set_role(ThreadPlacement::SENDER);
+                                _internal_response_thread->set_label("smartdata " + std::to_string(_id) + " internal response");
                                 _internal_response_thread->start();
                             } else {
-                                ConsoleLogger::log("SmartData: Internal Interest arrived and response thread initialized");
+                                LOG_DEBUG("SmartData: Internal Interest arrived and response thread initialized");
                                 
                                 if (_period_time_internal_response_thread != new_period) {
                                     _period_time_internal_response_thread = new_period;
-                                    ConsoleLogger::log("SmartData: Updating Internal response period -> " + std::to_string(_period_time_internal_response_thread.count()) + " microseconds.");
+                                    LOG_INFO("SmartData: Updating Internal response period -> {} microseconds.", _period_time_internal_response_thread.count());
                                     _internal_response_thread->update(_period_time_internal_response_thread.count());
                                 }
                             }
                         } else {
                             if (_external_response_thread == nullptr) {
                                 _period_time_external_response_thread = new_period;
-                                ConsoleLogger::log("SmartData: External interest arrived and response thread not initialized");
+                                LOG_INFO("SmartData: External interest arrived and response thread not initialized");
 
                                 _external_response_thread = new PeriodicThread(
                                     std::bind(&SmartData::send_response_external, this), 
                                     static_cast<__u64>(_period_time_external_response_thread.count())
                                 );
+                                _external_response_thread->set_role(ThreadPlacement::SENDER);
+                                _external_response_thread->set_label("smartdata " + std::to_string(_id) + " external response");
                                 _external_response_thread->start();
                             } else {
-                                ConsoleLogger::log("SmartData: External Interest arrived and response thread initialized");
+                                LOG_DEBUG("SmartData: External Interest arrived and response thread initialized");
                                 
                                 if (_period_time_external_response_thread != new_period) {
                                     _period_time_external_response_thread = new_period;
-                                    ConsoleLogger::log("SmartData: Updating External response period -> " + std::to_string(_period_time_external_response_thread.count()) + " microseconds.");
+                                    LOG_INFO("SmartData: Updating External response period -> {} microseconds.", _period_time_external_response_thread.count());
                                     _external_response_thread->update(_period_time_external_response_thread.count());
                                 }
                             }
@@ -216,16 +223,15 @@ void SmartData::receive() {
                     for (InterestData data : _get_interests()) {
                         if (response_payload->type == data.data_type) {
                             Ethernet::MessageInfo message_info = _get_message_info(id);
-                            std::string type_string = Ethernet::address_to_string(message_info.origin_mac) == component_address ? "Internal" : "External";
+                            const char* type_string = memcmp(message_info.origin_mac, _get_address(), ETH_ALEN) == 0 ? "Internal" : "External";
 
-                            auto now = std::chrono::system_clock::now();
-                            auto now_micro = std::chrono::duration_cast<std::chrono::microseconds>(now.time_since_epoch());
+                            std::chrono::microseconds now_micro(FastClock::system_us());
 
                             if (now_micro >= data.next_receive * 1.2) {
-                                ConsoleLogger::log("SmartData [" + std::to_string(_id) + "]: received " + type_string + " response message - value = " + std::to_string(response_payload->value) + " and using it.");
+                                LOG_TRACE("SmartData [{}]: received {} response message - value = {} and using it.", _id, type_string, response_payload->value);
                             } else {
                                 data.next_receive += data.period;
-                                ConsoleLogger::log("SmartData [" + std::to_string(_id) + "]: received " + type_string + " response message - value = " + std::to_string(response_payload->value) +  " but descarting it.");
+                                LOG_TRACE("SmartData [{}]: received {} response message - value = {} but descarting it.", _id, type_string, response_payload->value);
                             }
 
                             _process_data(response_payload, id);
@@ -237,7 +243,7 @@ void SmartData::receive() {
                     break;
                 }
                 default:
-                    ConsoleLogger::log("SmartData: Message with unknown type");
+                    LOG_WARNING("SmartData: Message with unknown type");
                     break;
             }
         }
@@ -250,7 +256,7 @@ void SmartData::receive() {
 void SmartData::send_response_external() {
     if (!_running) return;
 
-    ConsoleLogger::log("SmartData [" + std::to_string(_id) + "]: Sending Response External, Value: " + std::to_string(_get_data()));
+    LOG_TRACE("SmartData [{}]: Sending Response External, Value: {}", _id, _get_data());
     Ethernet::Address address;
     memcpy(address, _get_address(), 6);
     EthernetProtocol::Address from(address, _id);
@@ -276,7 +282,7 @@ void SmartData::send_response_external() {
 void SmartData::send_response_internal() {
     if (!_running) return;
 
-    ConsoleLogger::log("SmartData [" + std::to_string(_id) + "]: Sending Response Internal, Value: " + std::to_string(_get_data()));
+    LOG_TRACE("SmartData [{}]: Sending Response Internal, Value: {}", _id, _get_data());
     Ethernet::Address address;
     memcpy(address, _get_address(), 6);
     EthernetProtocol::Address from(address, _id);
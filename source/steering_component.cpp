@@ -2,9 +2,9 @@
 
 void SteeringComponent::run() 
 {
-    ConsoleLogger::log("Steering actuator running");
+    LOG_DEBUG("Steering actuator running");
     generate_data();
-    ConsoleLogger::log("Steering actuation completed");
+    LOG_DEBUG("Steering actuation completed");
 }
 
 SteeringComponent::SteeringComponent(AutonomousAgent* autonomous_agent, const unsigned short& id)
@@ -23,7 +23,7 @@ void SteeringComponent::generate_data() {
     std::uniform_int_distribution<> dist(-2, 2);
     _value += dist(gen);
     
-    ConsoleLogger::log("Steering actuated to: " + std::to_string(_value) + " degrees");
+    LOG_DEBUG("Steering actuated to: {} degrees", _value.load());
 }
 
 void SteeringComponent::set_interests() {
@@ -41,12 +41,9 @@ void SteeringComponent::set_interests() {
 
 void SteeringComponent::process_data(Message::ResponseMessage* data, const unsigned int id) {
     _command_value = data->value;
-    ConsoleLogger::log("Received steering command: " + std::to_string(_command_value));
+    LOG_DEBUG("Received steering command: {}", _command_value);
 
     Ethernet::MessageInfo message_info = get_message_info(id);
-    ConsoleLogger::log("Steering Component: Message info received: Origin MAC address -> " + mac_to_string(message_info.origin_mac) +
-        "; Origin ID -> " + std::to_string(message_info.origin_id) +
-        "; Timestamp -> " + std::to_string(message_info.timestamp) + 
-        "; Quadrant -> " + std::to_string(message_info.quadrant) +
-        "; MAC -> " + std::to_string(message_info.mac));
+    LOG_DEBUG("Steering Component: Message info received: Origin MAC address -> {}; Origin ID -> {}; Timestamp -> {}; Quadrant -> {}; MAC -> {}",
+        mac_to_string(message_info.origin_mac), message_info.origin_id, message_info.timestamp, message_info.quadrant, message_info.mac);
 }
@@ -0,0 +1,306 @@
+#include "../header/thread_placement.h"
+
+#include <cerrno>
+#include <cstring>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <mutex>
+#include <vector>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#include "../header/console_logger.h"
+
+namespace {
+
+struct Placed {
+    pthread_t handle;
+    pid_t tid;
+    ThreadPlacement::Role role;
+    std::string name;
+};
+
+struct Plan {
+    bool restricted[ThreadPlacement::ROLES];
+    cpu_set_t cpus[ThreadPlacement::ROLES];
+};
+
+std::mutex placement_mutex;
+
+struct State {
+    cpu_set_t process_default;
+    Plan plan;
+    std::string agent;
+    std::vector<Placed> threads;
+};
+
+void prepare_fork() {
+    placement_mutex.lock();
+}
+
+void parent_after_fork() {
+    placement_mutex.unlock();
+}
+
+// Only the forking thread survives in the child
+void child_after_fork();
+
+State& state() {
+    static State* state = nullptr;
+    if (!state) {
+        state = new State();
+        sched_getaffinity(0, sizeof(state->process_default), &state->process_default);
+        for (int role = 0; role < ThreadPlacement::ROLES; role++) {
+            state->plan.restricted[role] = false;
+            state->plan.cpus[role] = state->process_default;
+        }
+        pthread_atfork(&prepare_fork, &parent_after_fork, &child_after_fork);
+    }
+    return *state;
+}
+
+void child_after_fork() {
+    state().threads.clear();
+    placement_mutex.unlock();
+}
+
+std::string trim(const std::string& text) {
+    size_t begin = text.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) return "";
+    size_t end = text.find_last_not_of(" \t\r");
+    return text.substr(begin, end - begin + 1);
+}
+
+// CPUs a role may be placed on: the process affinity (cpusets, taskset) that
+// are also online. Called with placement_mutex held
+cpu_set_t allowed_cpus() {
+    cpu_set_t allowed = state().process_default;
+    cpu_set_t online;
+    bool restricted;
+    std::ifstream file("/sys/devices/system/cpu/online");
+    std::string list;
+    if (std::getline(file, list) && ThreadPlacement::parse_cpus(list, online, restricted) && restricted) {
+        CPU_AND(&allowed, &allowed, &online);
+    }
+    return allowed;
+}
+
+// Called with placement_mutex held
+bool pin(pthread_t handle, ThreadPlacement::Role role) {
+    State& s = state();
+    const cpu_set_t& cpus = s.plan.restricted[role] ? s.plan.cpus[role] : s.process_default;
+    return pthread_setaffinity_np(handle, sizeof(cpus), &cpus) == 0;
+}
+
+}
+
+const char* ThreadPlacement::role_name(Role role) {
+    switch (role) {
+        case NIC_WORKER: return "nic_worker";
+        case RECEIVER: return "receiver";
+        case SENDER: return "sender";
+        case PERIODIC: return "periodic";
+        case LOGGER: return "logger";
+        default: return "unknown";
+    }
+}
+
+bool ThreadPlacement::parse_cpus(const std::string& text, cpu_set_t& set, bool& restricted) {
+    CPU_ZERO(&set);
+    std::string list = trim(text);
+    if (list.empty() || list == "any") {
+        restricted = false;
+        return true;
+    }
+
+    if (list == "isolated") {
+        std::ifstream isolated("/sys/devices/system/cpu/isolated");
+        std::getline(isolated, list);
+        list = trim(list);
+        if (list.empty()) {
+            // No isolcpus= on this machine
+            restricted = false;
+            return true;
+        }
+    }
+
+    if (list[list.size() - 1] == ',') return false;
+    std::stringstream ranges(list);
+    std::string range;
+    while (std::getline(ranges, range, ',')) {
+        range = trim(range);
+        char* end;
+        long first = strtol(range.c_str(), &end, 10);
+        long last = first;
+        if (end == range.c_str()) return false;
+        if (*end == '-') {
+            const char* second = end + 1;
+            last = strtol(second, &end, 10);
+            if (end == second) return false;
+        }
+        if (*end != '\0' || first < 0 || last < first || last >= CPU_SETSIZE) return false;
+        for (long cpu = first; cpu <= last; cpu++) {
+            CPU_SET(cpu, &set);
+        }
+    }
+    restricted = CPU_COUNT(&set) > 0;
+    return true;
+}
+
+std::string ThreadPlacement::format_cpus(const cpu_set_t& set) {
+    std::stringstream out;
+    bool first = true;
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (!CPU_ISSET(cpu, &set)) continue;
+        int last = cpu;
+        while (last + 1 < CPU_SETSIZE && CPU_ISSET(last + 1, &set)) last++;
+        out << (first ? "" : ",") << cpu;
+        if (last > cpu) out << "-" << last;
+        first = false;
+        cpu = last;
+    }
+    return out.str();
+}
+
+void ThreadPlacement::configure(const std::string& kind, int id, const char* file) {
+    std::lock_guard<std::mutex> lock(placement_mutex);
+    State& s = state();
+    s.agent = kind + std::to_string(id);
+
+    // Precedence per role: agent, kind, every agent, Traits
+    int precedence[ROLES];
+    std::string text[ROLES];
+    for (int role = 0; role < ROLES; role++) {
+        text[role] = Traits<ThreadPlacement>::cpus(role);
+        precedence[role] = 0;
+    }
+
+    std::ifstream config(file);
+    std::string line;
+    int number = 0;
+    while (std::getline(config, line)) {
+        number++;
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty()) continue;
+
+        size_t equals = line.find('=');
+        std::string key = trim(line.substr(0, equals));
+        if (equals == std::string::npos || key.empty()) {
+            LOG_WARNING("ThreadPlacement: {}:{}: expected \"key = cpus\"", file, number);
+            continue;
+        }
+
+        int level = 1;
+        size_t dot = key.rfind('.');
+        if (dot != std::string::npos) {
+            std::string scope = key.substr(0, dot);
+            if (scope == s.agent) level = 3;
+            else if (scope == kind) level = 2;
+            else continue;
+            key = key.substr(dot + 1);
+        }
+
+        int role = 0;
+        while (role < ROLES && key != role_name(static_cast<Role>(role))) role++;
+        if (role == ROLES) {
+            LOG_WARNING("ThreadPlacement: {}:{}: unknown role \"{}\"", file, number, key);
+            continue;
+        }
+        if (level >= precedence[role]) {
+            precedence[role] = level;
+            text[role] = line.substr(equals + 1);
+        }
+    }
+
+    cpu_set_t allowed = allowed_cpus();
+    for (int role = 0; role < ROLES; role++) {
+        cpu_set_t cpus;
+        bool restricted;
+        if (!parse_cpus(text[role], cpus, restricted)) {
+            LOG_WARNING("ThreadPlacement: invalid CPU list \"{}\" for {}", trim(text[role]), role_name(static_cast<Role>(role)));
+            restricted = false;
+        }
+        if (restricted) {
+            // Keep only CPUs this process may run on; online ones need not be 0..n-1
+            CPU_AND(&cpus, &cpus, &allowed);
+            if (CPU_COUNT(&cpus) == 0) {
+                LOG_WARNING("ThreadPlacement: no allowed online CPU in \"{}\" for {}", trim(text[role]), role_name(static_cast<Role>(role)));
+                restricted = false;
+            }
+        }
+        s.plan.restricted[role] = restricted;
+        s.plan.cpus[role] = restricted ? cpus : s.process_default;
+    }
+
+    for (const Placed& thread : s.threads) {
+        pin(thread.handle, thread.role);
+    }
+}
+
+void ThreadPlacement::place(Role role, const char* name) {
+    std::lock_guard<std::mutex> lock(placement_mutex);
+    State& s = state();
+    pthread_t self = pthread_self();
+
+    bool found = false;
+    for (Placed& thread : s.threads) {
+        if (pthread_equal(thread.handle, self)) {
+            thread.role = role;
+            thread.name = name;
+            found = true;
+        }
+    }
+    if (!found) {
+        Placed thread = {self, static_cast<pid_t>(syscall(SYS_gettid)), role, name};
+        s.threads.push_back(thread);
+    }
+
+    // Shows up in ps -L and top; the kernel limit is 15 characters
+    pthread_setname_np(self, std::string(name).substr(0, 15).c_str());
+    pin(self, role);
+}
+
+void ThreadPlacement::leave() {
+    std::lock_guard<std::mutex> lock(placement_mutex);
+    std::vector<Placed>& threads = state().threads;
+    pthread_t self = pthread_self();
+    for (size_t i = 0; i < threads.size(); i++) {
+        if (pthread_equal(threads[i].handle, self)) {
+            threads.erase(threads.begin() + i);
+            return;
+        }
+    }
+}
+
+bool ThreadPlacement::restricted(Role role) {
+    std::lock_guard<std::mutex> lock(placement_mutex);
+    return state().plan.restricted[role];
+}
+
+std::string ThreadPlacement::cpus(Role role) {
+    std::lock_guard<std::mutex> lock(placement_mutex);
+    State& s = state();
+    return s.plan.restricted[role] ? format_cpus(s.plan.cpus[role]) : "any";
+}
+
+void ThreadPlacement::report() {
+    std::lock_guard<std::mutex> lock(placement_mutex);
+    State& s = state();
+
+    std::stringstream plan;
+    for (int role = 0; role < ROLES; role++) {
+        plan << (role ? ", " : "") << role_name(static_cast<Role>(role)) << "="
+             << (s.plan.restricted[role] ? format_cpus(s.plan.cpus[role]) : "any");
+    }
+    LOG_INFO("ThreadPlacement: {} plan: {} (process default {})", s.agent, plan.str(), format_cpus(s.process_default));
+
+    for (const Placed& thread : s.threads) {
+        cpu_set_t actual;
+        CPU_ZERO(&actual);
+        int error = pthread_getaffinity_np(thread.handle, sizeof(actual), &actual);
+        bool as_planned = error == 0 && CPU_EQUAL(&actual, s.plan.restricted[thread.role] ? &s.plan.cpus[thread.role] : &s.process_default);
+        LOG_INFO("ThreadPlacement: {} [{}] tid {} on CPUs {}{}", thread.name, role_name(thread.role), thread.tid,
+                 error == 0 ? format_cpus(actual) : std::string(strerror(error)), as_planned ? "" : " (not as planned)");
+    }
+}
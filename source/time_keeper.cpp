@@ -1,56 +1,104 @@
 #include "../header/time_keeper.h"
 
-TimeKeeper::TimeKeeper() {
-    std::random_device rd;
-    std::mt19937 gen(rd());
+#include <cmath>
+#include <algorithm>
+
+#include "../header/simulator.h"
 
-    std::uniform_int_distribution<int> dist(0, 500);
-    fake_offset = 0;
-    sync_timeout *= 1000;
+TimeKeeper::TimeKeeper() {
+    _virtual = Simulator::active();
+    _virtual_offset_us = _virtual ? Simulator::uniform(-static_cast<long long>(Traits<Simulator>::CLOCK_OFFSET_US), Traits<Simulator>::CLOCK_OFFSET_US) : 0;
+    _virtual_skew_ppm = _virtual ? Simulator::uniform(-static_cast<long long>(Traits<Simulator>::CLOCK_SKEW_PPM), Traits<Simulator>::CLOCK_SKEW_PPM) : 0;
 }
 
+TimeKeeper::~TimeKeeper() {}
+
 U64 TimeKeeper::get_system_timestamp() {
-    return get_local_timestamp() + fake_offset + offset;
+    U64 local = get_local_timestamp();
+    std::lock_guard<std::mutex> lock(_mutex);
+    U64 offset = _estimator.fitted() ? static_cast<U64>(std::llround(_estimator.offset_at(local))) : 0;
+    return local + offset;
 }
 
 TimeKeeper::SyncState TimeKeeper::get_sync_state() {
     return sync_state;
 }
 
+TimeKeeper::SyncQuality TimeKeeper::get_sync_quality() {
+    U64 local = get_local_timestamp();
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _estimator.quality(local);
+}
+
 void TimeKeeper::update_sync_state(SyncState new_state) {
     sync_state = new_state;
 }
 
-U64 TimeKeeper::get_local_timestamp() {
-    auto now = std::chrono::system_clock::now();
-    auto duration = now.time_since_epoch();
-    auto timestamp = std::chrono::duration_cast<std::chrono::microseconds>(duration);
+void TimeKeeper::set_packet_origin(PacketOrigin packet_origin) {
+    _packet_origin = packet_origin;
+}
 
-    return timestamp.count();
+// Same clock as kernel socket timestamps (CLOCK_REALTIME), without a syscall per frame
+U64 TimeKeeper::get_local_timestamp() {
+    if (_virtual) {
+        if (_packet_origin == PacketOrigin::RSU) {
+            return Simulator::now_us();
+        }
+        long long elapsed = static_cast<long long>(Simulator::now_us() - Simulator::start_us());
+        return Simulator::now_us() + _virtual_offset_us + elapsed * _virtual_skew_ppm / 1000000;
+    }
+    return FastClock::system_us();
 }
 
-void TimeKeeper::update_time_keeper(U64 system_timestamp, U64 local_timestamp) {
-    if (is_t1) {
-        t1 = system_timestamp;
-        t2 = local_timestamp;
+void TimeKeeper::update_sync_beacon(uint32_t sequence, U64 origin_timestamp, U64 follow_up, uint32_t follow_up_sequence,
+                                    U64 local_timestamp) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    bool accepted = true;
+    if (follow_up == 0) {
+        // RSU without TX timestamps: one-step
+        accepted = _estimator.add(origin_timestamp, local_timestamp);
+    } else if (_has_last_beacon && _last_beacon_sequence == follow_up_sequence) {
+        accepted = _estimator.add(follow_up, _last_beacon_local);
     } else {
-        t3 = system_timestamp;
-        t4 = local_timestamp;
-        
-        U64 delay = ((t4 - t3) + (t2  - t1)) / 2;
-        ConsoleLogger::log("Delay: " + std::to_string(delay));
-
-        offset = (t2 - t1) - delay;
-        last_update = local_timestamp;
-        sync_state = SyncState::SYNCHRONIZED;
+        // The send time of a beacon whose arrival we no longer hold
+        LOG_DEBUG("Dropped follow-up of beacon {} with beacon {}", follow_up_sequence, sequence);
     }
-    is_t1 = !is_t1;
-    ConsoleLogger::log("Fake Offset: " + std::to_string(fake_offset) + " | Offset: " + std::to_string(offset));
+    // A lost beacon costs one sample, the next pair is complete again
+    _has_last_beacon = true;
+    _last_beacon_sequence = sequence;
+    _last_beacon_local = local_timestamp;
+
+    if (!accepted) {
+        LOG_DEBUG("Rejected sync beacon {}", sequence);
+    }
+    evaluate_sync_state(local_timestamp);
 }
 
-void TimeKeeper::update_sync_status() {
-    auto elapsed_time = get_local_timestamp() - last_update;
-    if (elapsed_time > sync_timeout) {
-        sync_state = SyncState::NOT_SYNCHRONIZED;
+uint32_t TimeKeeper::wanted_beacon_interval() {
+    U64 local = get_local_timestamp();
+    std::lock_guard<std::mutex> lock(_mutex);
+    SyncQuality quality = _estimator.quality(local);
+    if (quality.samples < ClockEstimator::WINDOW / 2 || quality.error_us > Traits<TimeKeeper>::SYNC_ERROR_BOUND_US) {
+        return Traits<TimeKeeper>::BEACON_MIN_US;
     }
-}
\ No newline at end of file
+    // Skew below 1 ppm is not resolved by the window
+    double skew = std::max(std::fabs(quality.skew_ppm), 1.0) * 1e-6;
+    double interval = Traits<TimeKeeper>::DRIFT_BUDGET_US / skew;
+    if (interval < Traits<TimeKeeper>::BEACON_MIN_US) return Traits<TimeKeeper>::BEACON_MIN_US;
+    if (interval > Traits<TimeKeeper>::BEACON_MAX_US) return Traits<TimeKeeper>::BEACON_MAX_US;
+    return static_cast<uint32_t>(interval);
+}
+
+void TimeKeeper::update_sync_status() {
+    U64 local = get_local_timestamp();
+    std::lock_guard<std::mutex> lock(_mutex);
+    evaluate_sync_state(local);
+}
+
+// Synchronized means the offset is known to within the error bound, not merely that a frame arrived
+void TimeKeeper::evaluate_sync_state(U64 local_timestamp) {
+    SyncQuality quality = _estimator.quality(local_timestamp);
+    bool fresh = quality.age_us >= 0 && quality.age_us <= Traits<TimeKeeper>::SYNC_TIMEOUT_US;
+    bool accurate = quality.error_us <= Traits<TimeKeeper>::SYNC_ERROR_BOUND_US;
+    sync_state = (fresh && accurate) ? SyncState::SYNCHRONIZED : SyncState::NOT_SYNCHRONIZED;
+}
@@ -8,7 +8,6 @@
 
 Vehicle::Vehicle(int id, EthernetNIC* nic, EthernetProtocol* protocol, int lifetime) 
     : AutonomousAgent(nic, protocol), _lifetime(lifetime) {
-    _protocol->register_nic(_nic);
     _id = id;
     
     ConsoleLogger::log("Vehicle: dataset id " + std::to_string(_id) + " set");
@@ -28,6 +27,7 @@ void Vehicle::start() {
     _nic->set_quadrant(Traits<Vehicle>::pick_random_quadrant());
     
     ConsoleLogger::log("Starting Vehicle -> " + std::to_string(_id));
+    ThreadPlacement::configure("vehicle", _id);
     
     if (_running) {
         ConsoleLogger::log("Running: " + std::to_string(_running));
@@ -40,6 +40,7 @@ void Vehicle::start() {
 
     _running = true;
     ConsoleLogger::log("Threads running.");
+    ThreadPlacement::report();
 }
 
 void Vehicle::stop() {
@@ -1,20 +1,90 @@
 #include "../header/vehicle_table.h"
 
-VehicleTable::VehicleTable() {
-    _vehicles.clear();
+#include <cstring>
+
+const unsigned int VehicleTable::CAPACITY;
+const unsigned int VehicleTable::MAX_PROBE;
+const U64 VehicleTable::TTL_US;
+const uint64_t VehicleTable::USED;
+
+VehicleTable::VehicleTable() : _evictions(0) {
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "VehicleTable capacity must be a power of two");
+    static_assert(MAX_PROBE <= CAPACITY, "VehicleTable probe window larger than the table");
+    memset(_entries, 0, sizeof(_entries));
 
     ConsoleLogger::log("Created vehicle table");
 }
 
-bool VehicleTable::check_vehicle(Ethernet::Address* address) {
-    for(auto vehicle_add : _vehicles) {
-        if(memcmp(vehicle_add.data(), address, ETH_ALEN) == 0) {
+uint64_t VehicleTable::key_of(const Ethernet::Address* address) {
+    const unsigned char* bytes = *address;
+    uint64_t key = 0;
+    for (unsigned int i = 0; i < ETH_ALEN; i++) {
+        key = (key << 8) | bytes[i];
+    }
+    return key | USED;
+}
+
+unsigned int VehicleTable::home_of(uint64_t key) {
+    // Fibonacci hashing: vendor prefixes are shared, so mix every bit into the top ones
+    return static_cast<unsigned int>((key * 0x9E3779B97F4A7C15ULL) >> 40) & (CAPACITY - 1);
+}
+
+bool VehicleTable::check_vehicle(const Ethernet::Address* address, U64 now) {
+    uint64_t key = key_of(address);
+    unsigned int slot = home_of(key);
+
+    for (unsigned int i = 0; i < MAX_PROBE; i++, slot = (slot + 1) & (CAPACITY - 1)) {
+        Entry& entry = _entries[slot];
+        if (entry.key == 0) {
+            return false;
+        }
+        if (entry.key == key) {
+            if (!live(entry, now)) {
+                return false;
+            }
+            entry.last_seen = now;
             return true;
         }
     }
     return false;
 }
 
-void VehicleTable::set_vehicle(std::array<unsigned char, ETH_ALEN> address) {
-    _vehicles.push_back(address);
-}
\ No newline at end of file
+void VehicleTable::set_vehicle(const Ethernet::Address* address, U64 now) {
+    uint64_t key = key_of(address);
+    unsigned int slot = home_of(key);
+    Entry* target = nullptr;
+
+    for (unsigned int i = 0; i < MAX_PROBE; i++, slot = (slot + 1) & (CAPACITY - 1)) {
+        Entry& entry = _entries[slot];
+        if (entry.key == key) {
+            target = &entry;
+            break;
+        }
+        if (entry.key == 0) {
+            if (!target || live(*target, now)) {
+                target = &entry;
+            }
+            break;
+        }
+        // Prefer an expired slot, otherwise the least recently seen vehicle
+        if (!target || (live(*target, now) && (!live(entry, now) || entry.last_seen < target->last_seen))) {
+            target = &entry;
+        }
+    }
+
+    if (target->key != key && target->key != 0 && live(*target, now)) {
+        _evictions++;
+    }
+    target->key = key;
+    target->last_seen = now;
+}
+
+unsigned int VehicleTable::size(U64 now) const {
+    unsigned int count = 0;
+    for (unsigned int i = 0; i < CAPACITY; i++) {
+        if (_entries[i].key != 0 && live(_entries[i], now)) {
+            count++;
+        }
+    }
+    return count;
+}
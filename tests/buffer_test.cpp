@@ -2,6 +2,7 @@
 #include <cassert>
 #include <cstring>
 #include "../header/buffer.h"
+#include "../header/buffer_pool.h"
 
 struct TestData {
     int id;
@@ -156,6 +157,32 @@ bool test_buffer_different_types() {
     }
 }
 
+// try_alloc() nunca bloqueia: devolve nullptr com o pool esgotado e volta a servir após free()
+bool test_pool_try_alloc() {
+    BufferPool<char, 4> pool(64);
+    Buffer<char>* buffers[4];
+    for (int i = 0; i < 4; i++) {
+        buffers[i] = pool.try_alloc();
+        if (!buffers[i]) {
+            return false;
+        }
+    }
+    bool ok = pool.try_alloc() == nullptr;
+
+    pool.free(buffers[2]);
+    Buffer<char>* again = pool.try_alloc();
+    ok = ok && again == buffers[2] && pool.try_alloc() == nullptr;
+
+    for (int i = 0; i < 4; i++) {
+        pool.free(buffers[i]);
+    }
+    // O alloc() bloqueante ainda vê os quatro
+    for (int i = 0; i < 4; i++) {
+        ok = ok && pool.alloc() != nullptr;
+    }
+    return ok;
+}
+
 int main() {
     std::cout << "Iniciando testes para Buffer..." << std::endl;
     std::cout << "----------------------------------------" << std::endl;
@@ -197,6 +224,15 @@ int main() {
         failures++;
     }
     std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 5: Alocação sem bloqueio no BufferPool" << std::endl;
+    if (test_pool_try_alloc()) {
+        std::cout << "Teste 5: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 5: FALHOU" << std::endl;
+        failures++;
+    }
+    std::cout << "----------------------------------------" << std::endl;
     
     if (failures == 0) {
         std::cout << "TODOS OS TESTES PASSARAM!" << std::endl;
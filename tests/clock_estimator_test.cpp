@@ -0,0 +1,139 @@
+#include <iostream>
+#include <cmath>
+#include <random>
+#include "../header/clock_estimator.h"
+
+// Relógio da RSU: deslocamento inicial + deriva em ppm, atraso de caminho com jitter
+struct ReferenceClock {
+    double offset_us;
+    double skew_ppm;
+
+    U64 system_at(U64 local) const {
+        return local + static_cast<U64>(std::llround(offset_us + skew_ppm * 1e-6 * static_cast<double>(local - START)));
+    }
+
+    static const U64 START = 1700000000000000LL;
+};
+
+const U64 ReferenceClock::START;
+
+// Deslocamento e deriva recuperados apesar do jitter
+bool test_offset_and_skew() {
+    ReferenceClock rsu = {2500.0, 40.0};
+    ClockEstimator estimator;
+    std::mt19937 gen(1);
+    std::normal_distribution<double> jitter(0, 3);
+
+    U64 local = ReferenceClock::START;
+    for (unsigned int i = 0; i < 200; i++, local += 1000) {
+        U64 arrival = local + static_cast<U64>(std::llround(std::fabs(jitter(gen))));
+        estimator.add(rsu.system_at(local), arrival);
+    }
+
+    ClockEstimator::Quality quality = estimator.quality(local);
+    double truth = rsu.offset_us + rsu.skew_ppm * 1e-6 * static_cast<double>(local - ReferenceClock::START);
+    std::cout << "  offset erro: " << quality.offset_us - truth << " us | deriva: " << quality.skew_ppm
+              << " ppm | limite: " << quality.error_us << " us" << std::endl;
+
+    // O atraso médio do caminho (~2.4 us) fica no deslocamento: amostras são de uma via
+    return std::fabs(quality.offset_us - truth) < 6 && std::fabs(quality.skew_ppm - rsu.skew_ppm) < 20 && quality.error_us < 20;
+}
+
+// Atrasos de escalonamento grandes são descartados sem mover o ajuste
+bool test_outlier_rejection() {
+    ReferenceClock rsu = {-800.0, 0.0};
+    ClockEstimator estimator;
+
+    U64 local = ReferenceClock::START;
+    for (unsigned int i = 0; i < 100; i++, local += 1000) {
+        U64 delay = (i % 10 == 9) ? 500 : (i % 3);
+        estimator.add(rsu.system_at(local), local + delay);
+    }
+
+    ClockEstimator::Quality quality = estimator.quality(local);
+    return quality.rejected >= 9 && std::fabs(quality.offset_us - rsu.offset_us) < 3;
+}
+
+// Um salto persistente do relógio de referência reinicia a janela
+bool test_clock_step() {
+    ClockEstimator estimator;
+    U64 local = ReferenceClock::START;
+    for (unsigned int i = 0; i < 40; i++, local += 1000) {
+        estimator.add(local + 100, local);
+    }
+    for (unsigned int i = 0; i < 40; i++, local += 1000) {
+        estimator.add(local + 10100, local);
+    }
+    return std::fabs(estimator.quality(local).offset_us - 10100) < 1;
+}
+
+// Sem amostras suficientes não há limite de erro
+bool test_error_bound_needs_samples() {
+    ClockEstimator estimator;
+    if (estimator.fitted() || estimator.quality(0).error_us != HUGE_VAL) return false;
+
+    U64 local = ReferenceClock::START;
+    for (unsigned int i = 0; i + 1 < ClockEstimator::MIN_SAMPLES; i++, local += 1000) {
+        estimator.add(local + 5 + (i % 2), local);
+    }
+    if (estimator.quality(local).error_us != HUGE_VAL) return false;
+
+    estimator.add(local + 5, local);
+    return estimator.quality(local).error_us < 10;
+}
+
+int main() {
+    int failures = 0;
+
+    std::cout << "Iniciando testes para ClockEstimator..." << std::endl;
+
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 1: Deslocamento e deriva" << std::endl;
+    if (test_offset_and_skew()) {
+        std::cout << "Teste 1: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 1: FALHOU" << std::endl;
+        failures ++;
+    }
+
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 2: Rejeição de outliers" << std::endl;
+    if (test_outlier_rejection()) {
+        std::cout << "Teste 2: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 2: FALHOU" << std::endl;
+        failures ++;
+    }
+
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 3: Salto do relógio de referência" << std::endl;
+    if (test_clock_step()) {
+        std::cout << "Teste 3: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 3: FALHOU" << std::endl;
+        failures ++;
+    }
+
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 4: Limite de erro exige amostras" << std::endl;
+    if (test_error_bound_needs_samples()) {
+        std::cout << "Teste 4: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 4: FALHOU" << std::endl;
+        failures ++;
+    }
+
+    std::cout << "----------------------------------------" << std::endl;
+
+    if (failures == 0) {
+        std::cout << "TODOS OS TESTES PASSARAM!" << std::endl;
+        return 0;
+    } else {
+        std::cout << failures << " TESTE(S) FALHARAM!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,109 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <time.h>
+
+#include "../header/fast_clock.h"
+
+const int ITERATIONS = 200000;
+const int REPETITIONS = 5;
+const int JITTER_SAMPLES = 100000;
+
+typedef U64 (*ReadFunction)();
+
+U64 read_system_clock() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+U64 read_clock_gettime() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<U64>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+U64 read_clock_gettime_coarse() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    return static_cast<U64>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+// Per-call cost in nanoseconds, best of REPETITIONS
+double cost_ns(ReadFunction read) {
+    double best = 1e30;
+    volatile U64 sink = 0;
+    for (int r = 0; r < REPETITIONS; r++) {
+        U64 start = read_clock_gettime();
+        for (int i = 0; i < ITERATIONS; i++) {
+            sink = sink + read();
+        }
+        best = std::min(best, static_cast<double>(read_clock_gettime() - start) / ITERATIONS);
+    }
+    return best;
+}
+
+// Gaps between back-to-back reads in the clock's own unit: zero gaps show the
+// resolution, the tail shows preemption and calibration steps
+void jitter(const char* name, ReadFunction read, const char* unit) {
+    std::vector<U64> gaps(JITTER_SAMPLES);
+    U64 previous = read();
+    unsigned int backwards = 0;
+    for (int i = 0; i < JITTER_SAMPLES; i++) {
+        U64 now = read();
+        if (now < previous) backwards++;
+        gaps[i] = now - previous;
+        previous = now;
+    }
+    std::sort(gaps.begin(), gaps.end());
+    unsigned int zeros = std::count(gaps.begin(), gaps.end(), 0);
+
+    std::cout << std::left << std::setw(32) << name << std::right
+              << " zero " << std::setw(6) << std::fixed << std::setprecision(1) << 100.0 * zeros / JITTER_SAMPLES << "%"
+              << " | p50 " << std::setw(8) << gaps[JITTER_SAMPLES / 2]
+              << " | p99 " << std::setw(8) << gaps[JITTER_SAMPLES * 99 / 100]
+              << " | max " << std::setw(8) << gaps.back() << " " << unit
+              << (backwards ? " | BACKWARDS " + std::to_string(backwards) : std::string()) << std::endl;
+}
+
+int main() {
+    std::cout << "FastClock source: " << FastClock::source_name(FastClock::source())
+              << " | resolution " << FastClock::resolution_ns() << " ns" << std::endl;
+
+    std::cout << std::endl << "Per-call cost (ns, best of " << REPETITIONS << " runs)" << std::endl;
+    std::cout << std::left << std::setw(32) << "system_clock::now + cast" << std::right << std::fixed << std::setprecision(1) << cost_ns(read_system_clock) << std::endl;
+    std::cout << std::left << std::setw(32) << "clock_gettime MONOTONIC" << std::right << cost_ns(read_clock_gettime) << std::endl;
+    std::cout << std::left << std::setw(32) << "clock_gettime COARSE" << std::right << cost_ns(read_clock_gettime_coarse) << std::endl;
+
+    const FastClock::Source sources[] = {FastClock::TSC, FastClock::MONOTONIC, FastClock::MONOTONIC_COARSE};
+    FastClock::Source original = FastClock::source();
+    for (FastClock::Source source : sources) {
+        if (!FastClock::use(source)) continue;
+        std::string name = std::string("FastClock ") + FastClock::source_name(source);
+        std::cout << std::left << std::setw(32) << (name + " ns") << std::right << cost_ns(FastClock::monotonic_ns) << std::endl;
+        std::cout << std::left << std::setw(32) << (name + " us") << std::right << cost_ns(FastClock::system_us) << std::endl;
+    }
+
+    std::cout << std::endl << "Back-to-back gaps" << std::endl;
+    jitter("system_clock::now", read_system_clock, "us");
+    for (FastClock::Source source : sources) {
+        if (!FastClock::use(source)) continue;
+        std::string name = std::string("FastClock ") + FastClock::source_name(source);
+        jitter((name + " ns").c_str(), FastClock::monotonic_ns, "ns");
+        jitter((name + " us").c_str(), FastClock::system_us, "us");
+    }
+    FastClock::use(original);
+
+    // Mapping onto the wall clock
+    U64 drift_max = 0;
+    for (int i = 0; i < 1000; i++) {
+        U64 wall = read_system_clock();
+        U64 fast = FastClock::system_us();
+        U64 diff = fast > wall ? fast - wall : wall - fast;
+        drift_max = std::max(drift_max, diff);
+    }
+    std::cout << std::endl << "Max |FastClock::system_us - system_clock| = " << drift_max << " us" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,187 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <unistd.h>
+
+#include "../header/dataset_cursor.h"
+
+static std::string temporary(const std::string& name) {
+    return "/tmp/dataset_cursor_test_" + std::to_string(getpid()) + "_" + name;
+}
+
+// Linhas a cada 100 ms, com uma pausa de 5 s depois da linha 9
+static bool open_synthetic(Dataset& dataset, std::vector<U64>& timestamps) {
+    std::string csv = temporary("synthetic.csv");
+    std::string binary = temporary("synthetic.bin");
+    std::ofstream out(csv);
+    out << "timestamp,id,x,y,speed,heading,yawrate,acceleration\n";
+    U64 timestamp = 1000000;
+    for (int i = 0; i < 20; i++) {
+        timestamps.push_back(timestamp);
+        // heading passa de +3.1 para -3.1 entre as linhas 4 e 5
+        double heading = i < 5 ? 3.1 : -3.1;
+        out << timestamp << ",0," << i << "," << 2 * i << "," << 10 + i << "," << heading << ",0," << i % 2 << "\n";
+        timestamp += i == 9 ? 5000000 : 100000;
+    }
+    out.close();
+    bool ok = Dataset::convert(csv, binary) && dataset.open(binary);
+    unlink(csv.c_str());
+    unlink(binary.c_str());
+    return ok;
+}
+
+// seek() acha a última linha <= t em qualquer ordem de consulta
+bool test_seek() {
+    Dataset dataset;
+    std::vector<U64> timestamps;
+    if (!open_synthetic(dataset, timestamps)) {
+        return false;
+    }
+    DatasetCursor cursor(&dataset);
+    bool ok = cursor.valid() && cursor.seek(0) == 0 && cursor.seek(timestamps.back() + 1000000) == 19;
+
+    // Avanços, saltos e recuos
+    U64 probes[] = {1000000, 1000050, 1100000, 1950000, 7000000, 6800000, 1250000, 999999, 7500000, 1899999, 6900001};
+    for (U64 probe : probes) {
+        uint64_t expected = std::upper_bound(timestamps.begin(), timestamps.end(), probe) - timestamps.begin();
+        expected = expected > 0 ? expected - 1 : 0;
+        ok = ok && cursor.seek(probe) == expected && cursor.row() == expected;
+    }
+
+    DatasetCursor empty;
+    ok = ok && !empty.valid() && empty.seek(1000000) == 0 && std::isnan(empty.sample(0, 1000000));
+    return ok;
+}
+
+// Linear entre linhas, hold no modo HOLD, nas pontas e através de pausas
+bool test_interpolation() {
+    Dataset dataset;
+    std::vector<U64> timestamps;
+    if (!open_synthetic(dataset, timestamps)) {
+        return false;
+    }
+    unsigned int x = dataset.column("x");
+    unsigned int heading = dataset.column("heading");
+    DatasetCursor cursor(&dataset);
+
+    bool ok = cursor.sample(x, 1050000) == 0.5 && cursor.sample(x, 1100000) == 1.0 && cursor.sample(x, 1175000) == 1.75;
+    ok = ok && cursor.sample(x, 0) == 0.0 && cursor.sample(x, timestamps.back() + 1) == 19.0;
+    // Pausa de 5 s: mantém a linha 9
+    ok = ok && cursor.sample(x, timestamps[9] + 2500000) == 9.0;
+    // Ângulo pelo arco menor: no meio de +3.1 e -3.1 está pi
+    ok = ok && std::fabs(std::fabs(cursor.sample(heading, timestamps[4] + 50000)) - 3.1 - 0.0415926535) < 1e-6;
+    // Coluna inteira não é amostrada
+    ok = ok && std::isnan(cursor.sample(dataset.column("id"), 1050000));
+
+    cursor.interpolation(DatasetCursor::HOLD);
+    ok = ok && cursor.sample(x, 1050000) == 0.0 && cursor.sample(x, 1199999) == 1.0;
+    return ok;
+}
+
+// Vários campos no mesmo instante
+bool test_kinematics() {
+    Dataset dataset;
+    std::vector<U64> timestamps;
+    if (!open_synthetic(dataset, timestamps)) {
+        return false;
+    }
+    DatasetCursor cursor(&dataset);
+    DatasetCursor::Kinematics k;
+    bool ok = cursor.kinematics(1150000, k) && k.x == 1.5 && k.y == 3.0 && k.speed == 11.5 && k.heading == 3.1 &&
+              k.yawrate == 0.0 && k.acceleration == 0.5;
+
+    // Dataset sem as colunas de estado
+    std::string csv = temporary("partial.csv");
+    std::string binary = temporary("partial.bin");
+    std::ofstream(csv) << "timestamp,speed\n1,2.0\n";
+    Dataset partial;
+    ok = ok && Dataset::convert(csv, binary) && partial.open(binary);
+    DatasetCursor partial_cursor(&partial);
+    ok = ok && partial_cursor.valid() && !partial_cursor.kinematics(1, k);
+    unlink(csv.c_str());
+    unlink(binary.c_str());
+    return ok;
+}
+
+// Dataset real amostrado em outro período que o da gravação
+bool test_vehicle_dataset() {
+    std::vector<char> binary;
+    Dataset dataset;
+    if (!Dataset::encode("dataset/perception-vehicle_0.csv", binary) || !dataset.view(binary.data(), binary.size())) {
+        return false;
+    }
+    const U64* timestamps = dataset.timestamps();
+    const double* speed = dataset.reals(dataset.column("speed"));
+    DatasetCursor cursor(&dataset);
+
+    // Nos instantes das linhas, os valores das linhas
+    bool ok = true;
+    for (uint64_t row = 0; row < dataset.rows(); row += 997) {
+        ok = ok && cursor.sample(dataset.column("speed"), timestamps[row]) == speed[row];
+    }
+
+    // Período de 33 ms do início ao fim
+    unsigned long samples = 0;
+    DatasetCursor::Kinematics k;
+    auto start = std::chrono::steady_clock::now();
+    for (U64 t = dataset.first_timestamp(); t <= dataset.last_timestamp(); t += 33000) {
+        ok = ok && cursor.kinematics(t, k) && !std::isnan(k.x);
+        samples++;
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    ok = ok && cursor.seek(dataset.last_timestamp()) == dataset.rows() - 1;
+    std::cout << samples << " amostras, " << elapsed / (samples ? samples : 1) << " ns por amostra" << std::endl;
+    return ok;
+}
+
+int main() {
+    int failures = 0;
+
+    std::cout << "Teste 1: Busca por timestamp" << std::endl;
+    if (test_seek()) {
+        std::cout << "Teste 1: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 1: FALHOU" << std::endl;
+        failures++;
+    }
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 2: Interpolação" << std::endl;
+    if (test_interpolation()) {
+        std::cout << "Teste 2: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 2: FALHOU" << std::endl;
+        failures++;
+    }
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 3: Campos em lote" << std::endl;
+    if (test_kinematics()) {
+        std::cout << "Teste 3: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 3: FALHOU" << std::endl;
+        failures++;
+    }
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 4: Dataset de veículo" << std::endl;
+    if (test_vehicle_dataset()) {
+        std::cout << "Teste 4: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 4: FALHOU" << std::endl;
+        failures++;
+    }
+    std::cout << "----------------------------------------" << std::endl;
+
+    if (failures == 0) {
+        std::cout << "TODOS OS TESTES PASSARAM!" << std::endl;
+        return 0;
+    } else {
+        std::cout << failures << " TESTE(S) FALHARAM!" << std::endl;
+        return 1;
+    }
+}
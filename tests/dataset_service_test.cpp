@@ -0,0 +1,127 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#include <csignal>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include "../header/dataset_service.h"
+
+static std::string directory() {
+    return "/tmp/dataset_service_test_" + std::to_string(getpid());
+}
+
+static void write_csv(int id, double acceleration) {
+    std::ofstream out(Dataset::path(id, directory(), ".csv"));
+    out << "timestamp,id,acceleration\n"
+        << "1000,0," << acceleration << "\n"
+        << "1100,0," << acceleration + 1 << "\n";
+}
+
+static void clean() {
+    for (int id = 0; id < 3; id++) {
+        unlink(Dataset::path(id, directory(), ".csv").c_str());
+        unlink(Dataset::path(id, directory(), ".bin").c_str());
+    }
+    rmdir(directory().c_str());
+}
+
+static double acceleration(const Dataset* dataset, uint64_t row) {
+    return dataset->reals(dataset->column("acceleration"))[row];
+}
+
+// CSVs sem .bin são convertidos na carga; o .bin tem preferência
+bool test_load() {
+    mkdir(directory().c_str(), 0700);
+    write_csv(0, 1.0);
+    write_csv(1, 2.0);
+    write_csv(2, 3.0);
+    // Dataset 1 já convertido, com outro conteúdo que o CSV
+    write_csv(1, 20.0);
+    bool ok = Dataset::convert(Dataset::path(1, directory(), ".csv"), Dataset::path(1, directory(), ".bin"));
+    write_csv(1, 2.0);
+
+    ok = ok && DatasetService::load(directory()) && DatasetService::loaded() && DatasetService::count() == 3;
+    ok = ok && acceleration(DatasetService::get(0), 0) == 1.0 && acceleration(DatasetService::get(1), 1) == 21.0 &&
+         acceleration(DatasetService::get(2), 0) == 3.0;
+    // Mais veículos que datasets: volta ao início
+    ok = ok && DatasetService::get(4) == DatasetService::get(1) && DatasetService::get(-1) == nullptr;
+    return ok;
+}
+
+// Processos filhos leem as mesmas páginas, sem abrir arquivo algum
+bool test_fork() {
+    if (!DatasetService::loaded()) {
+        return false;
+    }
+    const Dataset* parent_view = DatasetService::get(2);
+    clean();
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        const Dataset* child_view = DatasetService::get(2);
+        bool same = child_view == parent_view && child_view->rows() == 2 && acceleration(child_view, 1) == 4.0;
+        _exit(same ? 0 : 1);
+    }
+    int status = 0;
+    return pid > 0 && waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+// O mapeamento é somente leitura: escrever nele derruba o processo
+bool test_read_only() {
+    pid_t pid = fork();
+    if (pid == 0) {
+        double* value = const_cast<double*>(DatasetService::get(0)->reals(DatasetService::get(0)->column("acceleration")));
+        *value = 0;
+        _exit(0);
+    }
+    int status = 0;
+    bool ok = pid > 0 && waitpid(pid, &status, 0) == pid && WIFSIGNALED(status) && WTERMSIG(status) == SIGSEGV;
+
+    DatasetService::unload();
+    ok = ok && !DatasetService::loaded() && DatasetService::get(0) == nullptr && DatasetService::bytes() == 0;
+    // Diretório sem datasets
+    ok = ok && !DatasetService::load(directory());
+    return ok;
+}
+
+int main() {
+    int failures = 0;
+
+    std::cout << "Teste 1: Carga dos datasets" << std::endl;
+    if (test_load()) {
+        std::cout << "Teste 1: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 1: FALHOU" << std::endl;
+        failures++;
+    }
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 2: Compartilhado com processos filhos" << std::endl;
+    if (test_fork()) {
+        std::cout << "Teste 2: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 2: FALHOU" << std::endl;
+        failures++;
+    }
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 3: Somente leitura" << std::endl;
+    if (test_read_only()) {
+        std::cout << "Teste 3: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 3: FALHOU" << std::endl;
+        failures++;
+    }
+    std::cout << "----------------------------------------" << std::endl;
+
+    clean();
+    if (failures == 0) {
+        std::cout << "TODOS OS TESTES PASSARAM!" << std::endl;
+        return 0;
+    } else {
+        std::cout << failures << " TESTE(S) FALHARAM!" << std::endl;
+        return 1;
+    }
+}
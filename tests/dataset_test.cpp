@@ -0,0 +1,154 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <unistd.h>
+
+#include "../header/dataset.h"
+
+static std::string temporary(const std::string& name) {
+    return "/tmp/dataset_test_" + std::to_string(getpid()) + "_" + name;
+}
+
+// Colunas por nome, timestamp sempre primeiro, campo vazio vira NaN
+bool test_convert() {
+    std::string csv = temporary("small.csv");
+    std::string binary = temporary("small.bin");
+    std::ofstream out(csv);
+    out << "id,timestamp,speed,acceleration\n"
+        << "7,1000,10.5,0.25\n"
+        << "7,1100,,-1.5\n"
+        << "7,1200,11.0,2\n";
+    out.close();
+
+    bool ok = Dataset::convert(csv, binary);
+    Dataset dataset;
+    ok = ok && dataset.open(binary);
+    ok = ok && dataset.rows() == 3 && dataset.columns() == 4 && dataset.name(0) == "timestamp" &&
+         dataset.first_timestamp() == 1000 && dataset.last_timestamp() == 1200;
+
+    int id = dataset.column("id");
+    int speed = dataset.column("speed");
+    int acceleration = dataset.column("acceleration");
+    ok = ok && id > 0 && speed > 0 && acceleration > 0 && dataset.column("heading") == -1;
+    ok = ok && dataset.type(id) == Dataset::INTEGER && dataset.type(speed) == Dataset::REAL;
+    // Tipo errado não devolve ponteiro
+    ok = ok && dataset.reals(id) == nullptr && dataset.integers(speed) == nullptr && dataset.reals(9) == nullptr;
+    if (ok) {
+        const U64* timestamps = dataset.timestamps();
+        const double* speeds = dataset.reals(speed);
+        const double* accelerations = dataset.reals(acceleration);
+        ok = timestamps[1] == 1100 && dataset.integers(id)[2] == 7 && speeds[0] == 10.5 && std::isnan(speeds[1]) &&
+             accelerations[1] == -1.5 && accelerations[2] == 2.0;
+        ok = ok && reinterpret_cast<uintptr_t>(speeds) % Dataset::ALIGNMENT == 0;
+    }
+
+    dataset.close();
+    ok = ok && !dataset.is_open() && dataset.rows() == 0;
+    unlink(csv.c_str());
+    unlink(binary.c_str());
+    return ok;
+}
+
+// Arquivos ausentes, truncados ou de outro formato são recusados
+bool test_invalid() {
+    Dataset dataset;
+    bool ok = !dataset.open(temporary("missing.bin"));
+
+    std::string csv = temporary("invalid.csv");
+    std::ofstream(csv) << "id,speed\n1,2.0\n";
+    ok = ok && !Dataset::convert(csv, temporary("invalid.bin"));
+
+    std::string binary = temporary("truncated.bin");
+    std::ofstream(csv) << "timestamp,speed\n1,2.0\n2,3.0\n";
+    ok = ok && Dataset::convert(csv, binary);
+    ok = ok && truncate(binary.c_str(), sizeof(Dataset::Header) + sizeof(Dataset::Descriptor) + 8) == 0;
+    ok = ok && !dataset.open(binary);
+
+    std::ofstream(binary) << "timestamp,speed\n1,2.0\n2,3.0\nplain text, not a dataset at all\n";
+    ok = ok && !dataset.open(binary) && !dataset.is_open();
+
+    unlink(csv.c_str());
+    unlink(binary.c_str());
+    return ok;
+}
+
+// Dataset real: mesmas linhas do CSV e abertura sem parsing
+bool test_vehicle_dataset() {
+    std::string csv = "dataset/perception-vehicle_0.csv";
+    std::string binary = temporary("vehicle.bin");
+    unsigned long lines = 0;
+    std::string line, last;
+    std::ifstream in(csv);
+    while (std::getline(in, line)) {
+        lines++;
+        last = line;
+    }
+    if (lines < 2) {
+        std::cout << "Dataset " << csv << " ausente" << std::endl;
+        return false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    bool ok = Dataset::convert(csv, binary);
+    auto converted = std::chrono::steady_clock::now();
+    Dataset dataset;
+    ok = ok && dataset.open(binary);
+    auto opened = std::chrono::steady_clock::now();
+
+    int acceleration = dataset.column("acceleration");
+    ok = ok && dataset.rows() == lines - 1 && acceleration >= 0;
+    if (ok) {
+        // Último campo da última linha
+        double expected = std::stod(last.substr(last.rfind(',') + 1));
+        ok = dataset.reals(acceleration)[dataset.rows() - 1] == expected &&
+             dataset.last_timestamp() == std::stoll(last.substr(0, last.find(',')));
+    }
+    std::cout << dataset.rows() << " linhas: conversão "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(converted - start).count() << " ms, abertura "
+              << std::chrono::duration_cast<std::chrono::microseconds>(opened - converted).count() << " us" << std::endl;
+
+    unlink(binary.c_str());
+    return ok;
+}
+
+int main() {
+    int failures = 0;
+
+    std::cout << "Teste 1: Conversão de CSV" << std::endl;
+    if (test_convert()) {
+        std::cout << "Teste 1: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 1: FALHOU" << std::endl;
+        failures++;
+    }
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 2: Arquivos inválidos" << std::endl;
+    if (test_invalid()) {
+        std::cout << "Teste 2: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 2: FALHOU" << std::endl;
+        failures++;
+    }
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 3: Dataset de veículo" << std::endl;
+    if (test_vehicle_dataset()) {
+        std::cout << "Teste 3: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 3: FALHOU" << std::endl;
+        failures++;
+    }
+    std::cout << "----------------------------------------" << std::endl;
+
+    if (failures == 0) {
+        std::cout << "TODOS OS TESTES PASSARAM!" << std::endl;
+        return 0;
+    } else {
+        std::cout << failures << " TESTE(S) FALHARAM!" << std::endl;
+        return 1;
+    }
+}
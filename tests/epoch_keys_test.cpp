@@ -0,0 +1,138 @@
+#include <iostream>
+#include <cassert>
+#include <thread>
+#include <atomic>
+#include "../header/epoch_keys.h"
+#include "../header/mac_key_table.h"
+
+// Chave sintética: todos os bytes iguais ao número da época
+Ethernet::MAC_KEY key_of(uint32_t epoch) {
+    Ethernet::MAC_KEY key;
+    key.fill(static_cast<unsigned char>(epoch));
+    return key;
+}
+
+// Anúncio (E, E+1) mantém E-1 para a janela de sobreposição
+bool test_publish_and_overlap() {
+    EpochKeys keys;
+    Ethernet::MAC_KEY key;
+    uint32_t epoch;
+
+    assert(keys.empty());
+    assert(!keys.find(1, key));
+
+    keys.publish(10, key_of(10), key_of(11));
+    assert(keys.find(10, key) && key == key_of(10));
+    assert(keys.find(11, key) && key == key_of(11));
+    assert(!keys.find(9, key));
+
+    // O emissor assina com a chave mais nova que não passou do relógio
+    assert(keys.latest(10, epoch, key) && epoch == 10);
+    assert(keys.latest(12, epoch, key) && epoch == 11);
+    assert(!keys.latest(9, epoch, key));
+
+    keys.publish(11, key_of(11), key_of(12));
+    assert(keys.find(10, key) && key == key_of(10));
+    assert(keys.find(12, key) && key == key_of(12));
+
+    // Duas épocas depois a mais antiga sai
+    keys.publish(12, key_of(12), key_of(13));
+    assert(!keys.find(10, key));
+    assert(keys.find(11, key));
+    return true;
+}
+
+// Leitores sem lock nunca veem um conjunto misturado de versões
+bool test_concurrent_readers() {
+    EpochKeys keys;
+    keys.publish(1, key_of(1), key_of(2));
+
+    std::atomic<bool> running(true);
+    std::atomic<int> torn(0);
+
+    auto reader = [&]() {
+        while (running.load()) {
+            EpochKeys::Set set = keys.snapshot();
+            for (unsigned int i = 0; i < set.count; i++) {
+                if (set.key[i] != key_of(set.epoch[i])) torn++;
+            }
+        }
+    };
+
+    std::thread r1(reader);
+    std::thread r2(reader);
+    for (uint32_t epoch = 2; epoch < 200000; epoch++) {
+        keys.publish(epoch, key_of(epoch), key_of(epoch + 1));
+    }
+    running = false;
+    r1.join();
+    r2.join();
+
+    return torn.load() == 0;
+}
+
+// Tabela por quadrante: índices fora de 1..N nunca acertam
+bool test_key_table() {
+    MACKeyTable<4> table;
+    Ethernet::MAC_KEY key;
+    uint32_t epoch;
+
+    for (unsigned int q = 1; q <= 4; q++) {
+        if (!table.empty(q)) return false;
+        table.publish(q, 100 + q, key_of(q), key_of(q + 10));
+    }
+    table.publish(0, 1, key_of(0), key_of(0));
+    table.publish(5, 1, key_of(5), key_of(5));
+
+    for (unsigned int q = 1; q <= 4; q++) {
+        if (!table.find(q, 100 + q, key) || key != key_of(q)) return false;
+        if (!table.latest(q, 200, epoch, key) || epoch != 101 + q || key != key_of(q + 10)) return false;
+    }
+    return !table.find(0, 1, key) && !table.find(5, 1, key) && table.empty(5);
+}
+
+int main() {
+    int failures = 0;
+
+    std::cout << "Iniciando testes para EpochKeys..." << std::endl;
+
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 1: Publicação e sobreposição de épocas" << std::endl;
+    if (test_publish_and_overlap()) {
+        std::cout << "Teste 1: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 1: FALHOU" << std::endl;
+        failures ++;
+    }
+
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 2: Leitores concorrentes" << std::endl;
+    if (test_concurrent_readers()) {
+        std::cout << "Teste 2: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 2: FALHOU" << std::endl;
+        failures ++;
+    }
+
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 3: Tabela de chaves por quadrante" << std::endl;
+    if (test_key_table()) {
+        std::cout << "Teste 3: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 3: FALHOU" << std::endl;
+        failures ++;
+    }
+
+    std::cout << "----------------------------------------" << std::endl;
+
+    if (failures == 0) {
+        std::cout << "TODOS OS TESTES PASSARAM!" << std::endl;
+        return 0;
+    } else {
+        std::cout << failures << " TESTE(S) FALHARAM!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,215 @@
+#include <iostream>
+#include <cstring>
+#include <set>
+#include "../header/key_distribution.h"
+
+typedef KeyDistribution<256> Queue;
+
+void address_of(unsigned int n, Ethernet::Address& address) {
+    unsigned char base[ETH_ALEN] = {0x02, 0x00, 0x5e, 0, 0, 0};
+    memcpy(address, base, ETH_ALEN);
+    address[4] = static_cast<unsigned char>(n >> 8);
+    address[5] = static_cast<unsigned char>(n);
+}
+
+// Vários veículos novos no mesmo instante vão no mesmo quadro, nenhum se perde
+bool test_batching() {
+    Queue* queue = new Queue();
+    Ethernet::Address address;
+    Ethernet::Address out[32];
+    bool ok = true;
+
+    for (unsigned int i = 0; i < 3; i++) {
+        address_of(i, address);
+        ok = ok && queue->enqueue(address, 1000);
+    }
+    // Repetir um veículo pendente não duplica
+    address_of(1, address);
+    ok = ok && queue->enqueue(address, 1000) && queue->pending() == 3;
+
+    ok = ok && queue->collect(1000, out, 32) == 3;
+    for (unsigned int i = 0; i < 3 && ok; i++) {
+        address_of(i, address);
+        ok = memcmp(out[i], address, ETH_ALEN) == 0;
+    }
+    // Ninguém está vencido logo após o envio
+    ok = ok && queue->collect(1000, out, 32) == 0;
+
+    delete queue;
+    return ok;
+}
+
+// Retransmissão com recuo exponencial até a confirmação
+bool test_backoff_and_confirm() {
+    Queue* queue = new Queue();
+    Ethernet::Address address;
+    Ethernet::Address out[4];
+    address_of(7, address);
+    queue->enqueue(address, 0);
+
+    U64 now = 0;
+    U64 expected = Queue::RETRY_BASE_US;
+    bool ok = queue->collect(now, out, 4) == 1;
+    for (unsigned int attempt = 1; attempt < 5 && ok; attempt++) {
+        ok = queue->collect(now + expected - 1, out, 4) == 0;
+        now += expected;
+        ok = ok && queue->collect(now, out, 4) == 1;
+        expected *= 2;
+    }
+
+    ok = ok && queue->confirm(address) && queue->pending() == 0;
+    ok = ok && !queue->confirm(address);
+    ok = ok && queue->collect(now + Queue::RETRY_MAX_US, out, 4) == 0;
+
+    delete queue;
+    return ok;
+}
+
+// Sem confirmação o veículo é abandonado depois de MAX_ATTEMPTS quadros
+bool test_give_up() {
+    Queue* queue = new Queue();
+    Ethernet::Address address;
+    Ethernet::Address out[4];
+    address_of(9, address);
+    queue->enqueue(address, 0);
+
+    unsigned int sent = 0;
+    for (U64 now = 0; now < 100 * Queue::RETRY_MAX_US; now += 1000) {
+        sent += queue->collect(now, out, 4);
+    }
+
+    bool ok = sent == Queue::MAX_ATTEMPTS && queue->pending() == 0 && queue->given_up() == 1;
+    delete queue;
+    return ok;
+}
+
+// Centenas de veículos ao mesmo tempo: todos atendidos em lotes, cada um uma vez
+bool test_bounded_onboarding() {
+    Queue* queue = new Queue();
+    Ethernet::Address address;
+    Ethernet::Address out[32];
+    bool ok = true;
+
+    for (unsigned int i = 0; i < 256; i++) {
+        address_of(i, address);
+        ok = ok && queue->enqueue(address, 0);
+    }
+    address_of(1000, address);
+    ok = ok && !queue->enqueue(address, 0) && queue->overflows() == 1;
+
+    // Quadro de sincronização a cada 1 ms, 32 veículos por quadro
+    std::set<unsigned int> served;
+    U64 now = 0;
+    for (unsigned int frame = 0; frame < 8 && ok; frame++, now += 1000) {
+        unsigned int taken = queue->collect(now, out, 32);
+        ok = taken == 32;
+        for (unsigned int i = 0; i < taken; i++) {
+            served.insert((out[i][4] << 8) | out[i][5]);
+            ok = ok && queue->confirm(out[i]);
+        }
+    }
+
+    ok = ok && served.size() == 256 && queue->pending() == 0;
+    delete queue;
+    return ok;
+}
+
+// Entradas e confirmações intercaladas: o índice por MAC segue a fila
+bool test_index_churn() {
+    Queue* queue = new Queue();
+    Ethernet::Address address;
+    std::set<unsigned int> expected;
+    bool ok = true;
+
+    unsigned int seed = 12345;
+    for (unsigned int step = 0; step < 20000 && ok; step++) {
+        seed = seed * 1103515245 + 12345;
+        unsigned int n = (seed >> 16) % 600;
+        address_of(n, address);
+        if ((seed >> 8) & 1) {
+            bool accepted = queue->enqueue(address, 0);
+            if (accepted) {
+                expected.insert(n);
+            }
+            ok = accepted || expected.size() == 256;
+        } else {
+            ok = queue->confirm(address) == (expected.erase(n) == 1);
+        }
+        ok = ok && queue->pending() == expected.size();
+    }
+    // Todos os que restam ainda são encontrados
+    for (unsigned int n : expected) {
+        address_of(n, address);
+        ok = ok && queue->confirm(address);
+    }
+
+    ok = ok && queue->pending() == 0;
+    delete queue;
+    return ok;
+}
+
+int main() {
+    int failures = 0;
+
+    std::cout << "Iniciando testes para KeyDistribution..." << std::endl;
+
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 1: Lote de veículos novos" << std::endl;
+    if (test_batching()) {
+        std::cout << "Teste 1: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 1: FALHOU" << std::endl;
+        failures ++;
+    }
+
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 2: Recuo exponencial e confirmação" << std::endl;
+    if (test_backoff_and_confirm()) {
+        std::cout << "Teste 2: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 2: FALHOU" << std::endl;
+        failures ++;
+    }
+
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 3: Desistência após MAX_ATTEMPTS" << std::endl;
+    if (test_give_up()) {
+        std::cout << "Teste 3: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 3: FALHOU" << std::endl;
+        failures ++;
+    }
+
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 4: Entrada de centenas de veículos" << std::endl;
+    if (test_bounded_onboarding()) {
+        std::cout << "Teste 4: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 4: FALHOU" << std::endl;
+        failures ++;
+    }
+
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 5: Índice sob entradas e confirmações" << std::endl;
+    if (test_index_churn()) {
+        std::cout << "Teste 5: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 5: FALHOU" << std::endl;
+        failures ++;
+    }
+
+    std::cout << "----------------------------------------" << std::endl;
+
+    if (failures == 0) {
+        std::cout << "TODOS OS TESTES PASSARAM!" << std::endl;
+        return 0;
+    } else {
+        std::cout << failures << " TESTE(S) FALHARAM!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,80 @@
+#include <iostream>
+#include <cassert>
+#include <string>
+#include "../header/lru-cache/lru-cache.h"
+
+// Ordem de uso e remoção do menos recente
+bool test_eviction_order() {
+    LRU_Cache<int, std::string> cache(2);
+
+    cache.put(1, "um");
+    cache.put(2, "dois");
+    assert(cache.get(1) && *cache.get(1) == "um");
+
+    // 2 é o menos usado agora
+    cache.put(3, "tres");
+    assert(cache.size() == 2);
+    assert(cache.get(2) == nullptr);
+    assert(cache.get(1) && cache.get(3));
+
+    // Atualizar uma chave existente não cresce o cache
+    cache.put(3, "TRES");
+    assert(cache.size() == 2);
+    assert(*cache.get(3) == "TRES");
+    return true;
+}
+
+// Nós removidos voltam ao pool e são reutilizados
+bool test_pool_reuse() {
+    LRU_Cache<int, int> cache(4);
+
+    for (int round = 0; round < 1000; round++) {
+        for (int i = 0; i < 4; i++) cache.put(round * 4 + i, i);
+        if (cache.size() != 4) return false;
+        cache.erase(round * 4);
+        cache.erase(round * 4 + 1);
+        if (cache.size() != 2) return false;
+        if (cache.get(round * 4) != nullptr) return false;
+        if (!cache.get(round * 4 + 3) || *cache.get(round * 4 + 3) != 3) return false;
+    }
+
+    // Apagar uma chave ausente não altera nada
+    cache.erase(-1);
+    return cache.size() == 2;
+}
+
+int main() {
+    int failures = 0;
+
+    std::cout << "Iniciando testes para LRU_Cache..." << std::endl;
+
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 1: Ordem de remoção" << std::endl;
+    if (test_eviction_order()) {
+        std::cout << "Teste 1: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 1: FALHOU" << std::endl;
+        failures ++;
+    }
+
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 2: Reutilização do pool de nós" << std::endl;
+    if (test_pool_reuse()) {
+        std::cout << "Teste 2: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 2: FALHOU" << std::endl;
+        failures ++;
+    }
+
+    std::cout << "----------------------------------------" << std::endl;
+
+    if (failures == 0) {
+        std::cout << "TODOS OS TESTES PASSARAM!" << std::endl;
+        return 0;
+    } else {
+        std::cout << failures << " TESTE(S) FALHARAM!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,104 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <memory>
+#include <algorithm>
+
+#include "../header/mac_algorithm.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAS_TSC 1
+#else
+#define HAS_TSC 0
+#endif
+
+const int ITERATIONS = 5000;
+const int REPETITIONS = 5;
+const size_t FRAME_SIZES[] = {64, 256, 1500};
+
+// Cycle counter, or nanoseconds where there is no TSC
+static inline uint64_t ticks() {
+#if HAS_TSC
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+int main() {
+    std::vector<unsigned char> frame(1500);
+    for (size_t i = 0; i < frame.size(); i++) frame[i] = static_cast<unsigned char>(i * 13 + 7);
+
+    const MACAlgorithm::Type types[] = {MACAlgorithm::XOR_FOLD, MACAlgorithm::SIPHASH_2_4, MACAlgorithm::NH_UNIVERSAL};
+    const MACAlgorithm::Implementation implementations[] = {MACAlgorithm::SCALAR, MACAlgorithm::SSE2, MACAlgorithm::AVX2};
+    Ethernet::MAC_KEY key = {{0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88}};
+
+    std::cout << (HAS_TSC ? "Unit: TSC cycles" : "Unit: nanoseconds") << " (best of " << REPETITIONS << " runs)" << std::endl;
+
+    for (MACAlgorithm::Type type : types) {
+        for (MACAlgorithm::Implementation implementation : implementations) {
+            std::unique_ptr<MACAlgorithm> algorithm(MACAlgorithm::create(type));
+            // Algorithms without vector kernels are measured once
+            if (!algorithm->use(implementation)) continue;
+            algorithm->set_key(key);
+
+            for (size_t size : FRAME_SIZES) {
+                volatile uint32_t sink = 0;
+                uint64_t best = UINT64_MAX;
+
+                for (int r = 0; r < REPETITIONS; r++) {
+                    uint64_t start = ticks();
+                    for (int i = 0; i < ITERATIONS; i++) {
+                        sink = sink ^ algorithm->compute(frame.data(), size);
+                    }
+                    best = std::min(best, ticks() - start);
+                }
+
+                double per_frame = static_cast<double>(best) / ITERATIONS;
+                std::cout << std::setw(13) << MACAlgorithm::type_name(type)
+                          << " | " << std::setw(6) << MACAlgorithm::implementation_name(implementation)
+                          << " | frame " << std::setw(4) << size << " B"
+                          << " | " << std::fixed << std::setprecision(1) << std::setw(8) << per_frame << " /frame"
+                          << " | " << std::setprecision(2) << std::setw(6) << per_frame / size << " /byte" << std::endl;
+            }
+        }
+    }
+
+    // Bursts of frames verified together, as the NIC does
+    const size_t BURST = 16;
+    for (MACAlgorithm::Type type : types) {
+        std::unique_ptr<MACAlgorithm> algorithm(MACAlgorithm::create(type));
+        algorithm->set_key(key);
+
+        for (size_t size : FRAME_SIZES) {
+            const unsigned char* data[BURST];
+            size_t lengths[BURST];
+            uint32_t tags[BURST];
+            for (size_t i = 0; i < BURST; i++) {
+                data[i] = frame.data();
+                lengths[i] = size;
+            }
+
+            uint64_t best = UINT64_MAX;
+            for (int r = 0; r < REPETITIONS; r++) {
+                uint64_t start = ticks();
+                for (int i = 0; i < ITERATIONS / static_cast<int>(BURST); i++) {
+                    algorithm->compute_batch(data, lengths, tags, BURST);
+                }
+                best = std::min(best, ticks() - start);
+            }
+
+            double per_frame = static_cast<double>(best) / ((ITERATIONS / BURST) * BURST);
+            std::cout << std::setw(13) << MACAlgorithm::type_name(type)
+                      << " | burst" << std::setw(2) << BURST
+                      << " | frame " << std::setw(4) << size << " B"
+                      << " | " << std::fixed << std::setprecision(1) << std::setw(8) << per_frame << " /frame"
+                      << " | " << std::setprecision(2) << std::setw(6) << per_frame / size << " /byte" << std::endl;
+        }
+    }
+
+    return 0;
+}
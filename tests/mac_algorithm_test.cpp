@@ -0,0 +1,189 @@
+#include "../header/mac_algorithm.h"
+#include <iostream>
+#include <vector>
+#include <random>
+#include <memory>
+
+// Vetores de referência do artigo do SipHash: chave 00..0f, mensagem 00..(n-1)
+bool test_siphash_vectors() {
+    const uint64_t key[2] = {0x0706050403020100ULL, 0x0f0e0d0c0b0a0908ULL};
+    const struct { size_t length; uint64_t expected; } vectors[] = {
+        {0, 0x726fdb47dd0e0e31ULL},
+        {1, 0x74f839c593dc67fdULL},
+        {2, 0x0d6c8009d9a94f5aULL},
+        {15, 0xa129ca6149be45e5ULL},
+    };
+
+    unsigned char message[64];
+    for (size_t i = 0; i < sizeof(message); i++) message[i] = static_cast<unsigned char>(i);
+
+    for (const auto& v : vectors) {
+        uint64_t result = SipHashMAC::siphash(key, message, v.length);
+        if (result != v.expected) {
+            std::cout << "  length " << v.length << ": " << std::hex << result << " != " << v.expected << std::dec << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// Todos os kernels do NH devem produzir a mesma tag
+bool test_nh_kernels_equivalence() {
+    const MACAlgorithm::Implementation implementations[] = {MACAlgorithm::SSE2, MACAlgorithm::AVX2};
+
+    std::mt19937 gen(3);
+    std::uniform_int_distribution<> byte(0, 255);
+    std::vector<unsigned char> buffer(3000 + 8);
+    for (auto& b : buffer) b = static_cast<unsigned char>(byte(gen));
+
+    Ethernet::MAC_KEY key = {{1, 2, 3, 4, 5, 6, 7, 8}};
+    NHUniversalMAC reference;
+    reference.use(MACAlgorithm::SCALAR);
+    reference.set_key(key);
+
+    for (MACAlgorithm::Implementation implementation : implementations) {
+        NHUniversalMAC nh;
+        if (!nh.use(implementation)) {
+            std::cout << "  " << MACAlgorithm::implementation_name(implementation) << " não suportado, ignorando" << std::endl;
+            continue;
+        }
+        nh.set_key(key);
+        for (size_t length = 0; length <= 3000; length += (length < 200 ? 1 : 61)) {
+            const unsigned char* data = buffer.data() + (length % 5);
+            if (nh.compute(data, length) != reference.compute(data, length)) {
+                std::cout << "  Divergência: " << MACAlgorithm::implementation_name(implementation) << " length=" << length << std::endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// O lote intercalado do SipHash deve reproduzir compute() para tamanhos distintos
+bool test_siphash_batch() {
+    const size_t FRAMES = 23;
+    std::vector<std::vector<unsigned char>> payloads(FRAMES);
+    const unsigned char* data[FRAMES];
+    size_t lengths[FRAMES];
+    uint32_t tags[FRAMES];
+
+    for (size_t i = 0; i < FRAMES; i++) {
+        // Os primeiros grupos passam pelo kernel AVX2 (>= 128 bytes), os demais pelo escalar
+        payloads[i].resize(i < 12 ? 128 + (i * 53) % 300 : (i * 53) % 300);
+        for (size_t j = 0; j < payloads[i].size(); j++) payloads[i][j] = static_cast<unsigned char>(i + j * 3);
+        data[i] = payloads[i].data();
+        lengths[i] = payloads[i].size();
+    }
+
+    Ethernet::MAC_KEY key = {{9, 8, 7, 6, 5, 4, 3, 2}};
+    const MACAlgorithm::Implementation implementations[] = {MACAlgorithm::SCALAR, MACAlgorithm::AVX2};
+    for (MACAlgorithm::Implementation implementation : implementations) {
+        SipHashMAC siphash;
+        if (!siphash.use(implementation)) continue;
+        siphash.set_key(key);
+        siphash.compute_batch(data, lengths, tags, FRAMES);
+        for (size_t i = 0; i < FRAMES; i++) {
+            if (tags[i] != siphash.compute(data[i], lengths[i])) {
+                std::cout << "  " << MACAlgorithm::implementation_name(implementation) << ": quadro " << i << " divergente" << std::endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// As tags dependem da chave e de cada bit da mensagem
+bool test_keyed_algorithms() {
+    const MACAlgorithm::Type types[] = {MACAlgorithm::SIPHASH_2_4, MACAlgorithm::NH_UNIVERSAL};
+
+    std::vector<unsigned char> frame(1500);
+    for (size_t i = 0; i < frame.size(); i++) frame[i] = static_cast<unsigned char>(i * 31);
+
+    Ethernet::MAC_KEY key_a = {{10, 20, 30, 40, 50, 60, 70, 80}};
+    Ethernet::MAC_KEY key_b = key_a;
+    key_b[7] ^= 1;
+
+    for (MACAlgorithm::Type type : types) {
+        std::unique_ptr<MACAlgorithm> a(MACAlgorithm::create(type));
+        std::unique_ptr<MACAlgorithm> b(MACAlgorithm::create(type));
+        a->set_key(key_a);
+        b->set_key(key_b);
+
+        uint32_t tag = a->compute(frame.data(), frame.size());
+        if (tag != a->compute(frame.data(), frame.size()) || tag == b->compute(frame.data(), frame.size())) {
+            std::cout << "  " << MACAlgorithm::type_name(type) << ": tag não depende da chave" << std::endl;
+            return false;
+        }
+
+        int collisions = 0;
+        for (size_t bit = 0; bit < 64; bit++) {
+            size_t position = (bit * 197) % frame.size();
+            frame[position] ^= static_cast<unsigned char>(1 << (bit % 8));
+            if (a->compute(frame.data(), frame.size()) == tag) collisions++;
+            frame[position] ^= static_cast<unsigned char>(1 << (bit % 8));
+        }
+
+        // Uma extensão com zeros não pode manter a tag
+        if (collisions > 0 || a->compute(frame.data(), frame.size() - 1) == tag) {
+            std::cout << "  " << MACAlgorithm::type_name(type) << ": " << collisions << " colisões" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    int failures = 0;
+
+    std::cout << "Iniciando testes para MACAlgorithm..." << std::endl;
+
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 1: Vetores de referência do SipHash-2-4" << std::endl;
+    if (test_siphash_vectors()) {
+        std::cout << "Teste 1: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 1: FALHOU" << std::endl;
+        failures ++;
+    }
+
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 2: Equivalência dos kernels do NH" << std::endl;
+    if (test_nh_kernels_equivalence()) {
+        std::cout << "Teste 2: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 2: FALHOU" << std::endl;
+        failures ++;
+    }
+
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 3: Dependência da chave e da mensagem" << std::endl;
+    if (test_keyed_algorithms()) {
+        std::cout << "Teste 3: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 3: FALHOU" << std::endl;
+        failures ++;
+    }
+
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 4: Lote intercalado do SipHash" << std::endl;
+    if (test_siphash_batch()) {
+        std::cout << "Teste 4: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 4: FALHOU" << std::endl;
+        failures ++;
+    }
+
+    std::cout << "----------------------------------------" << std::endl;
+
+    if (failures == 0) {
+        std::cout << "TODOS OS TESTES PASSARAM!" << std::endl;
+        return 0;
+    } else {
+        std::cout << failures << " TESTE(S) FALHARAM!" << std::endl;
+        return 1;
+    }
+}
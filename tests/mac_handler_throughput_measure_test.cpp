@@ -0,0 +1,83 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <random>
+
+#include "../header/mac_handler.h"
+
+const int ITERATIONS = 20000;
+const size_t FRAME_SIZES[] = {64, 256, 1500};
+
+// Previous byte-at-a-time generate_mac, kept as the baseline
+uint32_t reference_mac(const unsigned char* data, size_t data_length, const Ethernet::MAC_KEY& key, size_t mac_byte_size) {
+    std::vector<unsigned char> mac_buffer(mac_byte_size, 0);
+    for (size_t i = 0; i < data_length; ++i) {
+        mac_buffer[i % mac_byte_size] ^= data[i];
+    }
+    for (size_t i = 0; i < Ethernet::MAC_BYTE_SIZE; ++i) {
+        mac_buffer[i % mac_byte_size] ^= key[i];
+    }
+    uint32_t result_mac = mac_buffer[0];
+    for (size_t i = 1; i < mac_byte_size; ++i) {
+        result_mac = (result_mac << 8) | mac_buffer[i];
+    }
+    return result_mac;
+}
+
+template<typename Function>
+void measure(const char* name, size_t size, Function generate) {
+    // Keeps the result alive so the loop is not optimized away
+    volatile uint32_t sink = 0;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < ITERATIONS; i++) {
+        sink = sink ^ generate();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    double ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    double per_call = ns / ITERATIONS;
+    double throughput = (static_cast<double>(size) * ITERATIONS) / (ns / 1e9) / (1024.0 * 1024.0);
+
+    std::cout << std::setw(9) << name
+              << " | frame " << std::setw(4) << size << " B"
+              << " | " << std::fixed << std::setprecision(1) << std::setw(8) << per_call << " ns/frame"
+              << " | " << std::setw(8) << throughput << " MiB/s" << std::endl;
+}
+
+int main() {
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<> byte(0, 255);
+    std::vector<unsigned char> frame(1500);
+    for (auto& b : frame) b = static_cast<unsigned char>(byte(gen));
+
+    const MACAlgorithm::Implementation implementations[] = {MACAlgorithm::SCALAR, MACAlgorithm::SSE2, MACAlgorithm::AVX2};
+
+    std::cout << "Default implementation: " << MACAlgorithm::implementation_name(MACAlgorithm::best_implementation()) << std::endl;
+
+    MACHandler baseline;
+    baseline.create_mac_key();
+    for (size_t size : FRAME_SIZES) {
+        measure("reference", size, [&]() {
+            return reference_mac(frame.data(), size, *baseline.get_mac_key(), Ethernet::MAC_BYTE_SIZE);
+        });
+    }
+
+    for (MACAlgorithm::Implementation implementation : implementations) {
+        MACHandler mac_handler(Ethernet::MAC_BYTE_SIZE, MACAlgorithm::XOR_FOLD);
+        if (!mac_handler.use(implementation)) {
+            std::cout << std::setw(9) << MACAlgorithm::implementation_name(implementation) << ": not supported" << std::endl;
+            continue;
+        }
+        mac_handler.create_mac_key();
+
+        for (size_t size : FRAME_SIZES) {
+            measure(MACAlgorithm::implementation_name(implementation), size, [&]() {
+                return mac_handler.generate_mac(frame.data(), size);
+            });
+        }
+    }
+
+    return 0;
+}
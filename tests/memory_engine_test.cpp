@@ -0,0 +1,228 @@
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <vector>
+#include <cstring>
+
+#include "../header/memory_engine.h"
+#include "../header/types.h"
+#include "../header/message.h"
+
+// Cada quadro chega a todos os outros motores do barramento, nunca ao remetente
+bool test_broadcast() {
+    MemoryBus bus;
+    MemoryEngine a(bus), b(bus), c(bus);
+
+    Ethernet::Attributes attributes;
+    Ethernet::Address broadcast;
+    memcpy(broadcast, Ethernet::BROADCAST_MAC, ETH_ALEN);
+    const char payload[] = "quadro";
+    U64 sent_at = 0;
+    if (a.raw_send(broadcast, 0x8888, &attributes, payload, sizeof(payload), &sent_at) != sizeof(payload) || sent_at == 0) {
+        return false;
+    }
+
+    bool ok = bus.engines() == 3;
+    MemoryEngine* receivers[] = {&b, &c};
+    for (MemoryEngine* engine : receivers) {
+        Ethernet::Address src;
+        Ethernet::Protocol prot;
+        char data[64];
+        U64 timestamp = 0;
+        int size = engine->raw_receive(&src, &prot, &attributes, data, sizeof(data), &timestamp);
+        ok = ok && size == sizeof(payload) && memcmp(data, payload, size) == 0 && prot == 0x8888 &&
+             memcmp(src, a.address(), ETH_ALEN) == 0 && timestamp == sent_at;
+    }
+
+    Ethernet::Address src;
+    Ethernet::Protocol prot;
+    char data[64];
+    errno = 0;
+    ok = ok && a.raw_receive(&src, &prot, &attributes, data, sizeof(data)) == -1 && errno == EAGAIN;
+    ok = ok && memcmp(a.address(), b.address(), ETH_ALEN) != 0;
+    return ok;
+}
+
+// Fila cheia descarta, como o buffer de recepção do socket
+bool test_queue_full() {
+    MemoryBus bus;
+    MemoryEngine sender(bus), receiver(bus);
+    sem_t sem;
+    sem_init(&sem, 0, 0);
+    receiver.notify(&sem);
+
+    Ethernet::Attributes attributes;
+    Ethernet::Address broadcast;
+    memcpy(broadcast, Ethernet::BROADCAST_MAC, ETH_ALEN);
+    int value = 0;
+    for (unsigned int i = 0; i < MemoryEngine::QUEUE_FRAMES + 5; i++) {
+        sender.raw_send(broadcast, 0x8888, &attributes, &value, sizeof(value));
+    }
+
+    int posts = 0;
+    sem_getvalue(&sem, &posts);
+    bool ok = receiver.dropped() == 5 && posts == static_cast<int>(MemoryEngine::QUEUE_FRAMES);
+
+    unsigned int received = 0;
+    Ethernet::Address src;
+    Ethernet::Protocol prot;
+    while (receiver.raw_receive(&src, &prot, &attributes, &value, sizeof(value)) > 0) {
+        received++;
+    }
+    receiver.notify(nullptr);
+    sem_destroy(&sem);
+    return ok && received == MemoryEngine::QUEUE_FRAMES;
+}
+
+// Depois de notify(nullptr) o semáforo antigo nunca mais é postado e pode ser destruído
+bool test_notify_stop() {
+    MemoryBus bus;
+    MemoryEngine sender(bus), receiver(bus);
+    std::atomic<bool> running(true);
+
+    std::thread sending([&]() {
+        Ethernet::Attributes attributes;
+        Ethernet::Address broadcast;
+        memcpy(broadcast, Ethernet::BROADCAST_MAC, ETH_ALEN);
+        int value = 0;
+        while (running.load()) {
+            sender.raw_send(broadcast, 0x8888, &attributes, &value, sizeof(value));
+        }
+    });
+
+    bool ok = true;
+    for (int round = 0; round < 200 && ok; round++) {
+        sem_t* sem = new sem_t;
+        sem_init(sem, 0, 0);
+        receiver.notify(sem);
+
+        Ethernet::Attributes attributes;
+        Ethernet::Address src;
+        Ethernet::Protocol prot;
+        int value;
+        while (receiver.raw_receive(&src, &prot, &attributes, &value, sizeof(value)) > 0) {
+        }
+        std::this_thread::yield();
+        receiver.notify(nullptr);
+
+        int before = 0, after = 0;
+        sem_getvalue(sem, &before);
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        sem_getvalue(sem, &after);
+        ok = before == after;
+        sem_destroy(sem);
+        delete sem;
+    }
+    running = false;
+    sending.join();
+    return ok;
+}
+
+// Uma RSU e dois veículos no mesmo processo: as chaves MAC chegam pelo beacon
+// e uma mensagem autenticada de um veículo chega ao outro
+bool test_agents_in_process() {
+    NetworkEngine::use(NetworkEngine::MEMORY);
+
+    std::vector<Ethernet::MAC_KEY> keys(Traits<void>::NUM_RSU);
+    for (unsigned int i = 0; i < keys.size(); i++) {
+        for (size_t j = 0; j < Ethernet::MAC_BYTE_SIZE; j++) {
+            keys[i][j] = static_cast<unsigned char>(i * 31 + j);
+        }
+    }
+
+    EthernetNIC* rsu = new EthernetNIC("memory-test-rsu", 1);
+    rsu->create_mac_key_data(keys);
+    rsu->set_packet_origin(Ethernet::Attributes::PacketOrigin::RSU);
+    EthernetNIC* first = new EthernetNIC("memory-test-vehicle-1", 1);
+    EthernetNIC* second = new EthernetNIC("memory-test-vehicle-2", 1);
+    EthernetProtocol* first_protocol = new EthernetProtocol(first);
+    EthernetProtocol* second_protocol = new EthernetProtocol(second);
+
+    EthernetCommunicator* sender = new EthernetCommunicator(first_protocol, EthernetProtocol::Address(first->address(), 1));
+    EthernetCommunicator* receiver = new EthernetCommunicator(second_protocol, EthernetProtocol::Address(second->address(), 1));
+
+    std::atomic<bool> received(false);
+    std::thread reader([&]() {
+        Message message;
+        unsigned int id;
+        if (receiver->receive(&message, id) && message.get_type() == Message::INTEREST) {
+            received = true;
+        }
+    });
+
+    Message message;
+    Message::ResponseMessage payload;
+    message.set_payload(payload);
+    message.set_type(Message::INTEREST);
+    EthernetProtocol::Address from(first->address(), 1);
+    EthernetProtocol::Address to(EthernetProtocol::Address::BROADCAST_MAC, 0);
+
+    // Sem chaves os quadros do veículo são descartados; o beacon as entrega
+    rsu->send_sync_beacon();
+    for (int attempt = 0; attempt < 200 && !received; attempt++) {
+        sender->send(&message, from, to);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    receiver->stop();
+    reader.join();
+
+    delete sender;
+    delete receiver;
+    delete first_protocol;
+    delete second_protocol;
+    delete first;
+    delete second;
+    delete rsu;
+    NetworkEngine::use(NetworkEngine::RAW_SOCKET);
+    return received && MemoryBus::shared().engines() == 0;
+}
+
+int main() {
+    int failures = 0;
+
+    std::cout << "Teste 1: Difusão no barramento em memória" << std::endl;
+    if (test_broadcast()) {
+        std::cout << "Teste 1: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 1: FALHOU" << std::endl;
+        failures++;
+    }
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 2: Fila de recepção cheia" << std::endl;
+    if (test_queue_full()) {
+        std::cout << "Teste 2: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 2: FALHOU" << std::endl;
+        failures++;
+    }
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 3: RSU e veículos no mesmo processo" << std::endl;
+    if (test_agents_in_process()) {
+        std::cout << "Teste 3: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 3: FALHOU" << std::endl;
+        failures++;
+    }
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 4: Parada da notificação" << std::endl;
+    if (test_notify_stop()) {
+        std::cout << "Teste 4: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 4: FALHOU" << std::endl;
+        failures++;
+    }
+    std::cout << "----------------------------------------" << std::endl;
+
+    if (failures == 0) {
+        std::cout << "TODOS OS TESTES PASSARAM!" << std::endl;
+        return 0;
+    } else {
+        std::cout << failures << " TESTE(S) FALHARAM!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,226 @@
+#include <iostream>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <sstream>
+
+#include "../header/period_thread.h"
+
+// Modo TIMER: roda no período pedido e registra a latência de cada ativação
+bool test_timer_mode() {
+    std::atomic<int> runs(0);
+    PeriodicThread thread([&]() { runs++; }, 2000, 400, PeriodicThread::TIMER);
+    thread.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    thread.stop();
+
+    PeriodicThread::Stats stats = thread.stats();
+    unsigned long histogram = 0;
+    for (unsigned int i = 0; i < LatencyHistogram::BUCKETS; i++) {
+        histogram += stats.jitter.buckets[i];
+    }
+
+    std::cout << "  ativações " << stats.jitter.count << " | latência média " << stats.jitter.mean_us
+              << " us | máxima " << stats.jitter.max_us << " us | pulados " << stats.skipped << std::endl;
+
+    return stats.mode == PeriodicThread::TIMER && runs.load() >= 25 && runs.load() <= 55 &&
+           stats.jitter.count == static_cast<unsigned long>(runs.load()) && histogram == stats.jitter.count &&
+           stats.execution.count == stats.jitter.count;
+}
+
+// Tarefa mais longa que o período: os períodos perdidos são pulados, não acumulados
+bool test_timer_overrun() {
+    std::atomic<int> runs(0);
+    PeriodicThread thread([&]() {
+        runs++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }, 1000, 400, PeriodicThread::TIMER);
+    thread.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    thread.stop();
+
+    PeriodicThread::Stats stats = thread.stats();
+    return runs.load() <= 15 && stats.skipped > 0 && stats.deadline_misses > 0 &&
+           stats.budget_overruns == stats.execution.count && stats.execution.max_us >= 5000;
+}
+
+// update() também vale no modo TIMER
+bool test_timer_update() {
+    std::atomic<int> runs(0);
+    PeriodicThread thread([&]() { runs++; }, 20000, 400, PeriodicThread::TIMER);
+    thread.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    int slow = runs.load();
+    thread.update(1000);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    thread.stop();
+    return slow <= 4 && runs.load() - slow >= 15;
+}
+
+// AUTO: usa SCHED_DEADLINE quando disponível, senão cai para o temporizador; a tarefa roda nos dois casos
+bool test_auto_mode() {
+    std::atomic<int> runs(0);
+    PeriodicThread thread([&]() { runs++; }, 5000, 500, PeriodicThread::AUTO);
+    thread.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    thread.stop();
+
+    PeriodicThread::Stats stats = thread.stats();
+    std::cout << "  modo " << (stats.mode == PeriodicThread::DEADLINE ? "DEADLINE" : "TIMER")
+              << " | ativações " << stats.jitter.count << " | latência média " << stats.jitter.mean_us << " us" << std::endl;
+    return stats.mode != PeriodicThread::AUTO && runs.load() >= 5;
+}
+
+// Histograma: percentis pelo limite superior do bucket
+bool test_histogram() {
+    LatencyHistogram histogram;
+    for (int i = 0; i < 90; i++) histogram.record(3000);     // 3 us -> [2, 4)
+    for (int i = 0; i < 10; i++) histogram.record(100000);   // 100 us -> [64, 128)
+
+    LatencyHistogram::Snapshot snapshot = histogram.snapshot();
+    bool ok = snapshot.count == 100 && snapshot.buckets[2] == 90 && snapshot.buckets[7] == 10 &&
+              snapshot.percentile_us(0.5) == 4 && snapshot.percentile_us(0.95) == 100 &&
+              snapshot.max_us == 100 && snapshot.mean_us > 12.6 && snapshot.mean_us < 12.8;
+    histogram.reset();
+    return ok && histogram.snapshot().count == 0;
+}
+
+// Estatísticas com rótulo do dono, listadas por dump_all enquanto a thread existe
+bool test_labeled_dump() {
+    PeriodicThread thread([]() {}, 1000, 400, PeriodicThread::TIMER);
+    thread.set_label("componente de teste");
+    thread.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    thread.stop();
+
+    std::ostringstream out;
+    PeriodicThread::dump_all(out);
+    std::cout << "  " << out.str();
+    return out.str().find("componente de teste [TIMER 1000/400 us]") != std::string::npos &&
+           thread.stats().budget_overruns == 0;
+}
+
+static void busy_for(std::chrono::microseconds duration) {
+    auto start = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - start < duration) {}
+}
+
+// Orçamento adaptativo: encolhe até o tempo de CPU medido e cresce quando a tarefa pesa mais
+bool test_adaptive_runtime() {
+    std::atomic<int> work_us(200);
+    PeriodicThread thread([&]() { busy_for(std::chrono::microseconds(work_us.load())); }, 2000, 1500, PeriodicThread::TIMER);
+    thread.set_adaptive_runtime(true);
+    thread.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    PeriodicThread::Stats light = thread.stats();
+
+    work_us.store(600);
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    thread.update(4000);
+    PeriodicThread::Stats heavy = thread.stats();
+    thread.stop();
+
+    std::cout << "  orçamento leve " << light.runtime_us << " us | pesado " << heavy.runtime_us
+              << " us | mudanças " << heavy.adaptations << std::endl;
+    return light.adaptive && light.adaptations >= 1 && light.runtime_us >= 200 && light.runtime_us < 1000 &&
+           heavy.runtime_us >= 600 && heavy.runtime_us <= 1600 && heavy.period_us == 4000;
+}
+
+// Orçamento fixo: update() continua usando metade do período
+bool test_fixed_runtime() {
+    PeriodicThread thread([]() {}, 2000, 400, PeriodicThread::TIMER);
+    thread.set_adaptive_runtime(false);
+    thread.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(80));
+    thread.update(3000);
+    PeriodicThread::Stats stats = thread.stats();
+    thread.stop();
+    return !stats.adaptive && stats.adaptations == 0 && stats.runtime_us == 1500;
+}
+
+int main() {
+    int failures = 0;
+
+    std::cout << "Iniciando testes para PeriodicThread..." << std::endl;
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 1: Modo temporizador" << std::endl;
+    if (test_timer_mode()) {
+        std::cout << "Teste 1: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 1: FALHOU" << std::endl;
+        failures++;
+    }
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 2: Períodos perdidos" << std::endl;
+    if (test_timer_overrun()) {
+        std::cout << "Teste 2: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 2: FALHOU" << std::endl;
+        failures++;
+    }
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 3: Atualização do período" << std::endl;
+    if (test_timer_update()) {
+        std::cout << "Teste 3: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 3: FALHOU" << std::endl;
+        failures++;
+    }
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 4: Modo automático" << std::endl;
+    if (test_auto_mode()) {
+        std::cout << "Teste 4: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 4: FALHOU" << std::endl;
+        failures++;
+    }
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 5: Histograma de latência" << std::endl;
+    if (test_histogram()) {
+        std::cout << "Teste 5: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 5: FALHOU" << std::endl;
+        failures++;
+    }
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 6: Estatísticas por dono" << std::endl;
+    if (test_labeled_dump()) {
+        std::cout << "Teste 6: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 6: FALHOU" << std::endl;
+        failures++;
+    }
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 7: Orçamento de execução adaptativo" << std::endl;
+    if (test_adaptive_runtime()) {
+        std::cout << "Teste 7: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 7: FALHOU" << std::endl;
+        failures++;
+    }
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 8: Orçamento de execução fixo" << std::endl;
+    if (test_fixed_runtime()) {
+        std::cout << "Teste 8: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 8: FALHOU" << std::endl;
+        failures++;
+    }
+    std::cout << "----------------------------------------" << std::endl;
+
+    if (failures == 0) {
+        std::cout << "TODOS OS TESTES PASSARAM!" << std::endl;
+        return 0;
+    } else {
+        std::cout << failures << " TESTE(S) FALHARAM!" << std::endl;
+        return 1;
+    }
+}
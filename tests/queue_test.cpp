@@ -1,4 +1,8 @@
 #include <iostream>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <chrono>
 #include "../header/queue.h"  // Supondo que a classe Queue esteja definida neste arquivo
 
 bool test_queue_add() {
@@ -42,6 +46,186 @@ bool test_queue_order() {
     return true;
 }
 
+// Variantes sem lock: mesmo comportamento básico da Queue
+template <typename Q>
+bool test_lock_free_basic() {
+    Q q; // capacidade 4
+
+    int values[6] = {1, 2, 3, 4, 5, 6};
+    for (int i = 0; i < 4; ++i) {
+        if (!q.add(&values[i])) return false;
+    }
+    if (q.add(&values[4])) return false; // cheia
+
+    // Dá a volta no anel várias vezes
+    for (int round = 0; round < 10; ++round) {
+        int* v = q.remove();
+        if (!v || *v != values[round % 6]) return false;
+        if (!q.add(&values[(round + 4) % 6])) return false;
+    }
+    for (int i = 10; i < 14; ++i) {
+        int* v = q.remove();
+        if (!v || *v != values[i % 6]) return false;
+    }
+    return q.remove() == nullptr;
+}
+
+template <typename Q>
+bool test_lock_free_batch() {
+    Q q; // capacidade 8
+
+    int values[12];
+    int* in[12];
+    for (int i = 0; i < 12; ++i) {
+        values[i] = i;
+        in[i] = &values[i];
+    }
+
+    // Só cabem 8: o lote é parcial
+    if (q.add_batch(in, 5) != 5 || q.add_batch(in + 5, 7) != 3) return false;
+
+    int* out[12];
+    if (q.remove_batch(out, 6) != 6) return false;
+    if (q.add_batch(in + 8, 4) != 4) return false;
+    size_t rest = q.remove_batch(out + 6, 12);
+    if (rest != 6 || q.remove_batch(out, 1) != 0) return false;
+
+    for (int i = 0; i < 12; ++i) {
+        if (*out[i] != i) return false;
+    }
+    return true;
+}
+
+// Um produtor e um consumidor: nada se perde e a ordem é mantida
+bool test_spsc_stress() {
+    const int ITEMS = 200000;
+    static SPSCQueue<int, 64> q;
+    std::vector<int> values(ITEMS);
+    for (int i = 0; i < ITEMS; ++i) values[i] = i;
+
+    bool ordered = true;
+    std::thread consumer([&]() {
+        int expected = 0;
+        int* batch[16];
+        while (expected < ITEMS) {
+            size_t n = q.remove_batch(batch, 16);
+            if (n == 0) std::this_thread::yield();
+            for (size_t i = 0; i < n; ++i) {
+                if (*batch[i] != expected++) ordered = false;
+            }
+        }
+    });
+
+    for (int i = 0; i < ITEMS; ++i) {
+        while (!q.add(&values[i])) std::this_thread::yield();
+    }
+    consumer.join();
+    return ordered && q.size() == 0;
+}
+
+// Vários produtores e consumidores, metade usando lotes: cada item sai exatamente uma vez
+bool test_mpmc_stress() {
+    const int PRODUCERS = 3;
+    const int CONSUMERS = 3;
+    const int ITEMS = 50000;
+    static MPMCQueue<int, 64> q;
+
+    std::vector<int> values(PRODUCERS * ITEMS);
+    for (size_t i = 0; i < values.size(); ++i) values[i] = i;
+    std::vector<std::atomic<int>> seen(values.size());
+    for (auto& s : seen) s.store(0);
+    std::atomic<int> consumed(0);
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < PRODUCERS; ++p) {
+        threads.push_back(std::thread([&, p]() {
+            int* base = &values[p * ITEMS];
+            int sent = 0;
+            while (sent < ITEMS) {
+                if (p % 2) {
+                    int* batch[8];
+                    int n = ITEMS - sent < 8 ? ITEMS - sent : 8;
+                    for (int i = 0; i < n; ++i) batch[i] = base + sent + i;
+                    size_t done = q.add_batch(batch, n);
+                    if (done == 0) std::this_thread::yield();
+                    sent += done;
+                } else if (q.add(base + sent)) {
+                    sent++;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        }));
+    }
+    for (int c = 0; c < CONSUMERS; ++c) {
+        threads.push_back(std::thread([&, c]() {
+            while (consumed.load() < PRODUCERS * ITEMS) {
+                int* batch[8];
+                size_t n;
+                if (c % 2) {
+                    n = q.remove_batch(batch, 8);
+                } else {
+                    batch[0] = q.remove();
+                    n = batch[0] ? 1 : 0;
+                }
+                if (n == 0) std::this_thread::yield();
+                for (size_t i = 0; i < n; ++i) seen[*batch[i]]++;
+                consumed += n;
+            }
+        }));
+    }
+    for (auto& t : threads) t.join();
+
+    for (auto& s : seen) {
+        if (s.load() != 1) return false;
+    }
+    return q.remove() == nullptr;
+}
+
+// Lotes de BATCH itens; BATCH == 1 usa add/remove (a Queue com mutex não tem lotes)
+template <typename Q, size_t BATCH>
+struct Transfer {
+    static size_t push(Q& q, int** in, size_t n) { return q.add_batch(in, n < BATCH ? n : BATCH); }
+    static size_t pop(Q& q, int** out) { return q.remove_batch(out, BATCH); }
+};
+
+template <typename Q>
+struct Transfer<Q, 1> {
+    static size_t push(Q& q, int** in, size_t) { return q.add(in[0]) ? 1 : 0; }
+    static size_t pop(Q& q, int** out) { return (out[0] = q.remove()) ? 1 : 0; }
+};
+
+// Benchmark: vazão com um produtor e um consumidor
+template <typename Q, size_t BATCH>
+void benchmark(const char* name) {
+    const size_t ITEMS = 1000000;
+    static Q q;
+    static int value;
+
+    auto start = std::chrono::steady_clock::now();
+    std::thread consumer([&]() {
+        int* out[BATCH];
+        size_t received = 0;
+        while (received < ITEMS) {
+            size_t n = Transfer<Q, BATCH>::pop(q, out);
+            if (n == 0) std::this_thread::yield();
+            received += n;
+        }
+    });
+    int* in[BATCH];
+    for (size_t i = 0; i < BATCH; ++i) in[i] = &value;
+    size_t sent = 0;
+    while (sent < ITEMS) {
+        size_t n = Transfer<Q, BATCH>::push(q, in, ITEMS - sent);
+        if (n == 0) std::this_thread::yield();
+        sent += n;
+    }
+    consumer.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << name << ": 1P/1C " << ITEMS / seconds / 1e6 << " Mops/s" << std::endl;
+}
+
 int main() {
     std::cout << "Iniciando testes para Queue..." << std::endl;
     std::cout << "----------------------------------------" << std::endl;
@@ -75,6 +259,50 @@ int main() {
     }
     std::cout << "----------------------------------------" << std::endl;
 
+    std::cout << "Teste 4: SPSCQueue e MPMCQueue básicas" << std::endl;
+    if (test_lock_free_basic<SPSCQueue<int, 4>>() && test_lock_free_basic<MPMCQueue<int, 4>>()) {
+        std::cout << "Teste 4: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 4: FALHOU" << std::endl;
+        failures++;
+    }
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 5: Inserção e remoção em lote" << std::endl;
+    if (test_lock_free_batch<SPSCQueue<int, 8>>() && test_lock_free_batch<MPMCQueue<int, 8>>()) {
+        std::cout << "Teste 5: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 5: FALHOU" << std::endl;
+        failures++;
+    }
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 6: SPSC com duas threads" << std::endl;
+    if (test_spsc_stress()) {
+        std::cout << "Teste 6: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 6: FALHOU" << std::endl;
+        failures++;
+    }
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 7: MPMC com produtores e consumidores" << std::endl;
+    if (test_mpmc_stress()) {
+        std::cout << "Teste 7: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 7: FALHOU" << std::endl;
+        failures++;
+    }
+    std::cout << "----------------------------------------" << std::endl;
+
+    benchmark<Queue<int, 1024>, 1>("mutex         ");
+    benchmark<SPSCQueue<int, 1024>, 1>("SPSC          ");
+    benchmark<SPSCQueue<int, 1024>, 32>("SPSC lote 32  ");
+    benchmark<MPMCQueue<int, 1024>, 1>("MPMC          ");
+    benchmark<MPMCQueue<int, 1024>, 32>("MPMC lote 32  ");
+
+    std::cout << "----------------------------------------" << std::endl;
+
     if (failures == 0) {
         std::cout << "TODOS OS TESTES PASSARAM!" << std::endl;
         return 0;
@@ -13,6 +13,8 @@ public:
     using RawSocketEngine::raw_send;
     using RawSocketEngine::raw_receive;
     using RawSocketEngine::get_interface;
+    using RawSocketEngine::enable_tx_timestamps;
+    using RawSocketEngine::timestamping;
     
     int get_socket() const { return _socket; }
     int get_ifindex() const { return _ifindex; }
@@ -119,6 +121,99 @@ bool test_raw_socket_send_receive() {
     }
 }
 
+U64 now_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// Carimbos do kernel na recepção e no envio, no mesmo relógio do TimeKeeper
+bool test_kernel_timestamps() {
+    try {
+        TestableRawSocketEngine sender;
+        TestableRawSocketEngine receiver;
+
+        if (sender.timestamping() == RawSocketEngine::TIMESTAMPING_NONE) {
+            std::cout << "SO_TIMESTAMPING indisponível, carimbos em espaço de usuário" << std::endl;
+            return true;
+        }
+        if (!sender.enable_tx_timestamps()) {
+            return false;
+        }
+
+        Ethernet::Address broadcast = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+        const char* test_data = "TESTE_TIMESTAMP";
+        Ethernet::Attributes attributes;
+
+        U64 before = now_us();
+        U64 tx_timestamp = 0;
+        sender.raw_send(broadcast, 0x8888, &attributes, test_data, strlen(test_data), &tx_timestamp);
+        std::cout << "TX: " << (tx_timestamp ? static_cast<long long>(tx_timestamp - before) : -1) << " us após o envio" << std::endl;
+
+        bool ok = tx_timestamp == 0 || (tx_timestamp >= before && tx_timestamp - before < 1000000);
+
+        Ethernet::Address src;
+        Ethernet::Protocol prot;
+        char buffer[1024];
+        U64 start = now_us();
+        while (now_us() - start < 5000000) {
+            U64 rx_timestamp = 0;
+            int bytes_received = receiver.raw_receive(&src, &prot, &attributes, buffer, sizeof(buffer), &rx_timestamp);
+            if (bytes_received > 0 && prot == 0x8888 && std::string(buffer, bytes_received) == test_data) {
+                U64 after = now_us();
+                std::cout << "RX: " << static_cast<long long>(after - rx_timestamp) << " us antes da leitura" << std::endl;
+                return ok && rx_timestamp >= before && rx_timestamp <= after;
+            }
+        }
+        return false;
+    } catch (const std::exception& e) {
+        std::cerr << "Exceção durante teste de carimbos: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+// Cada envio recebe o carimbo do seu próprio quadro, mesmo com envios sem carimbo no meio
+bool test_tx_timestamp_matching() {
+    try {
+        TestableRawSocketEngine sender;
+        if (sender.timestamping() == RawSocketEngine::TIMESTAMPING_NONE) {
+            std::cout << "SO_TIMESTAMPING indisponível, carimbos em espaço de usuário" << std::endl;
+            return true;
+        }
+        if (!sender.enable_tx_timestamps()) {
+            return false;
+        }
+
+        Ethernet::Address broadcast = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+        const char* test_data = "TESTE_ID";
+        Ethernet::Attributes attributes;
+
+        int stamped = 0;
+        bool ok = true;
+        U64 previous = 0;
+        for (int i = 0; i < 100; i++) {
+            if (i % 3 == 0) {
+                // Consome um id sem ler o carimbo
+                ok = ok && sender.raw_send(broadcast, 0x8888, &attributes, test_data, strlen(test_data)) >= 0;
+            }
+            U64 before = now_us();
+            U64 tx_timestamp = 0;
+            ok = ok && sender.raw_send(broadcast, 0x8888, &attributes, test_data, strlen(test_data), &tx_timestamp) >= 0;
+            U64 after = now_us();
+            if (tx_timestamp) {
+                // Carimbo de outro envio cairia fora da janela deste
+                ok = ok && tx_timestamp >= before && tx_timestamp <= after && tx_timestamp >= previous;
+                previous = tx_timestamp;
+                stamped++;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(500));
+        }
+        std::cout << stamped << " de 100 envios com carimbo" << std::endl;
+        return ok;
+    } catch (const std::exception& e) {
+        std::cerr << "Exceção durante teste de carimbos: " << e.what() << std::endl;
+        return false;
+    }
+}
+
 int main() {
     std::cout << "Iniciando testes para RawSocketEngine..." << std::endl;
     std::cout << "----------------------------------------" << std::endl;
@@ -143,6 +238,24 @@ int main() {
     }
     std::cout << "----------------------------------------" << std::endl;
     
+    std::cout << "Teste 3: Carimbos de tempo do kernel" << std::endl;
+    if (test_kernel_timestamps()) {
+        std::cout << "Teste 3: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 3: FALHOU" << std::endl;
+        failures++;
+    }
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 4: Carimbo de envio associado ao quadro" << std::endl;
+    if (test_tx_timestamp_matching()) {
+        std::cout << "Teste 4: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 4: FALHOU" << std::endl;
+        failures++;
+    }
+    std::cout << "----------------------------------------" << std::endl;
+    
     if (failures == 0) {
         std::cout << "TODOS OS TESTES PASSARAM!" << std::endl;
         return 0;
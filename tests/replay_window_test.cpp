@@ -0,0 +1,100 @@
+#include <iostream>
+#include <cassert>
+#include "../header/replay_window.h"
+
+const Ethernet::Address SENDER_A = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01};
+const Ethernet::Address SENDER_B = {0x02, 0x00, 0x00, 0x00, 0x00, 0x02};
+const Ethernet::Address SENDER_C = {0x02, 0x00, 0x00, 0x00, 0x00, 0x03};
+
+// Sequências novas são aceitas e repetidas são descartadas
+bool test_duplicates() {
+    ReplayWindow<4> window;
+
+    for (uint32_t seq = 0; seq < 100; seq++) {
+        assert(window.accept(SENDER_A, seq));
+    }
+    assert(window.check(SENDER_A, 99) == ReplayWindow<4>::DUPLICATE);
+    assert(window.check(SENDER_A, 50) == ReplayWindow<4>::DUPLICATE);
+    assert(window.duplicates() == 2);
+
+    // Outro remetente tem sua própria janela
+    assert(window.accept(SENDER_B, 99));
+    return true;
+}
+
+// Fora de ordem dentro da janela é aceito uma vez; atrás da janela é descartado
+bool test_reordering() {
+    ReplayWindow<4> window;
+
+    assert(window.accept(SENDER_A, 10));
+    assert(window.accept(SENDER_A, 12));
+    assert(window.accept(SENDER_A, 11));
+    assert(window.check(SENDER_A, 11) == ReplayWindow<4>::DUPLICATE);
+
+    assert(window.accept(SENDER_A, 10 + 200));
+    assert(window.check(SENDER_A, 12) == ReplayWindow<4>::TOO_OLD);
+    assert(window.accept(SENDER_A, 210 - 63));
+    assert(window.check(SENDER_A, 210 - 64) == ReplayWindow<4>::TOO_OLD);
+    assert(window.too_old() == 2);
+    return true;
+}
+
+// O número de sequência pode dar a volta em 2^32
+bool test_wraparound() {
+    ReplayWindow<4> window;
+
+    assert(window.accept(SENDER_A, 0xfffffffe));
+    assert(window.accept(SENDER_A, 0xffffffff));
+    assert(window.accept(SENDER_A, 0));
+    assert(window.accept(SENDER_A, 1));
+    assert(window.check(SENDER_A, 0xffffffff) == ReplayWindow<4>::DUPLICATE);
+    return true;
+}
+
+// Com a tabela cheia o remetente visto há mais tempo é substituído
+bool test_eviction() {
+    ReplayWindow<2> window;
+
+    assert(window.accept(SENDER_A, 5));
+    assert(window.accept(SENDER_B, 5));
+    assert(window.check(SENDER_A, 5) == ReplayWindow<2>::DUPLICATE);
+
+    // B é o mais antigo agora
+    assert(window.accept(SENDER_C, 5));
+    assert(window.accept(SENDER_B, 5));
+    return true;
+}
+
+int main() {
+    int failures = 0;
+
+    std::cout << "Iniciando testes para ReplayWindow..." << std::endl;
+
+    const struct { const char* name; bool (*test)(); } tests[] = {
+        {"Duplicatas", test_duplicates},
+        {"Reordenação", test_reordering},
+        {"Volta do número de sequência", test_wraparound},
+        {"Substituição de remetentes", test_eviction},
+    };
+
+    for (size_t i = 0; i < sizeof(tests) / sizeof(tests[0]); i++) {
+        std::cout << "----------------------------------------" << std::endl;
+        std::cout << "Teste " << i + 1 << ": " << tests[i].name << std::endl;
+        if (tests[i].test()) {
+            std::cout << "Teste " << i + 1 << ": PASSOU" << std::endl;
+        } else {
+            std::cout << "Teste " << i + 1 << ": FALHOU" << std::endl;
+            failures ++;
+        }
+    }
+
+    std::cout << "----------------------------------------" << std::endl;
+
+    if (failures == 0) {
+        std::cout << "TODOS OS TESTES PASSARAM!" << std::endl;
+        return 0;
+    } else {
+        std::cout << failures << " TESTE(S) FALHARAM!" << std::endl;
+        return 1;
+    }
+}
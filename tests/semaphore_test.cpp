@@ -5,8 +5,35 @@
 #include <thread>
 #include <chrono>
 #include <atomic>
+#include <mutex>
+#include <condition_variable>
 #include "../header/semaphore.h"
 
+// Implementação anterior (mutex + condition_variable), referência para o benchmark
+class CondvarSemaphore {
+public:
+    CondvarSemaphore(int initial) : _count(initial) {}
+
+    void p() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _condition.wait(lock, [this] { return _count > 0; });
+        _count--;
+    }
+
+    void v() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _count++;
+        }
+        _condition.notify_one();
+    }
+
+private:
+    int _count;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+};
+
 // Função auxiliar para imprimir resultados de teste
 void test_result(const std::string& test_name, bool result) {
     std::cout << test_name << ": " << (result ? "PASSOU" : "FALHOU") << std::endl;
@@ -134,6 +161,97 @@ bool test_semaphore_multiple_threads() {
     return true;
 }
 
+// p com tempo limite: expira sem V e retorna assim que V chega
+bool test_semaphore_timed_p() {
+    Semaphore sem(0);
+
+    auto start = std::chrono::steady_clock::now();
+    bool acquired = sem.p(20000LL);
+    auto waited = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    if (acquired || waited < 20000) return false;
+
+    std::thread signaler([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        sem.v();
+    });
+    acquired = sem.p(5000000LL);
+    signaler.join();
+
+    sem.v();
+    return acquired && sem.p(0LL) && !sem.p(0LL) && sem.count() == 0;
+}
+
+// Produtores e consumidores: nenhuma unidade perdida nem duplicada
+bool test_semaphore_stress() {
+    const int PRODUCERS = 3;
+    const int CONSUMERS = 3;
+    const int ITEMS = 20000;
+    Semaphore sem(0);
+    std::atomic<int> consumed(0);
+
+    std::vector<std::thread> threads;
+    for (int c = 0; c < CONSUMERS; c++) {
+        threads.push_back(std::thread([&]() {
+            for (int i = 0; i < PRODUCERS * ITEMS / CONSUMERS; i++) {
+                sem.p();
+                consumed++;
+            }
+        }));
+    }
+    for (int p = 0; p < PRODUCERS; p++) {
+        threads.push_back(std::thread([&]() {
+            for (int i = 0; i < ITEMS; i++) sem.v();
+        }));
+    }
+    for (auto& t : threads) t.join();
+
+    return consumed == PRODUCERS * ITEMS && sem.count() == 0;
+}
+
+// Benchmark: custo sem disputa, ida e volta entre duas threads e vazão com disputa
+template <typename S>
+void benchmark(const char* name) {
+    const int UNCONTENDED = 1000000;
+    const int PING_PONG = 20000;
+    const int THROUGHPUT = 100000;
+
+    S sem(0);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < UNCONTENDED; i++) {
+        sem.v();
+        sem.p();
+    }
+    double uncontended = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / UNCONTENDED;
+
+    S ping(0), pong(0);
+    std::thread partner([&]() {
+        for (int i = 0; i < PING_PONG; i++) {
+            ping.p();
+            pong.v();
+        }
+    });
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < PING_PONG; i++) {
+        ping.v();
+        pong.p();
+    }
+    double round_trip = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / PING_PONG;
+    partner.join();
+
+    S items(0);
+    start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 2; t++) {
+        threads.push_back(std::thread([&]() { for (int i = 0; i < THROUGHPUT; i++) items.v(); }));
+        threads.push_back(std::thread([&]() { for (int i = 0; i < THROUGHPUT; i++) items.p(); }));
+    }
+    for (auto& t : threads) t.join();
+    double throughput = 2.0 * THROUGHPUT / std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << name << ": v+p sem disputa " << uncontended << " ns | ida e volta " << round_trip
+              << " us | 2P/2C " << throughput / 1e6 << " Mops/s" << std::endl;
+}
+
 int main() {
     int failures = 0;
     
@@ -201,6 +319,31 @@ int main() {
 
     std::cout << "----------------------------------------" << std::endl;
 
+    std::cout << "Teste 7: P com tempo limite" << std::endl;
+    if (test_semaphore_timed_p()) {
+        std::cout << "Teste 7: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 7: FALHOU" << std::endl;
+        failures ++;
+    }
+
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 8: Produtores e consumidores" << std::endl;
+    if (test_semaphore_stress()) {
+        std::cout << "Teste 8: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 8: FALHOU" << std::endl;
+        failures ++;
+    }
+
+    std::cout << "----------------------------------------" << std::endl;
+
+    benchmark<CondvarSemaphore>("mutex+condvar");
+    benchmark<Semaphore>("futex        ");
+
+    std::cout << "----------------------------------------" << std::endl;
+
     if (failures == 0) {
         std::cout << "TODOS OS TESTES PASSARAM!" << std::endl;
         return 0;
@@ -0,0 +1,218 @@
+#include <iostream>
+#include <vector>
+#include <string>
+
+#include "../header/simulator.h"
+#include "../header/channel_model.h"
+#include "../header/period_thread.h"
+#include "../header/types.h"
+#include "../header/agent/rsu.h"
+#include "../header/agent/simulated_vehicle.h"
+
+// Eventos em ordem de tempo; empates na ordem em que foram agendados
+bool test_event_order() {
+    Simulator::start(1, 1000);
+    std::string order;
+    Simulator::schedule(3000, [&]() { order += "c"; });
+    Simulator::schedule(2000, [&]() { order += "a"; });
+    Simulator::schedule(2000, [&]() { order += "b"; });
+    Simulator::Id cancelled = Simulator::schedule(2500, [&]() { order += "x"; });
+    // Um evento pode agendar outro no mesmo instante
+    Simulator::schedule(2500, [&]() { Simulator::schedule_in(0, [&]() { order += "d"; }); });
+
+    bool ok = Simulator::cancel(cancelled) && !Simulator::cancel(cancelled);
+    Simulator::run_until(2999);
+    ok = ok && order == "abd" && Simulator::now_us() == 2999 && Simulator::pending() == 1;
+    Simulator::run_until(10000);
+    ok = ok && order == "abdc" && Simulator::now_us() == 10000 && Simulator::events_run() == 5;
+    Simulator::stop();
+    return ok && !Simulator::active();
+}
+
+// A mesma semente reproduz a mesma sequência
+bool test_random() {
+    std::vector<uint64_t> first, second;
+    Simulator::start(42);
+    for (int i = 0; i < 100; i++) first.push_back(Simulator::random());
+    Simulator::start(42);
+    for (int i = 0; i < 100; i++) second.push_back(Simulator::random());
+    Simulator::start(43);
+    bool different = Simulator::random() != first[0];
+
+    bool in_range = true;
+    for (int i = 0; i < 1000; i++) {
+        long long value = Simulator::uniform(-5, 5);
+        in_range = in_range && value >= -5 && value <= 5;
+    }
+    Simulator::stop();
+    return first == second && different && in_range;
+}
+
+// Sem simulador ativo não há thread: as ativações são eventos em tempo virtual
+bool test_simulated_periodic() {
+    Simulator::start(1);
+    int activations = 0;
+    PeriodicThread thread([&]() { activations++; }, 100000);
+    thread.start();
+
+    Simulator::run_until(Simulator::start_us() + 1000000);
+    bool ok = activations == 11 && thread.stats().mode == PeriodicThread::SIMULATED;
+
+    thread.update(250000);
+    Simulator::run_until(Simulator::start_us() + 2000000);
+    ok = ok && activations == 15;
+
+    thread.stop();
+    Simulator::run_until(Simulator::start_us() + 3000000);
+    ok = ok && activations == 15 && Simulator::pending() == 0;
+    Simulator::stop();
+    return ok;
+}
+
+// O meio é compartilhado: quadros na fila esperam o anterior sair do ar
+bool test_channel_model() {
+    Simulator::start(5, 0);
+    ChannelModel channel;
+    ChannelModel::Link link = {100, 0, 0, 8000000};  // 1 byte por us
+    channel.set_link(1, link);
+
+    bool ok = channel.transmit(1, 1000, 0) == 1000 && channel.transmit(1, 500, 200) == 1500 &&
+              channel.transmit(1, 10, 5000) == 5010;
+    U64 at = 0;
+    ok = ok && channel.arrival(1, 1500, at) && at == 1600;
+    ok = ok && channel.statistics(1).frames == 3 && channel.statistics(1).queued_us == 800;
+
+    // Perda sempre e nunca
+    link.loss_ppm = 1000000;
+    channel.set_link(2, link);
+    ok = ok && !channel.arrival(2, 0, at) && channel.statistics(2).lost == 1;
+    Simulator::stop();
+    return ok;
+}
+
+struct Outcome {
+    unsigned long sent;
+    unsigned long received;
+    U64 clock;
+    unsigned long long events;
+};
+
+// Uma RSU e dois veículos por alguns segundos virtuais
+Outcome run_scenario(uint64_t seed) {
+    Simulator::start(seed);
+    NetworkEngine::use(NetworkEngine::MEMORY);
+    ChannelModel channel;
+    MemoryBus::shared().channel(&channel);
+
+    std::vector<Ethernet::MAC_KEY> keys(Traits<RSU>::NUM_RSU);
+    for (Ethernet::MAC_KEY& key : keys) {
+        for (size_t j = 0; j < Ethernet::MAC_BYTE_SIZE; j++) {
+            key[j] = static_cast<unsigned char>(Simulator::random());
+        }
+    }
+
+    EthernetNIC* rsu_nic = new EthernetNIC("simulator-test-rsu", 1);
+    EthernetProtocol* rsu_protocol = new EthernetProtocol(rsu_nic);
+    RSU* rsu = new RSU(rsu_nic, rsu_protocol, keys);
+    rsu->start();
+
+    EthernetNIC* nics[2];
+    EthernetProtocol* protocols[2];
+    SimulatedVehicle* vehicles[2];
+    for (int i = 0; i < 2; i++) {
+        nics[i] = new EthernetNIC("simulator-test-vehicle-" + std::to_string(i), 1);
+        protocols[i] = new EthernetProtocol(nics[i]);
+        vehicles[i] = new SimulatedVehicle(i, nics[i], protocols[i]);
+    }
+    // Ficam no quadrante da RSU
+    for (int i = 0; i < 2; i++) {
+        vehicles[i]->start();
+    }
+    Simulator::run_until(Simulator::start_us() + 900000);
+
+    Outcome outcome;
+    outcome.sent = vehicles[0]->sent() + vehicles[1]->sent();
+    outcome.received = vehicles[0]->received() + vehicles[1]->received();
+    outcome.clock = nics[0]->get_system_timestamp();
+    outcome.events = Simulator::events_run();
+
+    for (int i = 0; i < 2; i++) {
+        delete vehicles[i];
+        delete protocols[i];
+        delete nics[i];
+    }
+    rsu->stop();
+    delete rsu;
+    delete rsu_protocol;
+    delete rsu_nic;
+    MemoryBus::shared().channel(nullptr);
+    Simulator::stop();
+    NetworkEngine::use(NetworkEngine::RAW_SOCKET);
+    return outcome;
+}
+
+// A mesma semente dá o mesmo resultado, bit a bit
+bool test_reproducible() {
+    Outcome first = run_scenario(11);
+    Outcome second = run_scenario(11);
+    std::cout << "Enviadas " << first.sent << ", recebidas " << first.received << ", eventos " << first.events << std::endl;
+    return first.sent == 20 && first.received > 0 && first.sent == second.sent && first.received == second.received &&
+           first.clock == second.clock && first.events == second.events;
+}
+
+int main() {
+    int failures = 0;
+
+    std::cout << "Teste 1: Ordem dos eventos" << std::endl;
+    if (test_event_order()) {
+        std::cout << "Teste 1: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 1: FALHOU" << std::endl;
+        failures++;
+    }
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 2: Números aleatórios com semente" << std::endl;
+    if (test_random()) {
+        std::cout << "Teste 2: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 2: FALHOU" << std::endl;
+        failures++;
+    }
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 3: PeriodicThread simulada" << std::endl;
+    if (test_simulated_periodic()) {
+        std::cout << "Teste 3: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 3: FALHOU" << std::endl;
+        failures++;
+    }
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 4: Modelo de canal" << std::endl;
+    if (test_channel_model()) {
+        std::cout << "Teste 4: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 4: FALHOU" << std::endl;
+        failures++;
+    }
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 5: Cenário reproduzível" << std::endl;
+    if (test_reproducible()) {
+        std::cout << "Teste 5: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 5: FALHOU" << std::endl;
+        failures++;
+    }
+    std::cout << "----------------------------------------" << std::endl;
+
+    if (failures == 0) {
+        std::cout << "TODOS OS TESTES PASSARAM!" << std::endl;
+        return 0;
+    } else {
+        std::cout << failures << " TESTE(S) FALHARAM!" << std::endl;
+        return 1;
+    }
+}
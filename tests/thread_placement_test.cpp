@@ -0,0 +1,174 @@
+#include <iostream>
+#include <fstream>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <cstdio>
+
+#include "../header/thread_placement.h"
+#include "../header/period_thread.h"
+
+// Listas de CPUs no formato do kernel (cpulist)
+bool test_parse_cpus() {
+    cpu_set_t set;
+    bool restricted;
+
+    bool ok = ThreadPlacement::parse_cpus("0-3, 6", set, restricted) && restricted &&
+              ThreadPlacement::format_cpus(set) == "0-3,6" && CPU_COUNT(&set) == 5;
+    ok = ok && ThreadPlacement::parse_cpus("any", set, restricted) && !restricted;
+    ok = ok && ThreadPlacement::parse_cpus("", set, restricted) && !restricted;
+    ok = ok && !ThreadPlacement::parse_cpus("3-1", set, restricted);
+    ok = ok && !ThreadPlacement::parse_cpus("um", set, restricted);
+    ok = ok && !ThreadPlacement::parse_cpus("2,", set, restricted);
+    // Sem isolcpus= a máquina inteira serve
+    ok = ok && ThreadPlacement::parse_cpus("isolated", set, restricted);
+    return ok;
+}
+
+const char* CONFIG = "/tmp/thread_placement_test.conf";
+
+// Precedência do arquivo: agente > tipo de agente > todos > Traits
+bool test_configure() {
+    std::ofstream file(CONFIG);
+    file << "# teste\n"
+         << "receiver = 0\n"
+         << "periodic = 0\n"
+         << "rsu.periodic = any\n"
+         << "nic_worker = any\n"
+         << "rsu9.nic_worker = 0      # só este agente\n"
+         << "vehicle.logger = 0\n"
+         << "sender = 4096\n";
+    file.close();
+
+    ThreadPlacement::configure("rsu", 9, CONFIG);
+    bool ok = ThreadPlacement::cpus(ThreadPlacement::RECEIVER) == "0" &&
+              !ThreadPlacement::restricted(ThreadPlacement::PERIODIC) &&
+              ThreadPlacement::cpus(ThreadPlacement::NIC_WORKER) == "0" &&
+              !ThreadPlacement::restricted(ThreadPlacement::LOGGER) &&
+              !ThreadPlacement::restricted(ThreadPlacement::SENDER); // CPU inexistente é ignorada
+
+    ThreadPlacement::configure("vehicle", 2, CONFIG);
+    ok = ok && ThreadPlacement::restricted(ThreadPlacement::PERIODIC) &&
+         !ThreadPlacement::restricted(ThreadPlacement::NIC_WORKER) &&
+         ThreadPlacement::cpus(ThreadPlacement::LOGGER) == "0";
+
+    ThreadPlacement::report();
+    return ok;
+}
+
+// Só CPUs da afinidade do processo e online entram no plano, sejam quais forem os números
+bool test_allowed_cpus() {
+    cpu_set_t affinity;
+    if (sched_getaffinity(0, sizeof(affinity), &affinity) != 0) {
+        return false;
+    }
+    std::ofstream file(CONFIG);
+    file << "receiver = 0-" << CPU_SETSIZE - 1 << "\n";
+    file.close();
+
+    ThreadPlacement::configure("vehicle", 3, CONFIG);
+    std::string planned = ThreadPlacement::cpus(ThreadPlacement::RECEIVER);
+    std::cout << "  afinidade " << ThreadPlacement::format_cpus(affinity) << " -> plano " << planned << std::endl;
+    cpu_set_t set;
+    bool restricted;
+    bool ok = ThreadPlacement::parse_cpus(planned, set, restricted) && restricted;
+    // Nenhuma CPU fora da afinidade do processo
+    CPU_AND(&set, &set, &affinity);
+    return ok && ThreadPlacement::format_cpus(set) == planned;
+}
+
+// Threads colocadas antes do configure() seguem o plano novo
+bool test_placed_thread() {
+    std::atomic<bool> stop(false);
+    std::atomic<bool> placed(false);
+    cpu_set_t affinity;
+    std::thread worker([&]() {
+        ThreadPlacement::Guard placement(ThreadPlacement::SENDER, "teste");
+        placed.store(true);
+        while (!stop.load()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        pthread_getaffinity_np(pthread_self(), sizeof(affinity), &affinity);
+    });
+    while (!placed.load()) std::this_thread::yield();
+
+    std::ofstream file(CONFIG);
+    file << "sender = 0\n";
+    file.close();
+    ThreadPlacement::configure("vehicle", 3, CONFIG);
+
+    stop.store(true);
+    worker.join();
+    return CPU_COUNT(&affinity) == 1 && CPU_ISSET(0, &affinity);
+}
+
+// AUTO com papel fixado em CPUs vai direto para o temporizador
+bool test_periodic_role() {
+    std::atomic<int> runs(0);
+    PeriodicThread thread([&]() { runs++; }, 2000, 400, PeriodicThread::AUTO);
+    thread.set_role(ThreadPlacement::SENDER);
+    thread.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    thread.stop();
+    return thread.stats().mode == PeriodicThread::TIMER && runs.load() > 5;
+}
+
+int main() {
+    int failures = 0;
+
+    std::cout << "Iniciando testes para ThreadPlacement..." << std::endl;
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 1: Listas de CPUs" << std::endl;
+    if (test_parse_cpus()) {
+        std::cout << "Teste 1: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 1: FALHOU" << std::endl;
+        failures++;
+    }
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 2: Arquivo de configuração" << std::endl;
+    if (test_configure()) {
+        std::cout << "Teste 2: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 2: FALHOU" << std::endl;
+        failures++;
+    }
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 3: Thread já em execução" << std::endl;
+    if (test_placed_thread()) {
+        std::cout << "Teste 3: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 3: FALHOU" << std::endl;
+        failures++;
+    }
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 4: PeriodicThread com papel fixado" << std::endl;
+    if (test_periodic_role()) {
+        std::cout << "Teste 4: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 4: FALHOU" << std::endl;
+        failures++;
+    }
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 5: Somente CPUs permitidas" << std::endl;
+    if (test_allowed_cpus()) {
+        std::cout << "Teste 5: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 5: FALHOU" << std::endl;
+        failures++;
+    }
+    std::cout << "----------------------------------------" << std::endl;
+
+    remove(CONFIG);
+
+    if (failures == 0) {
+        std::cout << "TODOS OS TESTES PASSARAM!" << std::endl;
+        return 0;
+    } else {
+        std::cout << failures << " TESTE(S) FALHARAM!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,162 @@
+#include <iostream>
+#include <cmath>
+#include <vector>
+#include "../header/time_keeper.h"
+
+const U64 INTERVAL = 1000;
+const U64 PATH_DELAY = 30;
+
+// Beacons terminando "agora": envio exato no relógio da RSU, chegada local com atraso fixo
+// e um atraso extra de escalonamento só no carimbo de uma etapa
+struct BeaconFeed {
+    double offset_us;
+    double skew_ppm;
+    U64 start;
+
+    U64 rsu_time(U64 local) const {
+        return local + static_cast<U64>(std::llround(offset_us + skew_ppm * 1e-6 * static_cast<double>(local - start)));
+    }
+};
+
+// `late` > 0: o follow-up traz o envio de `late` beacons atrás, como numa RSU cujo carimbo atrasou
+void feed(TimeKeeper& keeper, const BeaconFeed& rsu, unsigned int count, bool two_step, unsigned int lost = 0, unsigned int late = 1) {
+    std::vector<U64> sent;
+    for (unsigned int sequence = 0; sequence < count; sequence++) {
+        U64 local_tx = rsu.start + sequence * INTERVAL;
+        U64 tx = rsu.rsu_time(local_tx);
+        // O carimbo de uma etapa é tirado antes do envio e varia com o escalonamento
+        U64 origin = tx - (sequence % 7) * 5;
+        U64 follow_up = two_step && sequence >= late ? sent[sequence - late] : 0;
+        if (lost == 0 || sequence % lost != 0) {
+            keeper.update_sync_beacon(sequence, origin, follow_up, sequence - late, local_tx + PATH_DELAY);
+        }
+        sent.push_back(tx);
+    }
+}
+
+// Duas etapas: o follow-up é pareado com a chegada do beacon anterior
+bool test_two_step() {
+    TimeKeeper keeper;
+    BeaconFeed rsu = {1500.0, 0.0, keeper.get_local_timestamp() - 200 * INTERVAL};
+    feed(keeper, rsu, 200, true);
+
+    TimeKeeper::SyncQuality quality = keeper.get_sync_quality();
+    return std::fabs(quality.offset_us - (rsu.offset_us - PATH_DELAY)) < 1 && quality.rejected == 0 &&
+           keeper.get_sync_state() == TimeKeeper::SyncState::SYNCHRONIZED;
+}
+
+// Beacons perdidos custam uma amostra, sem parear chegadas erradas
+bool test_lost_beacons() {
+    TimeKeeper keeper;
+    BeaconFeed rsu = {-700.0, 0.0, keeper.get_local_timestamp() - 200 * INTERVAL};
+    feed(keeper, rsu, 200, true, 3);
+
+    TimeKeeper::SyncQuality quality = keeper.get_sync_quality();
+    return std::fabs(quality.offset_us - (rsu.offset_us - PATH_DELAY)) < 1 && quality.rejected == 0;
+}
+
+// Follow-up de um beacon que não é a última chegada guardada: descartado, nunca pareado
+bool test_stale_follow_up() {
+    TimeKeeper keeper;
+    BeaconFeed rsu = {900.0, 0.0, keeper.get_local_timestamp() - 200 * INTERVAL};
+    feed(keeper, rsu, 200, true, 0, 2);
+
+    // Só os dois primeiros, sem follow-up, viram amostras de uma etapa
+    TimeKeeper::SyncQuality quality = keeper.get_sync_quality();
+    return quality.accepted == 2 && quality.rejected == 0;
+}
+
+// Sem carimbos de envio do kernel a RSU manda follow-up 0 e vale o carimbo de uma etapa
+bool test_one_step() {
+    TimeKeeper keeper;
+    BeaconFeed rsu = {300.0, 0.0, keeper.get_local_timestamp() - 200 * INTERVAL};
+    feed(keeper, rsu, 200, false);
+
+    TimeKeeper::SyncQuality quality = keeper.get_sync_quality();
+    return quality.accepted > 0 && std::fabs(quality.offset_us - (rsu.offset_us - PATH_DELAY)) < 30;
+}
+
+// O intervalo pedido segue a deriva estimada
+bool test_wanted_interval() {
+    TimeKeeper idle;
+    if (idle.wanted_beacon_interval() != Traits<TimeKeeper>::BEACON_MIN_US) return false;
+
+    TimeKeeper slow;
+    BeaconFeed stable = {0.0, 2.0, slow.get_local_timestamp() - 200 * INTERVAL};
+    feed(slow, stable, 200, true);
+    uint32_t slow_interval = slow.wanted_beacon_interval();
+
+    TimeKeeper fast;
+    BeaconFeed drifting = {0.0, 500.0, fast.get_local_timestamp() - 200 * INTERVAL};
+    feed(fast, drifting, 200, true);
+    uint32_t fast_interval = fast.wanted_beacon_interval();
+
+    std::cout << "  intervalo pedido: 2 ppm -> " << slow_interval << " us | 500 ppm -> " << fast_interval << " us" << std::endl;
+    return slow_interval == Traits<TimeKeeper>::BEACON_MAX_US && fast_interval < slow_interval && fast_interval >= Traits<TimeKeeper>::BEACON_MIN_US;
+}
+
+int main() {
+    int failures = 0;
+
+    std::cout << "Iniciando testes para TimeKeeper..." << std::endl;
+
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 1: Beacon em duas etapas" << std::endl;
+    if (test_two_step()) {
+        std::cout << "Teste 1: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 1: FALHOU" << std::endl;
+        failures ++;
+    }
+
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 2: Beacons perdidos" << std::endl;
+    if (test_lost_beacons()) {
+        std::cout << "Teste 2: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 2: FALHOU" << std::endl;
+        failures ++;
+    }
+
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 3: Beacon em uma etapa" << std::endl;
+    if (test_one_step()) {
+        std::cout << "Teste 3: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 3: FALHOU" << std::endl;
+        failures ++;
+    }
+
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 4: Intervalo adaptado à deriva" << std::endl;
+    if (test_wanted_interval()) {
+        std::cout << "Teste 4: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 4: FALHOU" << std::endl;
+        failures ++;
+    }
+
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 5: Follow-up de outro beacon" << std::endl;
+    if (test_stale_follow_up()) {
+        std::cout << "Teste 5: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 5: FALHOU" << std::endl;
+        failures ++;
+    }
+
+    std::cout << "----------------------------------------" << std::endl;
+
+    if (failures == 0) {
+        std::cout << "TODOS OS TESTES PASSARAM!" << std::endl;
+        return 0;
+    } else {
+        std::cout << failures << " TESTE(S) FALHARAM!" << std::endl;
+        return 1;
+    }
+}
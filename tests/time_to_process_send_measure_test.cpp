@@ -16,11 +16,10 @@ int main() {
     int correct_packets = 0;
 
     EthernetNIC* nic = new EthernetNIC(id, 1);
-    EthernetProtocol* protocol = EthernetProtocol::get_instance();
-    protocol->register_nic(nic);
+    EthernetProtocol* protocol = new EthernetProtocol(nic);
 
     EthernetProtocol::Address addr(nic->address(), 1);
-    EthernetCommunicator* comm = new EthernetCommunicator(EthernetProtocol::get_instance(), addr);
+    EthernetCommunicator* comm = new EthernetCommunicator(protocol, addr);
     std::vector<std::pair<std::chrono::high_resolution_clock::time_point,
                           std::chrono::high_resolution_clock::time_point>> timestamps;
                           
@@ -0,0 +1,133 @@
+#include <iostream>
+#include <cassert>
+#include <cstring>
+#include "../header/vehicle_table.h"
+
+void address_of(unsigned int n, Ethernet::Address& address) {
+    // Mesmo prefixo de fabricante para todos, como em uma frota real
+    unsigned char base[ETH_ALEN] = {0x02, 0x00, 0x5e, 0, 0, 0};
+    memcpy(address, base, ETH_ALEN);
+    address[3] = static_cast<unsigned char>(n >> 16);
+    address[4] = static_cast<unsigned char>(n >> 8);
+    address[5] = static_cast<unsigned char>(n);
+}
+
+// Inserção, consulta e atualização do último contato
+bool test_check_and_set() {
+    VehicleTable* table = new VehicleTable();
+    Ethernet::Address a, b;
+    address_of(1, a);
+    address_of(2, b);
+
+    bool ok = !table->check_vehicle(&a, 0);
+    table->set_vehicle(&a, 0);
+    ok = ok && table->check_vehicle(&a, 1000);
+    ok = ok && !table->check_vehicle(&b, 1000);
+    ok = ok && table->size(1000) == 1;
+
+    // A consulta renova o último contato
+    ok = ok && table->check_vehicle(&a, VehicleTable::TTL_US - 1);
+    ok = ok && table->check_vehicle(&a, VehicleTable::TTL_US + 1000);
+
+    delete table;
+    return ok;
+}
+
+// Veículos que saíram expiram sem remoção explícita e liberam o espaço
+bool test_lazy_expiry() {
+    VehicleTable* table = new VehicleTable();
+    Ethernet::Address address;
+    bool ok = true;
+
+    for (unsigned int i = 0; i < 3000; i++) {
+        address_of(i, address);
+        table->set_vehicle(&address, 0);
+    }
+    ok = ok && table->size(0) == 3000;
+
+    U64 later = VehicleTable::TTL_US;
+    address_of(0, address);
+    ok = ok && !table->check_vehicle(&address, later);
+    ok = ok && table->size(later) == 0;
+
+    // Uma nova leva reaproveita os slots expirados sem despejar ninguém vivo
+    for (unsigned int i = 3000; i < 6000; i++) {
+        address_of(i, address);
+        table->set_vehicle(&address, later);
+    }
+    for (unsigned int i = 3000; i < 6000 && ok; i++) {
+        address_of(i, address);
+        ok = table->check_vehicle(&address, later + 1);
+    }
+    ok = ok && table->size(later + 1) == 3000 && table->evictions() == 0;
+
+    delete table;
+    return ok;
+}
+
+// Com a tabela cheia de veículos vivos o mais antigo é despejado
+bool test_bounded_memory() {
+    VehicleTable* table = new VehicleTable();
+    Ethernet::Address address;
+
+    for (unsigned int i = 0; i < 2 * VehicleTable::CAPACITY; i++) {
+        address_of(i, address);
+        table->set_vehicle(&address, i);
+    }
+
+    bool ok = table->size(2 * VehicleTable::CAPACITY) <= VehicleTable::CAPACITY;
+    ok = ok && table->evictions() >= VehicleTable::CAPACITY;
+
+    // O último inserido sempre pode ser encontrado
+    address_of(2 * VehicleTable::CAPACITY - 1, address);
+    ok = ok && table->check_vehicle(&address, 2 * VehicleTable::CAPACITY);
+
+    delete table;
+    return ok;
+}
+
+int main() {
+    int failures = 0;
+
+    std::cout << "Iniciando testes para VehicleTable..." << std::endl;
+
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 1: Consulta e inserção" << std::endl;
+    if (test_check_and_set()) {
+        std::cout << "Teste 1: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 1: FALHOU" << std::endl;
+        failures ++;
+    }
+
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 2: Expiração preguiçosa" << std::endl;
+    if (test_lazy_expiry()) {
+        std::cout << "Teste 2: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 2: FALHOU" << std::endl;
+        failures ++;
+    }
+
+    std::cout << "----------------------------------------" << std::endl;
+
+    std::cout << "Teste 3: Memória limitada" << std::endl;
+    if (test_bounded_memory()) {
+        std::cout << "Teste 3: PASSOU" << std::endl;
+    } else {
+        std::cout << "Teste 3: FALHOU" << std::endl;
+        failures ++;
+    }
+
+    std::cout << "----------------------------------------" << std::endl;
+
+    if (failures == 0) {
+        std::cout << "TODOS OS TESTES PASSARAM!" << std::endl;
+        return 0;
+    } else {
+        std::cout << failures << " TESTE(S) FALHARAM!" << std::endl;
+        return 1;
+    }
+}
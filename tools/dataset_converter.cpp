@@ -0,0 +1,48 @@
+// Converts dataset CSVs into the columnar binary form read by Dataset.
+// Usage: bin/dataset_converter dataset/perception-vehicle_<id>.csv [...]
+// Each <name>.csv is written as <name>.bin next to it.
+
+#include <chrono>
+#include <string>
+#include <iostream>
+
+#include "../header/dataset.h"
+
+static int convert(const std::string& csv_path) {
+    std::string binary_path = csv_path;
+    size_t dot = binary_path.rfind(".csv");
+    if (dot == std::string::npos || dot + 4 != binary_path.size()) {
+        std::cerr << csv_path << ": not a .csv file" << std::endl;
+        return 1;
+    }
+    binary_path.replace(dot, 4, ".bin");
+
+    auto start = std::chrono::steady_clock::now();
+    if (!Dataset::convert(csv_path, binary_path)) {
+        std::cerr << csv_path << ": conversion failed (see the log)" << std::endl;
+        return 1;
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    Dataset dataset;
+    if (!dataset.open(binary_path)) {
+        std::cerr << binary_path << ": cannot be read back" << std::endl;
+        return 1;
+    }
+    std::cout << binary_path << ": " << dataset.rows() << " rows, " << dataset.columns() << " columns, "
+              << elapsed.count() << " ms" << std::endl;
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <file.csv> [...]" << std::endl;
+        return 1;
+    }
+
+    int result = 0;
+    for (int i = 1; i < argc; i++) {
+        result |= convert(argv[i]);
+    }
+    return result;
+}
@@ -0,0 +1,113 @@
+// Offline decoder for the binary logs written by AsyncLogger.
+// Usage: bin/log_decoder logs/process_<pid>.blog [...]
+
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <unordered_map>
+
+#include "../header/async_logger.h"
+
+struct FormatEntry {
+    AsyncLogger::Level level;
+    std::string file;
+    int line;
+    std::string text;
+};
+
+template<typename T>
+static bool read_value(std::ifstream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+static bool read_string(std::ifstream& in, std::string& value) {
+    uint16_t length;
+    if (!read_value(in, length)) return false;
+    value.resize(length);
+    return length == 0 || static_cast<bool>(in.read(&value[0], length));
+}
+
+static std::string format_timestamp(U64 timestamp) {
+    time_t seconds = timestamp / 1000000;
+    struct tm tm;
+    localtime_r(&seconds, &tm);
+
+    std::stringstream ss;
+    ss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S")
+       << '.' << std::setfill('0') << std::setw(3) << (timestamp / 1000) % 1000;
+    return ss.str();
+}
+
+static int decode(const char* path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        std::cerr << "Cannot open " << path << std::endl;
+        return 1;
+    }
+
+    char magic[sizeof(AsyncLogger::MAGIC)];
+    uint32_t pid;
+    if (!in.read(magic, sizeof(magic)) || memcmp(magic, AsyncLogger::MAGIC, sizeof(magic)) != 0 || !read_value(in, pid)) {
+        std::cerr << path << ": not an AsyncLogger file" << std::endl;
+        return 1;
+    }
+
+    std::unordered_map<uint16_t, FormatEntry> formats;
+    unsigned char tag;
+
+    while (read_value(in, tag)) {
+        if (tag == AsyncLogger::FORMAT_ENTRY) {
+            uint16_t id;
+            uint8_t level;
+            uint16_t line;
+            FormatEntry entry;
+            if (!read_value(in, id) || !read_value(in, level) || !read_value(in, line) ||
+                !read_string(in, entry.file) || !read_string(in, entry.text)) break;
+            entry.level = static_cast<AsyncLogger::Level>(level);
+            entry.line = line;
+            formats[id] = entry;
+        } else if (tag == AsyncLogger::RECORD_ENTRY) {
+            AsyncLogger::Record record;
+            if (!in.read(reinterpret_cast<char*>(&record), AsyncLogger::RECORD_HEADER_SIZE)) break;
+            if (record.size > AsyncLogger::MAX_ARGS_SIZE || !in.read(reinterpret_cast<char*>(record.args), record.size)) break;
+
+            auto it = formats.find(record.format);
+            if (it == formats.end()) {
+                std::cerr << path << ": record with unknown format " << record.format << std::endl;
+                continue;
+            }
+
+            std::cout << "[" << format_timestamp(record.timestamp) << "] - [PID:" << pid << "] [THREAD ID:" << record.thread << "] ["
+                      << AsyncLogger::level_name(it->second.level) << "] "
+                      << AsyncLogger::render(it->second.text.c_str(), record.args, record.argc, record.size) << std::endl;
+        } else if (tag == AsyncLogger::DROPPED_ENTRY) {
+            uint64_t dropped;
+            if (!read_value(in, dropped)) break;
+            std::cout << "[PID:" << pid << "] " << dropped << " record(s) dropped so far (ring full)" << std::endl;
+        } else {
+            std::cerr << path << ": corrupted entry" << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <file.blog> [...]" << std::endl;
+        return 1;
+    }
+
+    int result = 0;
+    for (int i = 1; i < argc; i++) {
+        result |= decode(argv[i]);
+    }
+    return result;
+}